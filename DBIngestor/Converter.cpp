@@ -19,24 +19,21 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "dbingestor_error.h"
 #include <assert.h>
 #include "Converter.h"
+#include "RowContext.h"
+#include "StringArena.h"
 
 using namespace DBConverter;
 using namespace std;
 
-#define CONV_RESULT_BUFFER_SIZE 128
-
 Converter::Converter() {
-    result = NULL;
+    contextId = -1;
 }
 
 Converter::~Converter() {
-    if(result != NULL) {
-        free(result);
-    }
-
     //deallocate function parameter array
     for(int i=0; i<functionParamArray.size(); i++) {
         free(functionParamArray.at(i).validTypeArray);
@@ -93,24 +90,9 @@ void Converter::setFunctionParameters(convFunctionParam * paramArray, int size)
         functionParamArray.push_back(currParam);
     }
     
-    //deallocate already allocated memory if needed
-    if(functionValues.size() > 0) {
-        for(int i=0; i<functionValues.size(); i++) {
-            free(functionValues.at(i));
-        }
-    }
-    
-    //allocate memory for holding the function values
+    //the buffers for the function values are held by the RowContext
     currFuncInstanceDTypes.resize(size);
-    functionValues.resize(size);
     dataObjArray.resize(size);
-    
-    for(int i=0; i<size; i++) {
-        functionValues.at(i) = (void*)malloc(sizeof(char)*CONV_RESULT_BUFFER_SIZE);
-        if(functionValues.at(i) == NULL) {
-            DBIngestor_error("Allocation of converter variable buffer failed!\n");
-        }
-    }
 }
 
 int Converter::registerInternalParameter(int parNum, DBDataSchema::DType parType) {
@@ -153,131 +135,70 @@ unsigned long Converter::getNumParameters() {
     return functionParamArray.size();
 }
 
-int Converter::setParameter(int parNum, void* value) {
-	assert(parNum < functionValues.size());
-    assert(value != NULL);
-    
-    functionValues.at(parNum) = value;
-    
-    return 1;
-}
-
-void* Converter::getParameter(int parNum) {
-    assert(parNum < functionValues.size());
-    
-    return functionValues.at(parNum);
-}
-
-int Converter::setResult(DBDataSchema::DType thisDType, void* value) {
+int Converter::setResult(DBDataSchema::RowContext * rowContext, DBDataSchema::DType thisDType, void* value) {
+    assert(rowContext != NULL);
     assert(value != NULL);
 
-    if(result != NULL) {
-        free(result);
-    }
+    //the buffer is allocated once with the row context and reused for every row
+    void * result = rowContext->getConverterResultBuffer(this);
 
-    switch (thisDType) {
-        case DBDataSchema::DT_STRING:
-            result = malloc(strlen(*(char**)value) + 1);
-            strcpy(*(char**)result, *(char**)value);
-            break;
-        case DBDataSchema::DT_INT1:
-            result = malloc(sizeof(int8_t));
-            *(int8_t*)result = *(int8_t*)value;
-            break;
-        case DBDataSchema::DT_INT2:
-            result = malloc(sizeof(int16_t));
-            *(int16_t*)result = *(int16_t*)value;
-            break;
-        case DBDataSchema::DT_INT4:
-            result = malloc(sizeof(int32_t));
-            *(int32_t*)result = *(int32_t*)value;
-            break;
-        case DBDataSchema::DT_INT8:
-            result = malloc(sizeof(int64_t));
-            *(int64_t*)result = *(int64_t*)value;
-            break;
-        case DBDataSchema::DT_UINT1:
-            result = malloc(sizeof(int8_t));
-            *(int8_t*)result = *(int8_t*)value;
-            break;
-        case DBDataSchema::DT_UINT2:
-            result = malloc(sizeof(int16_t));
-            *(int16_t*)result = *(int16_t*)value;
-            break;
-        case DBDataSchema::DT_UINT4:
-            result = malloc(sizeof(int32_t));
-            *(int32_t*)result = *(int32_t*)value;
-            break;
-        case DBDataSchema::DT_UINT8:
-            result = malloc(sizeof(int64_t));
-            *(int64_t*)result = *(int64_t*)value;
-            break;
-        case DBDataSchema::DT_REAL4:
-            result = malloc(sizeof(float));
-            *(float*)result = *(float*)value;
-            break;
-        case DBDataSchema::DT_REAL8:
-            result = malloc(sizeof(double));
-            *(double*)result = *(double*)value;
-            break;
-        default:
+    if(thisDType == DBDataSchema::DT_STRING) {
+        //the saved string only needs to live as long as the row, like the strings read from the row
+        char * thisString = *(char**)value;
+        if(thisString != NULL) {
+            thisString = rowContext->getStringArena()->copyString(thisString, strlen(thisString));
+        }
+        memcpy(result, &thisString, sizeof(char*));
+    } else {
+        int byteLen = DBDataSchema::getByteLenOfDType(thisDType);
+        if(byteLen <= 0) {
             DBIngestor_error("Converter Error: Cannot save the result due to unknown format type\n", NULL);
-            break;
-    }    
+        }
+        memcpy(result, value, byteLen);
+    }
+    
+    rowContext->setConverterResultSaved(this);
     
     return 1;
 }
 
-int Converter::getResult(DBDataSchema::DType thisDType, void* value) {
+int Converter::getResult(DBDataSchema::RowContext * rowContext, DBDataSchema::DType thisDType, void* value) {
+    assert(rowContext != NULL);
     assert(value != NULL);
 
-    if(result == NULL) {
+    if(rowContext->getConverterResultSaved(this) == false) {
         return 0;
     }
 
-    switch (thisDType) {
-        case DBDataSchema::DT_STRING:
-            value = malloc(strlen(*(char**)result) + 1);
-            strcpy(*(char**)value, *(char**)result);
-            break;
-        case DBDataSchema::DT_INT1:
-            *(int8_t*)value = *(int8_t*)result;
-            break;
-        case DBDataSchema::DT_INT2:
-            *(int16_t*)value = *(int16_t*)result;
-            break;
-        case DBDataSchema::DT_INT4:
-            *(int32_t*)value = *(int32_t*)result;
-            break;
-        case DBDataSchema::DT_INT8:
-            *(int64_t*)value = *(int64_t*)result;
-            break;
-        case DBDataSchema::DT_UINT1:
-            *(int8_t*)value = *(int8_t*)result;
-            break;
-        case DBDataSchema::DT_UINT2:
-            *(int16_t*)value = *(int16_t*)result;
-            break;
-        case DBDataSchema::DT_UINT4:
-            *(int32_t*)value = *(int32_t*)result;
-            break;
-        case DBDataSchema::DT_UINT8:
-            *(int64_t*)value = *(int64_t*)result;
-            break;
-        case DBDataSchema::DT_REAL4:
-            *(float*)value = *(float*)result;
-            break;
-        case DBDataSchema::DT_REAL8:
-            *(double*)value = *(double*)result;
-            break;
-        default:
+    void * result = rowContext->getConverterResultBuffer(this);
+
+    if(thisDType == DBDataSchema::DT_STRING) {
+        //hand out a copy of its own, it is released with the row (see RowContext::releaseString)
+        char * thisString;
+        memcpy(&thisString, result, sizeof(char*));
+        if(thisString != NULL) {
+            thisString = rowContext->getStringArena()->copyString(thisString, strlen(thisString));
+        }
+        memcpy(value, &thisString, sizeof(char*));
+    } else {
+        int byteLen = DBDataSchema::getByteLenOfDType(thisDType);
+        if(byteLen <= 0) {
             DBIngestor_error("Converter Error: Cannot return the result due to unknown format type\n", NULL);
-            break;
-    }    
+        }
+        memcpy(value, result, byteLen);
+    }
 
     return 1;
 }
 
-bool Converter::execute(DBDataSchema::DType thisDType, void* value) {
+bool Converter::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
 	throw "Not yet implemented";
 }
+
+int Converter::getContextId() {
+    return contextId;
+}
+
+void Converter::setContextId(int newContextId) {
+    contextId = newContextId;
+}
@@ -33,9 +33,13 @@
 #include "DType.h"
 #include "DataObjDesc.h"
 
+//size of the buffers holding converter parameters and results
+#define CONV_RESULT_BUFFER_SIZE 128
+
 //guarding against circular inclusion here (needed and I can see no other design possibility...)
 namespace DBDataSchema {
     class DataObjDesc;
+    class RowContext;
 }
 
 namespace DBConverter {
@@ -73,10 +77,10 @@ namespace DBConverter {
          */
         std::vector<DBDataSchema::DataObjDesc*> dataObjArray;
 
-        /*! \var void * result
-         holds the result of the evaluation to be returned on second evaluation per row
+        /*! \var int contextId
+         index of this converter in the RowContext, assigned by Schema::compile. -1 if not compiled
          */
-        void * result;
+        int contextId;
 
         /*! \brief registers the type of parNum-th parameter for a specific instance of this converter
          \param int parNum: the number of the parameter to set
@@ -100,11 +104,6 @@ namespace DBConverter {
          */
         std::vector<DBDataSchema::DType> currFuncInstanceDTypes;
 
-        /*! \var vector<void*> functionValues
-         holds the specific void pointers to the values needed for this converter
-         */
-        std::vector<void*> functionValues;
-
 	public:
         Converter();
         
@@ -137,39 +136,24 @@ namespace DBConverter {
          Retrieves the DataObjDesc at position parNum of all the registered objects..*/
 		DBDataSchema::DataObjDesc * getParameterDatObj(int parNum);
 
-        /*! \brief if the specific implementation supports parameters, this function sets the specified parameter
-         \param int parNum: the number of the parameter to set
-         \param void* value: value to set
-         \return 1 if ok, 0 if not
-         
-         Sets the parNum-th parameter as defined by the implementor, with a specified value. This needs to be
-         implemented by the converter implementer.*/
-		int setParameter(int parNum, void* value);
-	
-        /*! \brief if the specific implementation supports parameters, this function returns the specified parameter
-         \param int parNum: the number of the parameter to set
-         \return a void pointer to the parameter variable.
-         
-         Sets the parNum-th parameter as defined by the implementor, with a specified value. This needs to be
-         implemented by the converter implementer.*/
-		void* getParameter(int parNum);
-	
         /*! \brief sets the result value of this converter
+         \param DBDataSchema::RowContext * rowContext: the row context the result is saved in
          \param DBDataSchema::DType thisDType: dtype of the result value
          \param void* value: value to set
          \return 1 if ok, 0 if not
          
          Sets the result value of this converter. This can be used to only evaluate a conversion once per row
          and saves the output.*/
-        int setResult(DBDataSchema::DType thisDType, void* value);
+        int setResult(DBDataSchema::RowContext * rowContext, DBDataSchema::DType thisDType, void* value);
     
         /*! \brief gets the result value of this converter
+         \param DBDataSchema::RowContext * rowContext: the row context the result has been saved in
          \param DBDataSchema::DType thisDType: dtype of the result value
          \param void* value: pointer to where the result will get written into
          \return 1 if ok, 0 if not
          
          Copies the result into the address given by value.*/
-        int getResult(DBDataSchema::DType thisDType, void* value);
+        int getResult(DBDataSchema::RowContext * rowContext, DBDataSchema::DType thisDType, void* value);
 
         /*! \brief retrieves the number of parameters this converter has
          \return number of parameters in this converter
@@ -180,10 +164,16 @@ namespace DBConverter {
         /*! \brief executes the conversion for a specific data object and value
          \param DBDataSchema::DType thisDType: dtype to execute this convertion for
          \param void* value: pointer to the value that needs to be converted
+         \param void** functionValues: the values of the parameters in the current row (types are given by currFuncInstanceDTypes)
          \return 1 if convertion was successfull, 0 if convertion is not successfull, -1 if this returns NULL
          
-         Runs the converter on the specified value. Alters the value passed to the function and returns 1 on success.*/
-		virtual bool execute(DBDataSchema::DType thisDType, void* value) = 0;
+         Runs the converter on the specified value. Alters the value passed to the function and returns 1 on success.
+         The converter itself is shared between threads, so this must not change the state of the object.*/
+		virtual bool execute(DBDataSchema::DType thisDType, void* value, void** functionValues) = 0;
+
+        int getContextId();
+
+        void setContextId(int newContextId);
 
         virtual std::string getName();
     };
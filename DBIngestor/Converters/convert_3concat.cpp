@@ -50,7 +50,7 @@ Converter * convert_3concat::clone() {
     return new convert_3concat;
 }
 
-bool convert_3concat::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_3concat::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
 
 	//apply add to the value
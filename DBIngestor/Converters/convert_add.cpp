@@ -47,7 +47,7 @@ Converter * convert_add::clone() {
     return new convert_add;
 }
 
-bool convert_add::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_add::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
 	//apply add to the value
@@ -50,7 +50,7 @@ Converter * convert_concat::clone() {
     return new convert_concat;
 }
 
-bool convert_concat::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_concat::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
 
 	//apply add to the value
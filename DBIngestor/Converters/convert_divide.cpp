@@ -47,7 +47,7 @@ Converter * convert_divide::clone() {
     return new convert_divide;
 }
 
-bool convert_divide::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_divide::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
 	//apply divide to the value
@@ -43,7 +43,7 @@ Converter * convert_floor::clone() {
     return new convert_floor;
 }
 
-bool convert_floor::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_floor::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
 	//apply floor to the value
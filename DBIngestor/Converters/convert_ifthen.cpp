@@ -47,7 +47,7 @@ Converter * convert_ifthen::clone() {
     return new convert_ifthen;
 }
 
-bool convert_ifthen::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_ifthen::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
 	//apply ifthenelse to the value
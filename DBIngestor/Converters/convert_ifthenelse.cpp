@@ -47,7 +47,7 @@ Converter * convert_ifthenelse::clone() {
     return new convert_ifthenelse;
 }
 
-bool convert_ifthenelse::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_ifthenelse::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
 	//apply ifthenelse to the value
@@ -49,7 +49,7 @@ Converter * convert_iseq::clone() {
     return new convert_iseq;
 }
 
-bool convert_iseq::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_iseq::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
 	//apply iseq to the value
@@ -47,7 +47,7 @@ Converter * convert_isge::clone() {
     return new convert_isge;
 }
 
-bool convert_isge::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_isge::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
 	//apply isge to the value
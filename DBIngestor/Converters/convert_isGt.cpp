@@ -47,7 +47,7 @@ Converter * convert_isgt::clone() {
     return new convert_isgt;
 }
 
-bool convert_isgt::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_isgt::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
 	//apply isgt to the value
@@ -47,7 +47,7 @@ Converter * convert_isle::clone() {
     return new convert_isle;
 }
 
-bool convert_isle::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_isle::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
 	//apply isle to the value
@@ -47,7 +47,7 @@ Converter * convert_islt::clone() {
     return new convert_islt;
 }
 
-bool convert_islt::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_islt::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
 	//apply islt to the value
@@ -49,7 +49,7 @@ Converter * convert_isne::clone() {
     return new convert_isne;
 }
 
-bool convert_isne::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_isne::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
 	//apply isne to the value
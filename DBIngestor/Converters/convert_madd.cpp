@@ -47,7 +47,7 @@ Converter * convert_madd::clone() {
     return new convert_madd;
 }
 
-bool convert_madd::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_madd::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
 	//apply add to the value
@@ -47,7 +47,7 @@ Converter * convert_multiply::clone() {
     return new convert_multiply;
 }
 
-bool convert_multiply::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_multiply::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
 	//apply multiply to the value
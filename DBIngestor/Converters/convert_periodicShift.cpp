@@ -58,7 +58,7 @@ Converter * convert_periodicshift::clone() {
     return new convert_periodicshift;
 }
 
-bool convert_periodicshift::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_periodicshift::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
     // use box as double value
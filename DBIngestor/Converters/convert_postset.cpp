@@ -54,7 +54,7 @@ Converter * convert_postset::clone() {
     return new convert_postset;
 }
 
-bool convert_postset::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_postset::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
 
     assert(value != NULL);
     
@@ -59,7 +59,7 @@ namespace DBConverter {
          
          Runs the convertion on the specified value. Returns 1 if the convertion is passen, 0 if not. This needs to be
          implemented by the convertion implementer.*/
-		bool execute(DBDataSchema::DType thisDType, void* value);
+		bool execute(DBDataSchema::DType thisDType, void* value, void** functionValues);
     };
 }
 
@@ -51,7 +51,7 @@ Converter * convert_power::clone() {
     return new convert_power;
 }
 
-bool convert_power::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_power::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
     double exp = castToDouble(currFuncInstanceDTypes[0], functionValues[0]);   
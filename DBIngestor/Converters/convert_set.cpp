@@ -49,7 +49,7 @@ Converter * convert_set::clone() {
     return new convert_set;
 }
 
-bool convert_set::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_set::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
 
     assert(value != NULL);
     
@@ -46,7 +46,7 @@ Converter * convert_sqrt::clone() {
 }
 
 //TODO: maybe return error/warning, if an argument to CONV_SQRT is given?? (at the moment, it is just ignored)
-bool convert_sqrt::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_sqrt::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
 
     assert(value != NULL);
     
@@ -47,7 +47,7 @@ Converter * convert_subtract::clone() {
     return new convert_subtract;
 }
 
-bool convert_subtract::execute(DBDataSchema::DType thisDType, void* value) {
+bool convert_subtract::execute(DBDataSchema::DType thisDType, void* value, void** functionValues) {
     assert(value != NULL);
     
 	//apply subtract to the value
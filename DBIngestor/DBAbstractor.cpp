@@ -18,11 +18,17 @@
  */
 
 #include "DBAbstractor.h"
+#include "dbingestor_error.h"
+#include <assert.h>
 
 using namespace DBServer;
 
 DBAbstractor::DBAbstractor() {
 	supportsSchemaRetrieval = true;
+    supportsColumnBinding = false;
+    supportsConcurrentWriters = true;
+    keepsKeysDisabledOnCommit = true;
+    executesAsync = false;
     isConnected = false;
     resumeMode = false;
 }
@@ -31,6 +37,10 @@ DBAbstractor::~DBAbstractor() {
     
 }
 
+DBAbstractor * DBAbstractor::createLike() {
+    return NULL;
+}
+
 bool DBAbstractor::getIsConnected() {
     return isConnected;
 }
@@ -43,6 +53,22 @@ bool DBAbstractor::getSupportsSchemaRetrieval() {
 	return supportsSchemaRetrieval;
 }
 
+bool DBAbstractor::getSupportsColumnBinding() {
+	return supportsColumnBinding;
+}
+
+bool DBAbstractor::getSupportsConcurrentWriters() {
+    return supportsConcurrentWriters;
+}
+
+bool DBAbstractor::getKeepsKeysDisabledOnCommit() {
+    return keepsKeysDisabledOnCommit;
+}
+
+bool DBAbstractor::getExecutesAsync() {
+    return executesAsync;
+}
+
 void DBAbstractor::setResumeMode(bool newResumeMode) {
 	resumeMode = newResumeMode;
 }
@@ -54,4 +80,30 @@ void * DBAbstractor::initGetCompleteTable(DBDataSchema::Schema * thisSchema) {
 
 int DBAbstractor::getNextRow(DBDataSchema::Schema * thisSchema, void* thisData, void * preparedStatement) {
     throw "Not yet implemented";
-}
\ No newline at end of file
+}
+
+int DBAbstractor::bindBatch(const RowBatch & thisBatch, void* preparedStatement) {
+    for(int i=0; i<thisBatch.numRows; i++) {
+        if(bindOneRowToStmt(thisBatch.schema, (void*)thisBatch.getRow(i), thisBatch.getIsNullRow(i), preparedStatement, i) != 1) {
+            return 0;
+        }
+    }
+    
+    return 1;
+}
+
+int DBAbstractor::executeStmtAsync(void* preparedStatement) {
+    return executeStmt(preparedStatement);
+}
+
+int DBAbstractor::waitStmt() {
+    return 1;
+}
+
+int DBAbstractor::bindColumnsToStmt(DBDataSchema::Schema * thisSchema, void** columnData, bool** isNullColumns, void* preparedStatement, int numRows) {
+    //columns are only handed to adaptors that set supportsColumnBinding, which need to override this
+    assert(supportsColumnBinding == true);
+    
+    DBIngestor_error("DBAbstractor - bindColumnsToStmt: the DB adaptor does not bind whole columns, it needs to set supportsColumnBinding and implement bindColumnsToStmt.\n", NULL);
+    return 0;
+}
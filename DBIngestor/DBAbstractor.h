@@ -28,11 +28,75 @@
 
 #include <string>
 #include "Schema.h"
+#ifndef _WIN32
+#include <stdint.h>
+#else
+#include "stdint_win.h"
+#endif
 
 #ifndef DBIngestor_DBAbstractor_h
 #define DBIngestor_DBAbstractor_h
 
 namespace DBServer {
+
+    /*! \struct RowBatch
+     \brief a block of buffered rows that is bound to a prepared statement at once
+     
+     The rows are stored one after the other, rowSize bytes apart, each laid out according to the row plan of the
+     Schema (i.e. the value of column i is at offset rowPlan[i].offset, strings as char* copied by StringArena::copyString,
+     which keeps their length, see StringArena::getStringLength). The memory of the batch
+     stays valid until the statement it is bound to has been executed.
+     */
+    typedef struct RowBatch {
+        /*! \var DBDataSchema::Schema * schema
+         the Schema the rows belong to
+         */
+        DBDataSchema::Schema * schema;
+
+        /*! \var DBDataSchema::ColumnPlan * rowPlan
+         the row plan of the Schema, i.e. the type, offset and length of each column
+         */
+        DBDataSchema::ColumnPlan * rowPlan;
+
+        /*! \var int numCols
+         number of columns in a row
+         */
+        int numCols;
+
+        /*! \var int numRows
+         number of rows in the batch
+         */
+        int numRows;
+
+        /*! \var char * rows
+         the first row of the batch
+         */
+        char * rows;
+
+        /*! \var int64_t rowSize
+         number of bytes from one row to the next
+         */
+        int64_t rowSize;
+
+        /*! \var bool * isNull
+         numCols flags per row whether the value is NULL or not
+         */
+        bool * isNull;
+
+        /*! \var bool skipInvariant
+         if true, the columns with isInvariant set in the row plan have already been bound to this statement with the
+         same values. adaptors keeping their bindings after the statement is executed need not bind them again.
+         */
+        bool skipInvariant;
+
+        inline char * getRow(int rowId) const {
+            return rows + (int64_t)rowId * rowSize;
+        }
+
+        inline bool * getIsNullRow(int rowId) const {
+            return isNull + (int64_t)rowId * numCols;
+        }
+    } RowBatch;
     /*! \class DBAbstractor
      \brief DBAbstractor interface class
      
@@ -45,13 +109,17 @@ namespace DBServer {
     
     protected:
         bool supportsSchemaRetrieval;
+        bool supportsColumnBinding;
+        bool supportsConcurrentWriters;
+        bool keepsKeysDisabledOnCommit;
+        bool executesAsync;
         bool isConnected;
         bool resumeMode;
 
 	public:
         DBAbstractor();
         
-        ~DBAbstractor();        
+        virtual ~DBAbstractor();        
         
         /*! \brief connects to a database server. 
          \param string usr: username with which to connect to the DB server
@@ -73,6 +141,16 @@ namespace DBServer {
          Disconnects from the database server. If the disconnect was successfull, this shall return 1, otherwise 0.*/
 		virtual int disconnect() = 0;
         
+        /*! \brief creates a new adaptor with the same configuration.
+         
+         \return returns a new, unconnected DBAbstractor or NULL if the adaptor does not support this
+         
+         Creates a new instance of the same adaptor and copies all the settings that have been made on this one
+         (but not the connection). This is used to open additional connections for committing in parallel. The
+         default implementation returns NULL, in which case the connections are created through the
+         DBAdaptorsFactory with the factory defaults.*/
+        virtual DBAbstractor * createLike();
+        
         /*! \brief sets a new savepoint if supported by the DB engine. 
          
          \return returns 1 if successfull or 0 if not
@@ -198,6 +276,30 @@ namespace DBServer {
          size as Schema and needs to be of equal ordering!*/
         virtual int bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, bool* isNullArray, void* preparedStatement, int nInStmt) = 0;
 
+        /*! \brief binds a batch of rows to a prepared statement (works as well for multi statements).  
+         \param const RowBatch & thisBatch: the rows to bind, row i of the batch is bound to the i-th row of the statement
+         \param void* preparedStatement: a pointer to a prepared statement object
+         \return returns 1 if successfull, 0 if not
+         
+         Binds all the rows of a statement with one call, so that an adaptor can resolve the column types once per
+         batch and bind the values without copying them (the batch stays valid until the statement is executed). The
+         default implementation calls bindOneRowToStmt for each row, always binding every column.*/
+        virtual int bindBatch(const RowBatch & thisBatch, void* preparedStatement);
+        
+        /*! \brief binds rows stored column by column to a prepared statement (works as well for multi statements).
+         \param DBDataSchema::Schema * thisSchema: a valid Schema where the data should be inserted
+         \param void** columnData: for each column in the row plan of the Schema, the array of its values (byteLen bytes per row, 
+                    strings as char* copied by StringArena::copyString), starting with the first row to bind
+         \param bool** isNullColumns: for each column in the row plan of the Schema, the array of flags whether the value is null or not
+         \param void* preparedStatement: a pointer to a prepared statement object
+         \param int numRows: the number of rows to bind, i.e. the number of rows covered by the statement
+         \return returns 1 if successfull, 0 if not
+         
+         Binds all the rows of a statement at once, one column after the other. Only adaptors that set supportsColumnBinding
+         need to implement this, the DBIngestColumnBuffer is only used with them. The default implementation must not be
+         reached: it asserts that the adaptor reports getSupportsColumnBinding() and fails with an error.*/
+        virtual int bindColumnsToStmt(DBDataSchema::Schema * thisSchema, void** columnData, bool** isNullColumns, void* preparedStatement, int numRows);
+        
         /*! \brief executes the given statement.  
          \param void* preparedStatement: a pointer to a prepared statement object
          
@@ -206,6 +308,24 @@ namespace DBServer {
          Executes the given prepared statement.*/
         virtual int executeStmt(void* preparedStatement) = 0;
         
+        /*! \brief starts executing the given statement, without waiting for the server to answer.  
+         \param void* preparedStatement: a pointer to a prepared statement object
+         
+         \return returns 1 if successfull, 0 if not, -2 if the connection had to be reestablished
+         
+         Once this returns, the adaptor does not read the bound rows anymore, they may be overwritten and the statement
+         may be bound again. At most one statement is running per connection: the adaptor waits for it (and reports its
+         errors) before it does anything else on the connection, or when waitStmt() is called. The default implementation
+         calls executeStmt().*/
+        virtual int executeStmtAsync(void* preparedStatement);
+        
+        /*! \brief waits for the statement started with executeStmtAsync() to finish
+         
+         \return returns 1 if successfull, 0 if not
+         
+         Returns immediately if no statement is running. The default implementation does nothing.*/
+        virtual int waitStmt();
+        
         /*! \brief finalizes and releases a prepared statement.  
          \param void* preparedStatement: a pointer to a prepared statement object
          
@@ -239,6 +359,21 @@ namespace DBServer {
         void setResumeMode(bool newResumeMode);
 
         bool getSupportsSchemaRetrieval();
+        
+        bool getSupportsColumnBinding();
+        
+        /*! \brief returns true if several connections can write into the same table at the same time. Adaptors that
+         write into a single file (i.e. SQLite3 or CSV) set this to false, the ingest then only uses one connection.*/
+        bool getSupportsConcurrentWriters();
+        
+        /*! \brief returns true if keys disabled with disableKeys stay disabled when a transaction is committed. Adaptors
+         that need to restore the keys before committing (i.e. SQLite3, which drops the indexes) set this to false, the
+         ingest then keeps the keys if it commits in between.*/
+        bool getKeepsKeysDisabledOnCommit();
+        
+        /*! \brief returns true if executeStmtAsync() returns before the server has answered. The time spent in
+         executeStmtAsync() is then not the round trip of the statement.*/
+        bool getExecutesAsync();
     };
 }
 
@@ -39,6 +39,7 @@ using namespace std;
 
 DBCSV::DBCSV() {
     supportsSchemaRetrieval = false;
+    supportsConcurrentWriters = false;
     fileHandler = NULL;
     wroteHeader = false;
 }
@@ -213,14 +214,19 @@ int DBCSV::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, v
 
 //this can handle NULL values
 int DBCSV::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, bool* isNullArray, void* preparedStatement, int nInStmt) {
+    assert(thisSchema != NULL);
+    assert(thisData != NULL);
+    assert(isNullArray != NULL);
+    
     //construct query string
     string query = "";
+    vector<DBDataSchema::ColumnPlan> & rowPlan = thisSchema->getRowPlan();
     
     //insert column names
     if(wroteHeader == false) {
-        for(int i=0; i<thisSchema->getArrSchemaItems().size(); i++) {
-            query.append(thisSchema->getArrSchemaItems().at(i)->getColumnName());
-            if (i != thisSchema->getArrSchemaItems().size() - 1) {
+        for(int i=0; i<rowPlan.size(); i++) {
+            query.append(rowPlan[i].schemaItem->getColumnName());
+            if (i != rowPlan.size() - 1) {
                 query.append(", ");
             } else {
                 query.append("\n");
@@ -235,59 +241,70 @@ int DBCSV::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, b
     }
     
     //add the data to the querry string
-    long byteCount = 0;
+    char * currRow = (char*)thisData;
     
-    for(int i=0; i<thisSchema->getArrSchemaItems().size(); i++) {
-        DBDataSchema::DataObjDesc * currObj = thisSchema->getArrSchemaItems().at(i)->getDataDesc();        
-        unsigned long strLen;
+    for(int i=0; i<rowPlan.size(); i++) {
+        DBDataSchema::ColumnPlan & currCol = rowPlan[i];
+        char * currCell = currRow + currCol.offset;
         char * theString;
 
-        if(isNullArray[i] == 1) {
-            //adding empty value here
-            query.append(", ");
-            continue;
-        }
-
-        switch (currObj->getDataObjDType()) {
-            case DBDataSchema::DT_STRING:
-                theString = *(char**)(thisData+byteCount);
-                strLen = strlen(theString);
-                query.append("\"");
-                query.append(theString, strLen);
-                query.append("\"");
-                byteCount += sizeof(char*);
-                break;
-            case DBDataSchema::DT_INT1:
-                query.append(boost::str(boost::format("%hd") % *(int8_t*)(thisData+byteCount)));
-                byteCount += sizeof(int8_t);
-                break;
-            case DBDataSchema::DT_INT2:
-                query.append(boost::str(boost::format("%hd") % *(int16_t*)(thisData+byteCount)));
-                byteCount += sizeof(int16_t);
-                break;
-            case DBDataSchema::DT_INT4:
-                query.append(boost::str(boost::format("%d") % *(int32_t*)(thisData+byteCount)));
-                byteCount += sizeof(long);
-                break;
-            case DBDataSchema::DT_INT8:
-                query.append(boost::str(boost::format("%lld") % *(int64_t*)(thisData+byteCount)));
-                byteCount += sizeof(int64_t);
-                break;
-            case DBDataSchema::DT_REAL4:
-                //for safety in the cast below
-                query.append(boost::str(boost::format("%f") % *(float*)(thisData+byteCount)));
-                byteCount += sizeof(float);
-                break;
-            case DBDataSchema::DT_REAL8:
-                query.append(boost::str(boost::format("%lf") % *(double*)(thisData+byteCount)));
-                byteCount += sizeof(double);
-                break;
-            default:
-                query.clear();
-                return 0;
+        //NULL values are left empty
+        if(isNullArray[i] != 1) {
+            //DBT_ANY holds the value as it was read
+            DBDataSchema::DBType writeType = currCol.dbType;
+            if(writeType == DBDataSchema::DBT_ANY) {
+                writeType = DBDataSchema::convDTypeToDBType(currCol.dType);
+            }
+            
+            switch (writeType) {
+                case DBDataSchema::DBT_CHAR:
+                    theString = *(char**)currCell;
+                    query.append("\"");
+                    query.append(theString);
+                    query.append("\"");
+                    break;
+                case DBDataSchema::DBT_BIT:
+                case DBDataSchema::DBT_TINYINT:
+                    query.append(boost::str(boost::format("%hd") % (int16_t)*(int8_t*)currCell));
+                    break;
+                case DBDataSchema::DBT_SMALLINT:
+                    query.append(boost::str(boost::format("%hd") % *(int16_t*)currCell));
+                    break;
+                case DBDataSchema::DBT_MEDIUMINT:
+                case DBDataSchema::DBT_INTEGER:
+                    query.append(boost::str(boost::format("%d") % *(int32_t*)currCell));
+                    break;
+                case DBDataSchema::DBT_BIGINT:
+                    query.append(boost::str(boost::format("%lld") % *(int64_t*)currCell));
+                    break;
+                case DBDataSchema::DBT_UTINYINT:
+                    query.append(boost::str(boost::format("%hu") % (uint16_t)*(uint8_t*)currCell));
+                    break;
+                case DBDataSchema::DBT_USMALLINT:
+                    query.append(boost::str(boost::format("%hu") % *(uint16_t*)currCell));
+                    break;
+                case DBDataSchema::DBT_UMEDIUMINT:
+                case DBDataSchema::DBT_UINTEGER:
+                    query.append(boost::str(boost::format("%u") % *(uint32_t*)currCell));
+                    break;
+                case DBDataSchema::DBT_UBIGINT:
+                    query.append(boost::str(boost::format("%llu") % *(uint64_t*)currCell));
+                    break;
+                case DBDataSchema::DBT_FLOAT:
+                case DBDataSchema::DBT_UFLOAT:
+                    query.append(boost::str(boost::format("%f") % *(float*)currCell));
+                    break;
+                case DBDataSchema::DBT_REAL:
+                case DBDataSchema::DBT_UREAL:
+                    query.append(boost::str(boost::format("%lf") % *(double*)currCell));
+                    break;
+                default:
+                    query.clear();
+                    return 0;
+            }
         }
         
-        if (i != thisSchema->getArrSchemaItems().size() - 1) {
+        if (i != rowPlan.size() - 1) {
             query.append(", ");
         } else {
             query.append("\n");
@@ -22,8 +22,10 @@
 #include "dbingestor_error.h"
 #include "DBType.h"
 #include "DType.h"
+#include "StringArena.h"
 #include <string.h>
 #include <stdio.h>
+#include <limits.h>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/xpressive/xpressive.hpp>
@@ -39,20 +41,280 @@ using namespace std;
 
 #define AING_MYSQL_LENQUERRYBUFFER 1000
 
+//size of the value slot of a bind, large enough for every numeric type
+#define AING_MYSQL_VALUESLOT 8
+
+//MariaDB Connector/C can execute a single row statement against arrays of parameters
+#if defined(MARIADB_PACKAGE_VERSION_ID) && MARIADB_PACKAGE_VERSION_ID >= 30000
+#define AING_MYSQL_ARRAY_BINDING
+#endif
+
+//and it has a non-blocking API, which is used to collect the answer of a statement later on
+#if defined(MARIADB_PACKAGE_VERSION_ID) && MARIADB_PACKAGE_VERSION_ID >= 30000 && !defined(_WIN32)
+#define AING_MYSQL_NONBLOCKING
+#include <poll.h>
+#include <errno.h>
+#endif
+
 typedef struct {
     MYSQL_STMT *stmt;
     MYSQL_BIND *bind;
+    unsigned long *lengths;
+    my_bool *isNull;
+    char *valueSlots;
+    char **strSlots;
+    unsigned long *strSlotSizes;
     int lenBind;
     bool prepared;
-    my_bool isNullTrue;
-    my_bool isNullFalse;
+    bool paramsBound;
+    int arraySize;
+    unsigned int boundArraySize;
 } MYSQL_prepStmt;
 
+//allocates the binds of a statement together with the lengths, NULL flags and value slots they point to. these
+//stay where they are for the life time of the statement, only their values change from row to row
+static MYSQL_BIND * allocBindArrays(MYSQL_prepStmt * stmtContainer, int lenBind) {
+    MYSQL_BIND *bind = (MYSQL_BIND*)malloc(lenBind * sizeof(MYSQL_BIND));
+    unsigned long *lengths = (unsigned long*)malloc(lenBind * sizeof(unsigned long));
+    my_bool *isNull = (my_bool*)malloc(lenBind * sizeof(my_bool));
+    char *valueSlots = (char*)malloc((size_t)lenBind * AING_MYSQL_VALUESLOT);
+    char **strSlots = (char**)calloc(lenBind, sizeof(char*));
+    unsigned long *strSlotSizes = (unsigned long*)calloc(lenBind, sizeof(unsigned long));
+    if(bind == NULL || lengths == NULL || isNull == NULL || valueSlots == NULL || strSlots == NULL || strSlotSizes == NULL) {
+        DBIngestor_error("DBMySQL: could not allocate bind container.", NULL);
+    }
+    
+    //zero the bind structure
+    memset(bind, 0, lenBind * sizeof(MYSQL_BIND));
+    memset(lengths, 0, lenBind * sizeof(unsigned long));
+    memset(isNull, 0, lenBind * sizeof(my_bool));
+    
+    memset(valueSlots, 0, (size_t)lenBind * AING_MYSQL_VALUESLOT);
+    
+    //numbers are copied into their value slot, strings move to a slot of their own once the first one arrives
+    for(int i=0; i<lenBind; i++) {
+        bind[i].buffer = valueSlots + (size_t)i * AING_MYSQL_VALUESLOT;
+        bind[i].length = &lengths[i];
+        bind[i].is_null = &isNull[i];
+    }
+    
+    stmtContainer->bind = bind;
+    stmtContainer->lengths = lengths;
+    stmtContainer->isNull = isNull;
+    stmtContainer->valueSlots = valueSlots;
+    stmtContainer->strSlots = strSlots;
+    stmtContainer->strSlotSizes = strSlotSizes;
+    stmtContainer->lenBind = lenBind;
+    stmtContainer->paramsBound = false;
+    stmtContainer->arraySize = 0;
+    stmtContainer->boundArraySize = 0;
+    
+    return bind;
+}
+
+//turns a single row statement into one that is executed against arrays of up to arraySize rows. each bind
+//gets arraySize lengths, the NULL indicators are taken from the buffer when binding
+static void allocArrayLengths(MYSQL_prepStmt * stmtContainer, int arraySize) {
+    unsigned long *lengths = (unsigned long*)malloc((size_t)stmtContainer->lenBind * arraySize * sizeof(unsigned long));
+    if(lengths == NULL) {
+        DBIngestor_error("DBMySQL: could not allocate bind container.", NULL);
+    }
+    
+    memset(lengths, 0, (size_t)stmtContainer->lenBind * arraySize * sizeof(unsigned long));
+    
+    for(int i=0; i<stmtContainer->lenBind; i++) {
+        stmtContainer->bind[i].length = lengths + (size_t)i * arraySize;
+        stmtContainer->bind[i].is_null = NULL;
+    }
+    
+    free(stmtContainer->lengths);
+    stmtContainer->lengths = lengths;
+    stmtContainer->arraySize = arraySize;
+}
+
+//passes the binds to the statement if a bind buffer has moved since the last execution, returns 0 on error
+static int bindStmtParams(MYSQL * dbHandler, MYSQL_prepStmt * statement) {
+    if(statement->paramsBound == true) {
+        return 1;
+    }
+    
+#ifdef AING_MYSQL_ARRAY_BINDING
+    if(statement->arraySize > 0 && mysql_stmt_attr_set(statement->stmt, STMT_ATTR_ARRAY_SIZE, &(statement->boundArraySize)) != 0) {
+        printf("DBMySQL: Error\n");
+        printf("ErrNr %u: %s\n", mysql_errno(dbHandler), mysql_error(dbHandler));
+        DBIngestor_error("DBMySQL - executeStmt: could not set the array size of the statement.\n", NULL);
+    }
+#endif
+    
+    if( mysql_stmt_bind_param(statement->stmt, statement->bind) != 0 ) {
+        printf("DBMySQL: Error\n");
+        printf("ErrNr %u: %s\n", mysql_errno(dbHandler), mysql_error(dbHandler));
+        return 0;
+    }
+    
+    statement->paramsBound = true;
+    
+    return 1;
+}
+
+#ifdef AING_MYSQL_NONBLOCKING
+//waits until the socket of the connection is ready for what the non-blocking API asks for
+static int waitForSocket(MYSQL * dbHandler, int status) {
+    struct pollfd pfd;
+    pfd.fd = mysql_get_socket(dbHandler);
+    pfd.events = 0;
+    pfd.revents = 0;
+    
+    if(status & MYSQL_WAIT_READ) {
+        pfd.events |= POLLIN;
+    }
+    
+    if(status & MYSQL_WAIT_WRITE) {
+        pfd.events |= POLLOUT;
+    }
+    
+    if(status & MYSQL_WAIT_EXCEPT) {
+        pfd.events |= POLLPRI;
+    }
+    
+    int timeout = -1;
+    if(status & MYSQL_WAIT_TIMEOUT) {
+        timeout = (int)mysql_get_timeout_value_ms(dbHandler);
+    }
+    
+    int res;
+    do {
+        res = poll(&pfd, 1, timeout);
+    } while(res < 0 && errno == EINTR);
+    
+    if(res <= 0) {
+        return MYSQL_WAIT_TIMEOUT;
+    }
+    
+    int ready = 0;
+    
+    //errors and hang ups are reported as readable, the library finds out what happened when it reads
+    if(pfd.revents & (POLLIN | POLLERR | POLLHUP)) {
+        ready |= MYSQL_WAIT_READ;
+    }
+    
+    if(pfd.revents & POLLOUT) {
+        ready |= MYSQL_WAIT_WRITE;
+    }
+    
+    if(pfd.revents & POLLPRI) {
+        ready |= MYSQL_WAIT_EXCEPT;
+    }
+    
+    return ready;
+}
+#endif
+
+//copies a string into the slot of its bind, which belongs to the statement and only moves if the string
+//does not fit. the binds have to be passed again if it does
+static void copyToStrSlot(MYSQL_prepStmt * statement, int bindId, const char * string, unsigned long length) {
+    if(statement->strSlotSizes[bindId] < length + 1) {
+        unsigned long newSize = statement->strSlotSizes[bindId] * 2;
+        if(newSize < length + 1) {
+            newSize = length + 1;
+        }
+        if(newSize < 64) {
+            newSize = 64;
+        }
+        
+        char * newSlot = (char*)realloc(statement->strSlots[bindId], newSize);
+        if(newSlot == NULL) {
+            DBIngestor_error("DBMySQL: could not allocate string bind buffer.", NULL);
+        }
+        
+        statement->strSlots[bindId] = newSlot;
+        statement->strSlotSizes[bindId] = newSize;
+        statement->bind[bindId].buffer = newSlot;
+        statement->bind[bindId].buffer_length = newSize;
+        statement->paramsBound = false;
+    }
+    
+    memcpy(statement->strSlots[bindId], string, length + 1);
+}
+
+//copies the values of one row into the slots of its binds in the statement. the slots belong to the statement
+//and stay where they are, so that mysql_stmt_bind_param only needs to be called again if a string slot had to
+//grow, no matter where the rows of the buffer are. the lengths of arena strings (arenaStrings, i.e. rows of an
+//ingest buffer) are taken from the arena, others are counted
+static void bindRowToBinds(vector<DBDataSchema::ColumnPlan> & rowPlan, char * currRow, bool * isNullArray, MYSQL_prepStmt * statement, int stride, bool arenaStrings) {
+    MYSQL_BIND * bind = statement->bind + stride;
+    unsigned long * lengths = statement->lengths + stride;
+    my_bool * isNull = statement->isNull + stride;
+    
+    for(int i=0; i<rowPlan.size(); i++) {
+        DBDataSchema::ColumnPlan & currCol = rowPlan[i];
+        char * currCell = currRow + currCol.offset;
+        char * currString = NULL;
+        
+        switch (currCol.dbType) {
+            case DBDataSchema::DBT_CHAR:
+                currString = *(char**)currCell;
+                if(currString != NULL) {
+                    if(arenaStrings == true) {
+                        lengths[i] = (unsigned long)DBIngest::StringArena::getStringLength(currString);
+                    } else {
+                        lengths[i] = (unsigned long)strlen(currString);
+                    }
+                    copyToStrSlot(statement, stride + i, currString, lengths[i]);
+                } else {
+                    lengths[i] = 0;
+                }
+                break;
+            case DBDataSchema::DBT_BIT:
+            case DBDataSchema::DBT_BIGINT:
+            case DBDataSchema::DBT_MEDIUMINT:
+            case DBDataSchema::DBT_INTEGER:
+            case DBDataSchema::DBT_SMALLINT:
+            case DBDataSchema::DBT_TINYINT:
+            case DBDataSchema::DBT_UBIGINT:
+            case DBDataSchema::DBT_UMEDIUMINT:
+            case DBDataSchema::DBT_UINTEGER:
+            case DBDataSchema::DBT_USMALLINT:
+            case DBDataSchema::DBT_UTINYINT:
+            case DBDataSchema::DBT_FLOAT:
+            case DBDataSchema::DBT_REAL:
+                //the type and signedness have been set when preparing the statement
+                assert(currCol.byteLen <= AING_MYSQL_VALUESLOT);
+                memcpy(bind[i].buffer, currCell, currCol.byteLen);
+                break;
+            default:
+                DBIngestor_error("castDTypeToDBType: DBType not known, I don't know what to do.", NULL);
+        }
+        
+        if(isNullArray != NULL) {
+            isNull[i] = (isNullArray[i] == 1);
+        } else {
+            isNull[i] = 0;
+        }
+    }
+}
+
 
 DBMySQL::DBMySQL() {
     dbHandler = NULL;
 	myNumElements = -1;
 	recCount = 0;
+    localInfile = false;
+    arrayBinding = false;
+    asyncExecution = false;
+    nonBlocking = false;
+    pendingStmt = NULL;
+    pendingStatus = 0;
+}
+
+DBAbstractor * DBMySQL::createLike() {
+    DBMySQL * newMySQL = new DBMySQL();
+    
+    newMySQL->localInfile = localInfile;
+    newMySQL->arrayBinding = arrayBinding;
+    newMySQL->asyncExecution = asyncExecution;
+    
+    return newMySQL;
 }
 
 DBMySQL::~DBMySQL() {
@@ -83,6 +345,22 @@ int DBMySQL::connect(string usr, string pwd, string host, string port, string so
     
 	my_bool reconnect = true;
 	mysql_options(dbHandler, MYSQL_OPT_RECONNECT, &reconnect);
+    
+    if(localInfile == true) {
+        unsigned int allowLocalInfile = 1;
+        mysql_options(dbHandler, MYSQL_OPT_LOCAL_INFILE, &allowLocalInfile);
+    }
+    
+    nonBlocking = false;
+    if(asyncExecution == true) {
+#ifdef AING_MYSQL_NONBLOCKING
+        nonBlocking = (mysql_options(dbHandler, MYSQL_OPT_NONBLOCK, 0) == 0);
+#endif
+        if(nonBlocking == false) {
+            printf("DBMySQL: the client library does not support non-blocking execution, statements are executed synchronously.\n");
+        }
+    }
+    executesAsync = nonBlocking;
 
     if(mysql_real_connect(dbHandler, host.c_str(), usr.c_str(), pwd.c_str(), NULL, atoi(port.c_str()), socketStr, 0) == NULL) {
         printf("Error MySQL:\n");
@@ -90,12 +368,33 @@ int DBMySQL::connect(string usr, string pwd, string host, string port, string so
         DBIngestor_error("DBMySQL: could not connect to MySQL database\n", NULL);
     }
     
+    //array binding needs both the client library and the server to support bulk operations, otherwise
+    //the usual multi row statements are used
+    supportsColumnBinding = false;
+    if(arrayBinding == true) {
+#ifdef AING_MYSQL_ARRAY_BINDING
+        unsigned long serverCaps = 0;
+        unsigned long extServerCaps = 0;
+        mariadb_get_infov(dbHandler, MARIADB_CONNECTION_SERVER_CAPABILITIES, &serverCaps);
+        mariadb_get_infov(dbHandler, MARIADB_CONNECTION_EXTENDED_SERVER_CAPABILITIES, &extServerCaps);
+        
+        if((serverCaps & CLIENT_MYSQL) == 0 && (extServerCaps & (MARIADB_CLIENT_STMT_BULK_OPERATIONS >> 32)) != 0) {
+            supportsColumnBinding = true;
+        }
+#endif
+        if(supportsColumnBinding == false) {
+            printf("DBMySQL: array binding is not supported by the client library or the server, using multi row statements.\n");
+        }
+    }
+    
     isConnected = true;
     
     return 1;
 }
 
 int DBMySQL::disconnect() {
+    waitStmt();
+    
     mysql_close(dbHandler);
     
     dbHandler = NULL;
@@ -106,6 +405,8 @@ int DBMySQL::disconnect() {
 }
 
 int DBMySQL::setSavepoint() {
+    waitStmt();
+    
     if(resumeMode == false && mysql_query(dbHandler, "SAVEPOINT dbIngst_mysql_sp")) {
         printf("Error MySQL:\n");
         printf("ErrNr %u: %s\n", mysql_errno(dbHandler), mysql_error(dbHandler));
@@ -116,6 +417,8 @@ int DBMySQL::setSavepoint() {
 }
 
 int DBMySQL::rollback() {
+    waitStmt();
+    
     if(resumeMode == false && mysql_query(dbHandler, "ROLLBACK TO SAVEPOINT dbIngst_mysql_sp")) {
         printf("Error MySQL:\n");
         printf("ErrNr %u: %s\n", mysql_errno(dbHandler), mysql_error(dbHandler));
@@ -126,6 +429,8 @@ int DBMySQL::rollback() {
 }
 
 int DBMySQL::releaseSavepoint() {
+    waitStmt();
+    
     if(resumeMode == false && mysql_query(dbHandler, "RELEASE SAVEPOINT dbIngst_mysql_sp")) {
         printf("Error MySQL:\n");
         printf("ErrNr %u: %s\n", mysql_errno(dbHandler), mysql_error(dbHandler));
@@ -136,6 +441,8 @@ int DBMySQL::releaseSavepoint() {
 }
 
 int DBMySQL::disableKeys(DBDataSchema::Schema * thisSchema) {
+    waitStmt();
+    
     //construct query to disable the keys
     string query = "ALTER TABLE ";
     query.append(thisSchema->getDbName());
@@ -153,6 +460,8 @@ int DBMySQL::disableKeys(DBDataSchema::Schema * thisSchema) {
 }
 
 int DBMySQL::enableKeys(DBDataSchema::Schema * thisSchema) {
+    waitStmt();
+    
     //construct query to disable the keys
     string query = "ALTER TABLE ";
     query.append(thisSchema->getDbName());
@@ -173,6 +482,8 @@ int DBMySQL::enableKeys(DBDataSchema::Schema * thisSchema) {
 DBDataSchema::Schema * DBMySQL::getSchema(string database, string table) {
     char queryString[AING_MYSQL_LENQUERRYBUFFER];
     
+    waitStmt();
+    
     DBDataSchema::Schema * retSchema = new DBDataSchema::Schema;
     
     //construct query
@@ -222,6 +533,8 @@ DBDataSchema::Schema * DBMySQL::getSchema(string database, string table) {
 void* DBMySQL::prepareIngestStatement(DBDataSchema::Schema * thisSchema) {
     MYSQL_prepStmt * stmtContainer;
 
+    waitStmt();
+
 	myNumElements = -1;
 	mySchema = thisSchema;
 
@@ -231,17 +544,9 @@ void* DBMySQL::prepareIngestStatement(DBDataSchema::Schema * thisSchema) {
     }
     
     stmtContainer->prepared = false;
-    stmtContainer->isNullTrue = true;
-    stmtContainer->isNullFalse = false;
     
     MYSQL_STMT *statement;
-    MYSQL_BIND *bind;
-    bind = (MYSQL_BIND*)malloc(thisSchema->getNumActiveItems() * sizeof(MYSQL_BIND));
-    if(bind == NULL) {
-        DBIngestor_error("DBMySQL - prepareIngestStatement: could not allocate bind container.", NULL);
-    }
-    //zero the bind structure
-    memset(bind, 0, thisSchema->getNumActiveItems() * sizeof(MYSQL_BIND));
+    MYSQL_BIND *bind = allocBindArrays(stmtContainer, (int)thisSchema->getNumActiveItems());
     
     statement = mysql_stmt_init(dbHandler);
     if(statement == NULL) {
@@ -274,8 +579,6 @@ void* DBMySQL::prepareIngestStatement(DBDataSchema::Schema * thisSchema) {
         //fill the bind data with information about this
         bind[i].buffer_type = translateTypeToMYSQL(thisSchema->getArrSchemaItems().at(j)->getColumnDBType());
         bind[i].is_unsigned = isUnsignedType(thisSchema->getArrSchemaItems().at(j)->getColumnDBType());
-        bind[i].is_null = 0;
-        bind[i].length = 0;
         
         i++;
     }
@@ -307,13 +610,22 @@ void* DBMySQL::prepareIngestStatement(DBDataSchema::Schema * thisSchema) {
     
 	myquery = query;
     stmtContainer->stmt = statement;
-    stmtContainer->bind = bind;
-    stmtContainer->lenBind = (int)thisSchema->getNumActiveItems();
     
     return (void*)stmtContainer;    
 }
 
 void* DBMySQL::prepareMultiIngestStatement(DBDataSchema::Schema * thisSchema, int numElements) {
+    waitStmt();
+    
+    //with array binding, the single row statement is executed against the columns of the buffer
+    if(supportsColumnBinding == true) {
+        MYSQL_prepStmt * stmtContainer = (MYSQL_prepStmt*)prepareIngestStatement(thisSchema);
+        allocArrayLengths(stmtContainer, numElements);
+        myNumElements = numElements;
+        
+        return (void*)stmtContainer;
+    }
+    
 	myNumElements = numElements;
 	mySchema = thisSchema;
 	
@@ -330,17 +642,9 @@ void* DBMySQL::prepareMultiIngestStatement(DBDataSchema::Schema * thisSchema, in
     }
     
     stmtContainer->prepared = false;
-    stmtContainer->isNullTrue = true;
-    stmtContainer->isNullFalse = false;
     
     MYSQL_STMT *statement;
-    MYSQL_BIND *bind;
-    bind = (MYSQL_BIND*)malloc(numElements * thisSchema->getNumActiveItems() * sizeof(MYSQL_BIND));
-    if(bind == NULL) {
-        DBIngestor_error("DBMySQL - prepareMultiIngestStatement: could not allocate bind container.", NULL);
-    }
-    //zero the bind structure
-    memset(bind, 0, numElements * thisSchema->getNumActiveItems() * sizeof(MYSQL_BIND));
+    MYSQL_BIND *bind = allocBindArrays(stmtContainer, numElements * (int)thisSchema->getNumActiveItems());
 
     statement = mysql_stmt_init(dbHandler);
     if(statement == NULL) {
@@ -394,8 +698,6 @@ void* DBMySQL::prepareMultiIngestStatement(DBDataSchema::Schema * thisSchema, in
             unsigned long size = thisSchema->getNumActiveItems();
             bind[j*size+i].buffer_type = translateTypeToMYSQL(thisSchema->getArrSchemaItems().at(k)->getColumnDBType());
             bind[j*size+i].is_unsigned = isUnsignedType(thisSchema->getArrSchemaItems().at(k)->getColumnDBType());
-            bind[j*size+i].is_null = 0;
-            bind[j*size+i].length = 0;
             
             i++;
         }
@@ -412,8 +714,6 @@ void* DBMySQL::prepareMultiIngestStatement(DBDataSchema::Schema * thisSchema, in
 
 	myquery = query;
     stmtContainer->stmt = statement;
-    stmtContainer->bind = bind;
-    stmtContainer->lenBind = numElements * (int)thisSchema->getNumActiveItems();
     
     return (void*)stmtContainer;    
 }
@@ -421,6 +721,8 @@ void* DBMySQL::prepareMultiIngestStatement(DBDataSchema::Schema * thisSchema, in
 int DBMySQL::insertOneRow(DBDataSchema::Schema * thisSchema, void** thisData) {
     string query;
     
+    waitStmt();
+    
     query = buildOneRowInsertString(thisSchema, thisData, DBTYPE_MYSQL);
 
     if(query.size() == 0) {
@@ -459,135 +761,11 @@ int DBMySQL::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData,
     assert(preparedStatement != NULL);
     
     MYSQL_prepStmt *statement = (MYSQL_prepStmt*) preparedStatement;
-    long byteCount = 0;
-    int stride = nInStmt * (int)thisSchema->getNumActiveItems();
-    char * currRow = (char*)thisData;
+    vector<DBDataSchema::ColumnPlan> & rowPlan = thisSchema->getRowPlan();
     
-    //bind data to the prepared statement
-    int i = 0;
-    for(int j=0; j<thisSchema->getArrSchemaItems().size(); j++) {
-        if(thisSchema->getArrSchemaItems().at(j)->getColumnName().compare(EMPTY_SCHEMAITEM_NAME) == 0) {
-            continue;
-        }
-
-        unsigned long strLen;
-        char * theString;
-        int8_t tmpVal3;
-        int16_t tmpVal;
-        uint8_t tmpVal4;
-        uint16_t tmpVal5;
-        
-        switch (thisSchema->getArrSchemaItems().at(j)->getColumnDBType()) {
-            case DBDataSchema::DBT_CHAR:
-                theString = *(char**)(currRow+byteCount);
-                strLen = strlen(theString);
-                statement->bind[stride+i].buffer = *(char**)(currRow+byteCount);
-                
-                if(statement->bind[stride+i].length == NULL) {
-                    statement->bind[stride+i].length = (unsigned long*)malloc(sizeof(unsigned long));
-                }
-                
-                *(statement->bind[stride+i].length) = strLen;
-                byteCount += sizeof(char*);
-                break;
-            case DBDataSchema::DBT_BIT:
-                //for safety in the cast below
-                memcpy(&tmpVal3, (int8_t*)(currRow+byteCount), sizeof(int8_t));
-                
-                if(statement->bind[stride+i].buffer == NULL) {
-                    statement->bind[stride+i].buffer = (signed char*)malloc(sizeof(signed char));
-                }
-                
-                *(signed char*)(statement->bind[stride+i].buffer) = (signed char)tmpVal3;
-                byteCount += sizeof(int8_t);
-                break;
-            case DBDataSchema::DBT_BIGINT:
-                statement->bind[stride+i].buffer = (int64_t*)(currRow+byteCount);
-                byteCount += sizeof(int64_t);
-                break;
-            case DBDataSchema::DBT_MEDIUMINT:
-                statement->bind[stride+i].buffer = (int32_t*)(currRow+byteCount);
-                byteCount += sizeof(int32_t);
-                break;
-            case DBDataSchema::DBT_INTEGER:
-                statement->bind[stride+i].buffer = (int32_t*)(currRow+byteCount);
-                byteCount += sizeof(int32_t);
-                break;
-            case DBDataSchema::DBT_SMALLINT:
-                //for safety in the cast below
-                memcpy(&tmpVal, (int16_t*)(currRow+byteCount), sizeof(int16_t));
-                
-                if(statement->bind[stride+i].buffer == NULL) {
-                    statement->bind[stride+i].buffer = (short int*)malloc(sizeof(short int));
-                }
-                
-                *(short int*)(statement->bind[stride+i].buffer) = (short int)tmpVal;
-                byteCount += sizeof(int16_t);
-                break;
-            case DBDataSchema::DBT_TINYINT:
-                //for safety in the cast below
-                memcpy(&tmpVal3, (int8_t*)(currRow+byteCount), sizeof(int8_t));
-                
-                if(statement->bind[stride+i].buffer == NULL) {
-                    statement->bind[stride+i].buffer = (signed char*)malloc(sizeof(signed char));
-                }
-                
-                *(signed char*)(statement->bind[stride+i].buffer) = (signed char)tmpVal3;
-                byteCount += sizeof(int8_t);
-                break;
-            case DBDataSchema::DBT_UBIGINT:
-                statement->bind[stride+i].buffer = (uint64_t*)(currRow+byteCount);
-                statement->bind[stride+i].is_unsigned = 1;
-                byteCount += sizeof(uint64_t);
-                break;
-            case DBDataSchema::DBT_UMEDIUMINT:
-                statement->bind[stride+i].buffer = (uint32_t*)(currRow+byteCount);
-                statement->bind[stride+i].is_unsigned = 1;
-                byteCount += sizeof(uint32_t);
-                break;
-            case DBDataSchema::DBT_UINTEGER:
-                statement->bind[stride+i].buffer = (uint32_t*)(currRow+byteCount);
-                statement->bind[stride+i].is_unsigned = 1;
-                byteCount += sizeof(uint32_t);
-                break;
-            case DBDataSchema::DBT_USMALLINT:
-                //for safety in the cast below
-                memcpy(&tmpVal4, (uint16_t*)(currRow+byteCount), sizeof(uint16_t));
-                
-                if(statement->bind[stride+i].buffer == NULL) {
-                    statement->bind[stride+i].buffer = (short unsigned int*)malloc(sizeof(short unsigned int));
-                }
-                
-                *(short unsigned int*)(statement->bind[stride+i].buffer) = (short unsigned int)tmpVal;
-                statement->bind[stride+i].is_unsigned = 1;
-                byteCount += sizeof(uint16_t);
-                break;
-            case DBDataSchema::DBT_UTINYINT:
-                //for safety in the cast below
-                memcpy(&tmpVal5, (uint8_t*)(currRow+byteCount), sizeof(uint8_t));
-                
-                if(statement->bind[stride+i].buffer == NULL) {
-                    statement->bind[stride+i].buffer = (unsigned char*)malloc(sizeof(unsigned char));
-                }
-                
-                *(unsigned char*)(statement->bind[stride+i].buffer) = (unsigned char)tmpVal3;
-                statement->bind[stride+i].is_unsigned = 1;
-                byteCount += sizeof(uint8_t);
-                break;
-            case DBDataSchema::DBT_FLOAT:
-                statement->bind[stride+i].buffer = (float*)(currRow+byteCount);
-                byteCount += sizeof(float);
-                break;
-            case DBDataSchema::DBT_REAL:
-                statement->bind[stride+i].buffer = (double*)(currRow+byteCount);
-                byteCount += sizeof(double);
-                break;
-            default:
-                DBIngestor_error("castDTypeToDBType: DBType not known, I don't know what to do.", NULL);
-        }
-        
-        i++;
-    }
+    //bind data to the prepared statement. the values are copied into the slots of the binds, the row may be
+    //reused right away
+    bindRowToBinds(rowPlan, (char*)thisData, NULL, statement, nInStmt * (int)rowPlan.size(), false);
     
     return 1;
 }
@@ -599,30 +777,77 @@ int DBMySQL::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData,
     assert(isNullArray != NULL);
     assert(preparedStatement != NULL);
     
-    //pass command through
-    bindOneRowToStmt(thisSchema, thisData, preparedStatement, nInStmt);
+    MYSQL_prepStmt *statement = (MYSQL_prepStmt*) preparedStatement;
+    vector<DBDataSchema::ColumnPlan> & rowPlan = thisSchema->getRowPlan();
+    
+    bindRowToBinds(rowPlan, (char*)thisData, isNullArray, statement, nInStmt * (int)rowPlan.size(), false);
+    
+    return 1;
+}
+
+int DBMySQL::bindBatch(const RowBatch & thisBatch, void* preparedStatement) {
+    assert(thisBatch.schema != NULL);
+    assert(preparedStatement != NULL);
     
-    //now bind the NULLs
     MYSQL_prepStmt *statement = (MYSQL_prepStmt*) preparedStatement;
-    int stride = nInStmt * (int)thisSchema->getNumActiveItems();
+    vector<DBDataSchema::ColumnPlan> & rowPlan = thisBatch.schema->getRowPlan();
     
-    //bind NULLs to the prepared statement
-    int i = 0;
-    for(int j=0; j<thisSchema->getArrSchemaItems().size(); j++) {
-        if(thisSchema->getArrSchemaItems().at(j)->getColumnName().compare(EMPTY_SCHEMAITEM_NAME) == 0) {
-            continue;
-        }
+    assert(thisBatch.numRows * thisBatch.numCols <= statement->lenBind);
+    
+    //the values are copied into the slots of the binds, which do not move. the string lengths come from the
+    //string arena of the buffer
+    for(int i=0; i<thisBatch.numRows; i++) {
+        bindRowToBinds(rowPlan, thisBatch.getRow(i), thisBatch.getIsNullRow(i), statement, i * thisBatch.numCols, true);
+    }
+    
+    return 1;
+}
+
+int DBMySQL::bindColumnsToStmt(DBDataSchema::Schema * thisSchema, void** columnData, bool** isNullColumns, void* preparedStatement, int numRows) {
+    assert(thisSchema != NULL);
+    assert(columnData != NULL);
+    assert(isNullColumns != NULL);
+    assert(preparedStatement != NULL);
+    
+#ifdef AING_MYSQL_ARRAY_BINDING
+    MYSQL_prepStmt *statement = (MYSQL_prepStmt*) preparedStatement;
+    vector<DBDataSchema::ColumnPlan> & rowPlan = thisSchema->getRowPlan();
+    
+    assert(statement->arraySize >= numRows);
+    assert(statement->lenBind == (int)rowPlan.size());
+    
+    //a bool is one byte with 0 or 1, which are STMT_INDICATOR_NONE and STMT_INDICATOR_NULL
+    assert(sizeof(bool) == sizeof(char));
+    
+    for(int i=0; i<rowPlan.size(); i++) {
+        MYSQL_BIND & currBind = statement->bind[i];
         
-        if(isNullArray[i] == 1) {
-            statement->bind[stride+i].is_null = &(statement->isNullTrue);
-        } else {
-            statement->bind[stride+i].is_null = &(statement->isNullFalse);
+        //strings are bound as an array of char*, the lengths are needed for each of them. the strings of an ingest
+        //buffer come from its string arenas, which know their lengths
+        if(rowPlan[i].dbType == DBDataSchema::DBT_CHAR) {
+            char ** strings = (char**)columnData[i];
+            for(int j=0; j<numRows; j++) {
+                currBind.length[j] = (strings[j] != NULL) ? (unsigned long)DBIngest::StringArena::getStringLength(strings[j]) : 0;
+            }
         }
         
-        i++;
+        if(currBind.buffer != columnData[i] || currBind.u.indicator != (char*)isNullColumns[i]) {
+            currBind.buffer = columnData[i];
+            currBind.u.indicator = (char*)isNullColumns[i];
+            statement->paramsBound = false;
+        }
+    }
+    
+    if(statement->boundArraySize != (unsigned int)numRows) {
+        statement->boundArraySize = (unsigned int)numRows;
+        statement->paramsBound = false;
     }
     
     return 1;
+#else
+    DBIngestor_error("DBMySQL - bindColumnsToStmt: array binding is not supported by this client library.\n", NULL);
+    return 0;
+#endif
 }
 
 int DBMySQL::executeStmt(void* preparedStatement) {
@@ -631,11 +856,11 @@ int DBMySQL::executeStmt(void* preparedStatement) {
 	assert(preparedStatement != NULL);
     MYSQL_prepStmt *statement = (MYSQL_prepStmt*) preparedStatement;
     
-    if( mysql_stmt_bind_param(statement->stmt, statement->bind) != 0 ) {
-        printf("DBMySQL: Error\n");
-        printf("ErrNr %u: %s\n", mysql_errno(dbHandler), mysql_error(dbHandler));
-        if(recCount == 1)
-			DBIngestor_error("DBMySQL - executeStmt: could not bind statement.\n", NULL);
+    waitStmt();
+    
+    //the binds only need to be passed again if a string slot has grown since the last execution
+    if(bindStmtParams(dbHandler, statement) != 1 && recCount == 1) {
+        DBIngestor_error("DBMySQL - executeStmt: could not bind statement.\n", NULL);
     }
     
     
@@ -652,6 +877,7 @@ int DBMySQL::executeStmt(void* preparedStatement) {
             mysql_stmt_close(statement->stmt);
 
 			statement->stmt = mysql_stmt_init(dbHandler);
+            statement->paramsBound = false;
 
 			if (mysql_stmt_prepare(statement->stmt, myquery.c_str(), strlen(myquery.c_str())) != 0) {
 				printf("DBMySQL: Error\n");
@@ -674,23 +900,79 @@ int DBMySQL::executeStmt(void* preparedStatement) {
     return 1;
 }
 
-int DBMySQL::finalizePreparedStatement(void* preparedStatement) {
-    assert(preparedStatement != NULL);
+int DBMySQL::executeStmtAsync(void* preparedStatement) {
+#ifdef AING_MYSQL_NONBLOCKING
+    //the reconnects of resume mode are only handled by the blocking path
+    if(nonBlocking == false || resumeMode == true) {
+        return executeStmt(preparedStatement);
+    }
+    
+	assert(preparedStatement != NULL);
     MYSQL_prepStmt *statement = (MYSQL_prepStmt*) preparedStatement;
     
-    //first free any allocated memory, then free bind buffer, then close statement
-    for(int i=0; i<statement->lenBind; i++) {
-        if(statement->bind[i].length != NULL)
-            free(statement->bind[i].length);
+    //only one statement can run on a connection
+    waitStmt();
+    
+    if(bindStmtParams(dbHandler, statement) != 1) {
+        DBIngestor_error("DBMySQL - executeStmtAsync: could not bind statement.\n", NULL);
+    }
+    
+    //the request is built from the bound rows before anything is sent, from here on the rows are not read anymore
+    int err = 0;
+    int status = mysql_stmt_execute_start(&err, statement->stmt);
+    
+    if(status != 0) {
+        pendingStmt = statement;
+        pendingStatus = status;
         
-        if(statement->bind[i].buffer_type == MYSQL_TYPE_TINY &&
-           statement->bind[i].buffer != NULL) 
-            free(statement->bind[i].buffer);
+        return 1;
+    }
+    
+    if(err != 0) {
+        printf("DBMySQL: Error\n");
+        printf("ErrNr %u: %s\n", mysql_errno(dbHandler), mysql_error(dbHandler));
+        DBIngestor_error("DBMySQL - executeStmtAsync: could not execute statement.\n", NULL);
+    }
+    
+    return 1;
+#else
+    return executeStmt(preparedStatement);
+#endif
+}
 
-        if(statement->bind[i].buffer_type == MYSQL_TYPE_SHORT &&
-           statement->bind[i].buffer != NULL) 
-            free(statement->bind[i].buffer);
+int DBMySQL::waitStmt() {
+#ifdef AING_MYSQL_NONBLOCKING
+    if(pendingStmt == NULL) {
+        return 1;
+    }
+    
+    MYSQL_prepStmt *statement = (MYSQL_prepStmt*) pendingStmt;
+    int err = 0;
+    int status = pendingStatus;
+    
+    while(status != 0) {
+        status = mysql_stmt_execute_cont(&err, statement->stmt, waitForSocket(dbHandler, status));
+    }
+    
+    pendingStmt = NULL;
+    pendingStatus = 0;
+    
+    if(err != 0) {
+        printf("DBMySQL: Error\n");
+        printf("ErrNr %u: %s\n", mysql_errno(dbHandler), mysql_error(dbHandler));
+        DBIngestor_error("DBMySQL - waitStmt: could not execute statement.\n", NULL);
     }
+#endif
+    
+    return 1;
+}
+
+int DBMySQL::finalizePreparedStatement(void* preparedStatement) {
+    assert(preparedStatement != NULL);
+    
+    waitStmt();
+    MYSQL_prepStmt *statement = (MYSQL_prepStmt*) preparedStatement;
+    
 
     if(mysql_stmt_close(statement->stmt) != 0) {
         printf("DBMySQL: Error\n");
@@ -698,12 +980,29 @@ int DBMySQL::finalizePreparedStatement(void* preparedStatement) {
         DBIngestor_error("DBMySQL - finalizePreparedStatement: error in stmt close.\n", NULL);
     }
     
+    //without array binding, the binds point to the value and string slots of the statement
+    for(int i=0; i<statement->lenBind; i++) {
+        free(statement->strSlots[i]);
+    }
+    free(statement->valueSlots);
+    free(statement->strSlots);
+    free(statement->strSlotSizes);
+    free(statement->bind);
+    free(statement->lengths);
+    free(statement->isNull);
     free(statement);
     
     return 1;
 }
 
 int DBMySQL::maxRowsPerStmt(DBDataSchema::Schema * thisSchema) {
+    //there is only one row of placeholders with array binding
+    if(supportsColumnBinding == true) {
+        return INT_MAX;
+    }
+    
+    waitStmt();
+    
     char queryString[AING_MYSQL_LENQUERRYBUFFER] = "SHOW VARIABLES LIKE 'max_prepared_stmt_count'";
     
     if(mysql_query(dbHandler, queryString)) {
@@ -728,6 +1027,8 @@ int DBMySQL::maxRowsPerStmt(DBDataSchema::Schema * thisSchema) {
 void * DBMySQL::initGetCompleteTable(DBDataSchema::Schema * thisSchema) {
     assert(thisSchema != NULL);
     
+    waitStmt();
+    
     MYSQL_prepStmt * stmtContainer;
     stmtContainer = (MYSQL_prepStmt*)malloc(sizeof(MYSQL_prepStmt));
     if (stmtContainer == NULL) {
@@ -735,19 +1036,11 @@ void * DBMySQL::initGetCompleteTable(DBDataSchema::Schema * thisSchema) {
     }
     
     stmtContainer->prepared = false;
-    stmtContainer->isNullTrue = true;
-    stmtContainer->isNullFalse = false;
 
     MYSQL_STMT *statement;
     statement = mysql_stmt_init(dbHandler);
 
-    MYSQL_BIND *bind;
-    bind = (MYSQL_BIND*)malloc(thisSchema->getNumActiveItems() * sizeof(MYSQL_BIND));
-    if(bind == NULL) {
-        DBIngestor_error("DBMySQL - prepareMultiIngestStatement: could not allocate bind container.", NULL);
-    }
-    //zero the bind structure
-    memset(bind, 0, thisSchema->getNumActiveItems() * sizeof(MYSQL_BIND));
+    MYSQL_BIND *bind = allocBindArrays(stmtContainer, (int)thisSchema->getNumActiveItems());
 
     string query = "SELECT `";
     
@@ -768,8 +1061,6 @@ void * DBMySQL::initGetCompleteTable(DBDataSchema::Schema * thisSchema) {
         //fill the bind data with information about this
         bind[i].buffer_type = translateTypeToMYSQL(thisSchema->getArrSchemaItems().at(j)-> getColumnDBType());
         bind[i].is_unsigned = isUnsignedType(thisSchema->getArrSchemaItems().at(j)->getColumnDBType());
-        bind[i].is_null = 0;
-        bind[i].length = 0;
         
         i++;
     }
@@ -786,8 +1077,6 @@ void * DBMySQL::initGetCompleteTable(DBDataSchema::Schema * thisSchema) {
     }
     
     stmtContainer->stmt = statement;
-    stmtContainer->bind = bind;
-    stmtContainer->lenBind = (int)thisSchema->getNumActiveItems();
     
     return (void*)stmtContainer;
 }
@@ -799,6 +1088,8 @@ int DBMySQL::getNextRow(DBDataSchema::Schema * thisSchema, void* thisData, void
     
     MYSQL_prepStmt *statement = (MYSQL_prepStmt*) preparedStatement;
     
+    waitStmt();
+    
     if(statement->prepared == false) {
         if( mysql_stmt_execute(statement->stmt) != 0) {
             printf("DBMySQL: Error\n");
@@ -818,6 +1109,14 @@ int DBMySQL::getNextRow(DBDataSchema::Schema * thisSchema, void* thisData, void
     }
 
     if( mysql_stmt_fetch(statement->stmt) == 0) {
+        //the numbers have been fetched into the value slots of the binds
+        vector<DBDataSchema::ColumnPlan> & rowPlan = thisSchema->getRowPlan();
+        for(int i=0; i<rowPlan.size(); i++) {
+            if(rowPlan[i].dbType != DBDataSchema::DBT_CHAR) {
+                memcpy((char*)thisData + rowPlan[i].offset, statement->bind[i].buffer, rowPlan[i].byteLen);
+            }
+        }
+        
         return 1;
     } else {
         return 0;
@@ -973,6 +1272,22 @@ enum_field_types DBMySQL::translateTypeToMYSQL(DBDataSchema::DBType thisType) {
     return (enum_field_types)0;
 }
 
+bool DBMySQL::getArrayBinding() {
+    return arrayBinding;
+}
+
+void DBMySQL::setArrayBinding(bool newArrayBinding) {
+    arrayBinding = newArrayBinding;
+}
+
+bool DBMySQL::getAsyncExecution() {
+    return asyncExecution;
+}
+
+void DBMySQL::setAsyncExecution(bool newAsyncExecution) {
+    asyncExecution = newAsyncExecution;
+}
+
 int DBMySQL::isUnsignedType(DBDataSchema::DBType thisType) {
     switch (thisType) {
         case DBDataSchema::DBT_UBIGINT:
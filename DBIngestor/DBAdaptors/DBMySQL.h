@@ -44,7 +44,7 @@ namespace DBServer {
      with an MySQL database.
      */
     class DBMySQL : public DBAbstractor {
-    private:
+    protected:
         /*! \var MYSQL * dbHandler
          a pointer to the MYSQL db handler
          */
@@ -59,6 +59,38 @@ namespace DBServer {
 		int myNumElements;
 		int recCount;
 
+        /*! \var bool localInfile
+         if true, connect() allows LOAD DATA LOCAL INFILE on the connection
+         */
+        bool localInfile;
+
+        /*! \var bool arrayBinding
+         if true, multi row statements are single row statements executed against the columns of the buffer
+         (STMT_ATTR_ARRAY_SIZE), as long as the client library and the server support it
+         */
+        bool arrayBinding;
+
+        /*! \var bool asyncExecution
+         if true, executeStmtAsync() returns once the statement has been sent and the answer of the server is
+         collected before the next command, as long as the client library has a non-blocking API
+         */
+        bool asyncExecution;
+
+        /*! \var bool nonBlocking
+         true if the connection has been opened with MYSQL_OPT_NONBLOCK
+         */
+        bool nonBlocking;
+
+        /*! \var void * pendingStmt
+         the statement whose answer has not been collected yet, NULL if there is none
+         */
+        void * pendingStmt;
+
+        /*! \var int pendingStatus
+         what the non-blocking API of pendingStmt is waiting for
+         */
+        int pendingStatus;
+
         /*! \brief translates type on the server into DBType. 
          
          \param char * thisTypeString: a string returned by MySQL describing the column type
@@ -109,6 +141,11 @@ namespace DBServer {
          Disconnects from the database server. If the disconnect was successfull, this shall return 1, otherwise 0.*/
 		virtual int disconnect();
         
+        /*! \brief creates a new adaptor with the same configuration.
+         
+         \return returns a new, unconnected DBMySQL with the settings of this one*/
+        virtual DBAbstractor * createLike();
+        
         /*! \brief sets a new savepoint if supported by the DB engine. 
          
          \return returns 1 if successfull or 0 if not
@@ -233,6 +270,32 @@ namespace DBServer {
          void pointer array and is then cast according to the Schema. The length of the void pointer array has the same 
          size as Schema and needs to be of equal ordering!*/
         virtual int bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, bool* isNullArray, void* preparedStatement, int nInStmt);
+        
+        /*! \brief binds all rows of a batch to a prepared (multi row) statement
+         \param const RowBatch & thisBatch: the rows to bind
+         \param void* preparedStatement: a pointer to a prepared statement object
+         
+         \return returns 1 if successfull, 0 if not
+         
+         The binds of a statement, their lengths, NULL flags and value slots are laid out once when the statement is
+         prepared. Binding copies the values into the slots (strings into slots that grow with the longest string, with
+         the length taken from the string arena instead of strlen), so the statement is passed to mysql_stmt_bind_param
+         again only if a string slot had to grow. This is not zero-copy: the client library binds addresses, and the
+         strings of the buffer are at a new address in every row.*/
+        virtual int bindBatch(const RowBatch & thisBatch, void* preparedStatement);
+        
+        /*! \brief binds the columns of the buffer to a statement prepared for array binding
+         \param DBDataSchema::Schema * thisSchema: a valid Schema where the data should be inserted
+         \param void** columnData: for each column in the row plan, the array of its values
+         \param bool** isNullColumns: for each column in the row plan, the array of its NULL flags
+         \param void* preparedStatement: a pointer to a prepared statement object
+         \param int numRows: the number of rows to bind
+         
+         \return returns 1 if successfull, 0 if not
+         
+         Only used if array binding is enabled and supported. The column arrays and NULL flags of the buffer are bound
+         as they are, only the lengths of the strings are computed.*/
+        virtual int bindColumnsToStmt(DBDataSchema::Schema * thisSchema, void** columnData, bool** isNullColumns, void* preparedStatement, int numRows);
 
         /*! \brief executes the given statement.  
          \param void* preparedStatement: a pointer to a prepared statement object
@@ -242,6 +305,21 @@ namespace DBServer {
          Executes the given prepared statement.*/
         virtual int executeStmt(void* preparedStatement);        
         
+        /*! \brief starts executing the given statement.  
+         \param void* preparedStatement: a pointer to a prepared statement object
+         
+         \return returns 1 if successfull, 0 if not
+         
+         With asynchronous execution, the statement is sent with mysql_stmt_execute_start and the answer of the server is
+         collected by waitStmt(), which every other method calls before it uses the connection. Errors of the statement are
+         reported there. Otherwise (and in resume mode) this is executeStmt().*/
+        virtual int executeStmtAsync(void* preparedStatement);
+        
+        /*! \brief waits for the statement started by executeStmtAsync() and reports its errors
+         
+         \return returns 1 if successfull*/
+        virtual int waitStmt();
+        
         /*! \brief finalizes and releases a prepared statement.  
          \param void* preparedStatement: a pointer to a prepared statement object
          
@@ -267,6 +345,24 @@ namespace DBServer {
          
          \return returns 1 if successfull, 0 if end of table is reached*/
         virtual int getNextRow(DBDataSchema::Schema * thisSchema, void* thisData, void * preparedStatement);
+        
+        bool getArrayBinding();
+        
+        /*! \brief enables array binding (STMT_ATTR_ARRAY_SIZE of MariaDB Connector/C)
+         \param bool newArrayBinding: true to execute single row statements against whole columns
+         
+         Needs to be set before connecting. If the client library or the server lack bulk operations, the usual
+         multi row statements are used.*/
+        void setArrayBinding(bool newArrayBinding);
+        
+        bool getAsyncExecution();
+        
+        /*! \brief enables asynchronous execution with the non-blocking API of MariaDB Connector/C
+         \param bool newAsyncExecution: true to collect the answer of a statement while the next one is bound
+         
+         Needs to be set before connecting. If the client library has no non-blocking API, statements are executed
+         synchronously.*/
+        void setAsyncExecution(bool newAsyncExecution);
     };
 }
 #endif
@@ -0,0 +1,408 @@
+/*  
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>, 
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "DBMySQLLoadData.h"
+#include "SchemaItem.h"
+#include "dbingestor_error.h"
+#include "DBType.h"
+#include "DType.h"
+#include <errmsg.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <limits.h>
+#include <boost/format.hpp>
+#ifndef _WIN32
+#include <stdint.h>
+#else
+#include "stdint_win.h"
+#endif
+
+using namespace DBServer;
+using namespace std;
+
+//name of the "file" in the LOAD DATA statement, the local infile handler ignores it
+#define AING_MYSQL_LOADDATA_FILENAME "dbingestor_buffer"
+
+typedef struct {
+    string query;
+    string data;
+    size_t readPos;
+} MYSQL_loadStmt;
+
+//local infile handler, serves the text of the statement to the client library
+static int loadDataInit(void ** ptr, const char * filename, void * userdata) {
+    MYSQL_loadStmt * statement = (MYSQL_loadStmt*) userdata;
+    statement->readPos = 0;
+    *ptr = userdata;
+    
+    return 0;
+}
+
+static int loadDataRead(void * ptr, char * buf, unsigned int bufLen) {
+    MYSQL_loadStmt * statement = (MYSQL_loadStmt*) ptr;
+    size_t left = statement->data.size() - statement->readPos;
+    
+    if(left > bufLen) {
+        left = bufLen;
+    }
+    
+    memcpy(buf, statement->data.data() + statement->readPos, left);
+    statement->readPos += left;
+    
+    return (int)left;
+}
+
+static void loadDataEnd(void * ptr) {
+    
+}
+
+static int loadDataError(void * ptr, char * errorMsg, unsigned int errorMsgLen) {
+    snprintf(errorMsg, errorMsgLen, "DBMySQLLoadData: could not read the rows from the buffer");
+    
+    return CR_UNKNOWN_ERROR;
+}
+
+//appends a string, escaped for LOAD DATA with ESCAPED BY '\\'
+static void appendEscaped(string & data, const char * theString) {
+    const char * currChar = theString;
+    
+    while(*currChar != '\0') {
+        size_t lenPlain = strcspn(currChar, "\\\t\n\r");
+        data.append(currChar, lenPlain);
+        currChar += lenPlain;
+        
+        switch (*currChar) {
+            case '\\':
+                data.append("\\\\");
+                break;
+            case '\t':
+                data.append("\\t");
+                break;
+            case '\n':
+                data.append("\\n");
+                break;
+            case '\r':
+                data.append("\\r");
+                break;
+            default:
+                return;
+        }
+        
+        currChar++;
+    }
+}
+
+DBMySQLLoadData::DBMySQLLoadData() {
+    localInfile = true;
+    allowWarnings = false;
+}
+
+DBMySQLLoadData::~DBMySQLLoadData() {
+    
+}
+
+DBAbstractor * DBMySQLLoadData::createLike() {
+    DBMySQLLoadData * newMySQL = new DBMySQLLoadData();
+    
+    newMySQL->asyncExecution = asyncExecution;
+    newMySQL->allowWarnings = allowWarnings;
+    
+    return newMySQL;
+}
+
+bool DBMySQLLoadData::getAllowWarnings() {
+    return allowWarnings;
+}
+
+void DBMySQLLoadData::setAllowWarnings(bool newAllowWarnings) {
+    allowWarnings = newAllowWarnings;
+}
+
+void* DBMySQLLoadData::prepareIngestStatement(DBDataSchema::Schema * thisSchema) {
+    return prepareMultiIngestStatement(thisSchema, 1);
+}
+
+void* DBMySQLLoadData::prepareMultiIngestStatement(DBDataSchema::Schema * thisSchema, int numElements) {
+    assert(thisSchema != NULL);
+    assert(numElements > 0);
+    
+	myNumElements = numElements;
+	mySchema = thisSchema;
+    
+    MYSQL_loadStmt * statement = new MYSQL_loadStmt;
+    statement->readPos = 0;
+    
+    //construct query string, the columns are listed in the order of the row plan. BIT columns are read into a
+    //variable first, LOAD DATA would otherwise store the characters and not the number
+    vector<DBDataSchema::ColumnPlan> & rowPlan = thisSchema->getRowPlan();
+    string setClause = "";
+    
+    statement->query = "LOAD DATA LOCAL INFILE '" AING_MYSQL_LOADDATA_FILENAME "' INTO TABLE ";
+    statement->query.append(thisSchema->getDbName());
+    statement->query.append(".");
+    statement->query.append(thisSchema->getTableName());
+    //otherwise the server reads the text in character_set_database
+    statement->query.append(" CHARACTER SET ");
+    statement->query.append(mysql_character_set_name(dbHandler));
+    statement->query.append(" FIELDS TERMINATED BY '\\t' ESCAPED BY '\\\\' LINES TERMINATED BY '\\n' (");
+    
+    for(int i=0; i<rowPlan.size(); i++) {
+        DBDataSchema::DBType writeType = rowPlan[i].dbType;
+        if(writeType == DBDataSchema::DBT_ANY) {
+            writeType = DBDataSchema::convDTypeToDBType(rowPlan[i].dType);
+        }
+        
+        if(i != 0) {
+            statement->query.append(", ");
+        }
+        
+        if(writeType == DBDataSchema::DBT_BIT) {
+            string varName = boost::str(boost::format("@dbing_bit%d") % i);
+            statement->query.append(varName);
+            
+            setClause.append(setClause.size() == 0 ? " SET `" : ", `");
+            setClause.append(rowPlan[i].schemaItem->getColumnName());
+            setClause.append("` = CAST(");
+            setClause.append(varName);
+            setClause.append(" AS UNSIGNED)");
+        } else {
+            statement->query.append("`");
+            statement->query.append(rowPlan[i].schemaItem->getColumnName());
+            statement->query.append("`");
+        }
+    }
+    
+    statement->query.append(")");
+    statement->query.append(setClause);
+    
+    myquery = statement->query;
+    
+    return statement;
+}
+
+void DBMySQLLoadData::appendRow(vector<DBDataSchema::ColumnPlan> & rowPlan, char * currRow, bool* isNullArray, string & data) {
+    char numBuffer[64];
+    
+    for(int i=0; i<rowPlan.size(); i++) {
+        DBDataSchema::ColumnPlan & currCol = rowPlan[i];
+        char * currCell = currRow + currCol.offset;
+        
+        if(i != 0) {
+            data.push_back('\t');
+        }
+        
+        if(isNullArray != NULL && isNullArray[i] == 1) {
+            data.append("\\N");
+            continue;
+        }
+        
+        //DBT_ANY holds the value as it was read
+        DBDataSchema::DBType writeType = currCol.dbType;
+        if(writeType == DBDataSchema::DBT_ANY) {
+            writeType = DBDataSchema::convDTypeToDBType(currCol.dType);
+        }
+        
+        //floats are written with enough digits to read back the same value
+        switch (writeType) {
+            case DBDataSchema::DBT_CHAR:
+                if(*(char**)currCell == NULL) {
+                    data.append("\\N");
+                } else {
+                    appendEscaped(data, *(char**)currCell);
+                }
+                continue;
+            case DBDataSchema::DBT_BIT:
+            case DBDataSchema::DBT_TINYINT:
+                snprintf(numBuffer, sizeof(numBuffer), "%d", (int)*(int8_t*)currCell);
+                break;
+            case DBDataSchema::DBT_SMALLINT:
+                snprintf(numBuffer, sizeof(numBuffer), "%d", (int)*(int16_t*)currCell);
+                break;
+            case DBDataSchema::DBT_MEDIUMINT:
+            case DBDataSchema::DBT_INTEGER:
+                snprintf(numBuffer, sizeof(numBuffer), "%d", *(int32_t*)currCell);
+                break;
+            case DBDataSchema::DBT_BIGINT:
+                snprintf(numBuffer, sizeof(numBuffer), "%lld", (long long)*(int64_t*)currCell);
+                break;
+            case DBDataSchema::DBT_UTINYINT:
+                snprintf(numBuffer, sizeof(numBuffer), "%u", (unsigned int)*(uint8_t*)currCell);
+                break;
+            case DBDataSchema::DBT_USMALLINT:
+                snprintf(numBuffer, sizeof(numBuffer), "%u", (unsigned int)*(uint16_t*)currCell);
+                break;
+            case DBDataSchema::DBT_UMEDIUMINT:
+            case DBDataSchema::DBT_UINTEGER:
+                snprintf(numBuffer, sizeof(numBuffer), "%u", *(uint32_t*)currCell);
+                break;
+            case DBDataSchema::DBT_UBIGINT:
+                snprintf(numBuffer, sizeof(numBuffer), "%llu", (unsigned long long)*(uint64_t*)currCell);
+                break;
+            case DBDataSchema::DBT_FLOAT:
+            case DBDataSchema::DBT_UFLOAT:
+                snprintf(numBuffer, sizeof(numBuffer), "%.9g", (double)*(float*)currCell);
+                break;
+            case DBDataSchema::DBT_REAL:
+            case DBDataSchema::DBT_UREAL:
+                snprintf(numBuffer, sizeof(numBuffer), "%.17g", *(double*)currCell);
+                break;
+            default:
+                DBIngestor_error("DBMySQLLoadData: DBType not known, I don't know what to do.\n", NULL);
+        }
+        
+        data.append(numBuffer);
+    }
+    
+    data.push_back('\n');
+}
+
+int DBMySQLLoadData::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, void* preparedStatement, int nInStmt) {
+    assert(thisSchema != NULL);
+    assert(thisData != NULL);
+    assert(preparedStatement != NULL);
+    
+    MYSQL_loadStmt * statement = (MYSQL_loadStmt*) preparedStatement;
+    
+    if(nInStmt == 0) {
+        statement->data.clear();
+    }
+    
+    appendRow(thisSchema->getRowPlan(), (char*)thisData, NULL, statement->data);
+    
+    return 1;
+}
+
+int DBMySQLLoadData::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, bool* isNullArray, void* preparedStatement, int nInStmt) {
+    assert(thisSchema != NULL);
+    assert(thisData != NULL);
+    assert(isNullArray != NULL);
+    assert(preparedStatement != NULL);
+    
+    MYSQL_loadStmt * statement = (MYSQL_loadStmt*) preparedStatement;
+    
+    if(nInStmt == 0) {
+        statement->data.clear();
+    }
+    
+    appendRow(thisSchema->getRowPlan(), (char*)thisData, isNullArray, statement->data);
+    
+    return 1;
+}
+
+int DBMySQLLoadData::bindBatch(const RowBatch & thisBatch, void* preparedStatement) {
+    assert(thisBatch.schema != NULL);
+    assert(preparedStatement != NULL);
+    
+    MYSQL_loadStmt * statement = (MYSQL_loadStmt*) preparedStatement;
+    vector<DBDataSchema::ColumnPlan> & rowPlan = thisBatch.schema->getRowPlan();
+    
+    //the text is rewritten for every batch, invariant columns can not be skipped. the capacity of the
+    //string is kept, after the first buffer no memory is allocated anymore
+    statement->data.clear();
+    
+    for(int i=0; i<thisBatch.numRows; i++) {
+        appendRow(rowPlan, thisBatch.getRow(i), thisBatch.getIsNullRow(i), statement->data);
+    }
+    
+    return 1;
+}
+
+int DBMySQLLoadData::executeStmt(void* preparedStatement) {
+    recCount++;
+    
+	assert(preparedStatement != NULL);
+    MYSQL_loadStmt * statement = (MYSQL_loadStmt*) preparedStatement;
+    
+    waitStmt();
+    
+    //the handler is kept by the connection, it is set again since other statements may share the connection
+    mysql_set_local_infile_handler(dbHandler, loadDataInit, loadDataRead, loadDataEnd, loadDataError, statement);
+    
+    if(mysql_real_query(dbHandler, statement->query.c_str(), statement->query.size()) != 0) {
+        printf("DBMySQLLoadData: Error\n");
+        printf("ErrNr %u: %s\n", mysql_errno(dbHandler), mysql_error(dbHandler));
+        
+		if(resumeMode == true &&
+            (mysql_errno(dbHandler) == 12701 || 
+                mysql_errno(dbHandler) == 1317 || 
+                mysql_errno(dbHandler) == 2003) && 
+            recCount < 1500) {
+            
+            //the text stays in the statement and does not depend on the connection, just send it again
+            int err = executeStmt(preparedStatement);
+            
+            recCount--;
+            return err;
+		} else {
+			DBIngestor_error("DBMySQLLoadData - executeStmt: could not execute statement.\n", NULL);
+		}
+    }
+    
+    if(mysql_warning_count(dbHandler) != 0) {
+        printf("DBMySQLLoadData: %u warnings while loading into %s.%s (%s)\n", mysql_warning_count(dbHandler), 
+               mySchema->getDbName().c_str(), mySchema->getTableName().c_str(), mysql_info(dbHandler));
+        printWarnings();
+        
+        if(allowWarnings == false) {
+            DBIngestor_error("DBMySQLLoadData - executeStmt: rows have been skipped or altered by the server. Use setAllowWarnings to accept this.\n", NULL);
+        }
+    }
+    
+	recCount--;
+    return 1;
+}
+
+void DBMySQLLoadData::printWarnings() {
+    if(mysql_query(dbHandler, "SHOW WARNINGS LIMIT 10") != 0) {
+        return;
+    }
+    
+    MYSQL_RES *result = mysql_store_result(dbHandler);
+    
+    if(result == NULL) {
+        return;
+    }
+    
+    MYSQL_ROW row;
+    
+    //columns are Level, Code and Message
+    while((row = mysql_fetch_row(result))) {
+        printf("%s %s: %s\n", row[0], row[1], row[2]);
+    }
+    
+    mysql_free_result(result);
+}
+
+int DBMySQLLoadData::executeStmtAsync(void* preparedStatement) {
+    return executeStmt(preparedStatement);
+}
+
+int DBMySQLLoadData::finalizePreparedStatement(void* preparedStatement) {
+    assert(preparedStatement != NULL);
+    MYSQL_loadStmt * statement = (MYSQL_loadStmt*) preparedStatement;
+    
+    delete statement;
+    
+    return 1;
+}
+
+int DBMySQLLoadData::maxRowsPerStmt(DBDataSchema::Schema * thisSchema) {
+    return INT_MAX;
+}
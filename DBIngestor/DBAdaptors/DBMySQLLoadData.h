@@ -0,0 +1,145 @@
+/*  
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>, 
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file DBMySQLLoadData.h
+ \brief Bulk loading into MySQL with LOAD DATA LOCAL INFILE
+ 
+ This provides an implementation of DBAbstractor for MySQL that sends the rows
+ of a statement with LOAD DATA LOCAL INFILE instead of a prepared INSERT.
+ */
+
+#include "DBMySQL.h"
+
+#ifndef DBIngestor_DBMySQLLoadData_h
+#define DBIngestor_DBMySQLLoadData_h
+
+namespace DBServer {
+    
+    /*! \class DBMySQLLoadData
+     \brief DBMySQLLoadData communication class
+     
+     Instead of binding the rows to a prepared INSERT statement, the rows are written as tab separated
+     text into a memory buffer that belongs to the statement. On execution, a LOAD DATA LOCAL INFILE
+     statement is sent and the client library reads the "file" from this buffer through the local infile
+     handler, so no temporary file is involved. NULL values are written as \N, and backslashes, tabs, new
+     lines and carriage returns in strings are escaped with a backslash.
+     
+     Since there are no placeholders, a statement can hold a whole ingest buffer. Connections, savepoints and
+     the handling of keys are the ones of DBMySQL. The server needs to allow local_infile. The text is read in the
+     character set of the connection, as the values bound by DBMySQL are.
+     
+     With LOCAL, MySQL turns duplicate keys, truncations and conversion errors into warnings and skips or alters
+     the rows, where an INSERT would fail. Therefore any warning ends the ingest with an error (and the savepoint
+     is rolled back), unless warnings are explicitly allowed with setAllowWarnings().
+     */
+    class DBMySQLLoadData : public DBMySQL {
+    private:
+        /*! \var bool allowWarnings
+         if true, rows that MySQL skips or alters with a warning are accepted and the warnings are only printed
+         */
+        bool allowWarnings;
+
+        /*! \brief prints the warnings of the last statement
+         */
+        void printWarnings();
+
+        /*! \brief appends one row of the buffer as a line of tab separated text
+         \param std::vector<DBDataSchema::ColumnPlan> & rowPlan: the row plan of the schema
+         \param char * currRow: the row in the buffer
+         \param bool* isNullArray: NULL flag of each column, NULL if there are no NULLs
+         \param std::string & data: the text the line is appended to
+         */
+        void appendRow(std::vector<DBDataSchema::ColumnPlan> & rowPlan, char * currRow, bool* isNullArray, std::string & data);
+
+    public:
+        DBMySQLLoadData();
+        
+        ~DBMySQLLoadData();
+        
+        /*! \brief creates a new adaptor with the same configuration.
+         
+         \return returns a new, unconnected DBMySQLLoadData with the settings of this one*/
+        virtual DBAbstractor * createLike();
+        
+        bool getAllowWarnings();
+        
+        /*! \brief accepts rows that are skipped or altered with a warning
+         \param bool newAllowWarnings: if true, warnings are only printed, otherwise (the default) they end the ingest*/
+        void setAllowWarnings(bool newAllowWarnings);
+        
+        /*! \brief prepares a LOAD DATA LOCAL INFILE statement for a single row
+         \param DBDataSchema::Schema * thisSchema: the schema of the table
+         \return pointer to the statement container
+         */
+		virtual void* prepareIngestStatement(DBDataSchema::Schema * thisSchema);
+        
+        /*! \brief prepares a LOAD DATA LOCAL INFILE statement for numElements rows
+         \param DBDataSchema::Schema * thisSchema: the schema of the table
+         \param int numElements: number of rows that are loaded with each execution
+         \return pointer to the statement container
+         */
+        virtual void* prepareMultiIngestStatement(DBDataSchema::Schema * thisSchema, int numElements);
+        
+        /*! \brief writes a row as text into the statement, without NULLs
+         \param DBDataSchema::Schema * thisSchema: the schema of the table
+         \param void* thisData: the row in the buffer
+         \param void* preparedStatement: the statement container
+         \param int nInStmt: position of the row in the statement, 0 starts a new set of rows
+         \return returns 1 if successfull
+         */
+        virtual int bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, void* preparedStatement, int nInStmt);
+        
+        /*! \brief writes a row as text into the statement
+         \param DBDataSchema::Schema * thisSchema: the schema of the table
+         \param void* thisData: the row in the buffer
+         \param bool* isNullArray: NULL flag of each column
+         \param void* preparedStatement: the statement container
+         \param int nInStmt: position of the row in the statement, 0 starts a new set of rows
+         \return returns 1 if successfull
+         */
+        virtual int bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, bool* isNullArray, void* preparedStatement, int nInStmt);
+        
+        /*! \brief writes all rows of the batch as text into the statement
+         \param const RowBatch & thisBatch: the rows
+         \param void* preparedStatement: the statement container
+         \return returns 1 if successfull
+         */
+        virtual int bindBatch(const RowBatch & thisBatch, void* preparedStatement);
+        
+        /*! \brief sends the LOAD DATA LOCAL INFILE statement and streams the text from memory
+         \param void* preparedStatement: the statement container
+         \return returns 1 if successfull
+         */
+        virtual int executeStmt(void* preparedStatement);
+        
+        /*! \brief the local infile handler reads the rows while the statement runs, so it is always executed synchronously
+         */
+        virtual int executeStmtAsync(void* preparedStatement);
+        
+        virtual int finalizePreparedStatement(void* preparedStatement);
+        
+        /*! \brief there are no placeholders, the number of rows is only limited by the ingest buffer
+         */
+        virtual int maxRowsPerStmt(DBDataSchema::Schema * thisSchema);
+    };
+    
+}
+
+#endif
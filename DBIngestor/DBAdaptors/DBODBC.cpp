@@ -63,6 +63,11 @@ DBODBC::~DBODBC() {
     disconnect();
 }
 
+DBAbstractor * DBODBC::createLike() {
+    //the settings of the ODBC adaptors all come from the DSN
+    return new DBODBC();
+}
+
 int DBODBC::connect(string usr, string pwd, string host, string port, string socket) {
     //ONLY ACCEPT DSNs. Anything else will fail miserably
     SQLCHAR output[1024];
@@ -829,60 +834,47 @@ int DBODBC::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData,
     assert(preparedStatement != NULL);
     
     ODBC_prepStmt * prepStmt = (ODBC_prepStmt*) preparedStatement;
-    long byteCount = 0;
-    int stride = nInStmt * (int)thisSchema->getNumActiveItems();
+    std::vector<DBDataSchema::ColumnPlan> & rowPlan = thisSchema->getRowPlan();
+    int stride = nInStmt * (int)rowPlan.size();
     char * currRow = (char*)thisData;
     
     //bind data to the prepared statement
-    int i = 0;
-    for(int j=0; j<thisSchema->getArrSchemaItems().size(); j++) {
-        if(thisSchema->getArrSchemaItems().at(j)->getColumnName().compare(EMPTY_SCHEMAITEM_NAME) == 0) {
-            continue;
-        }
+    for(int i=0; i<rowPlan.size(); i++) {
+        DBDataSchema::ColumnPlan & currCol = rowPlan[i];
+        char * currCell = currRow + currCol.offset;
         
-        switch (thisSchema->getArrSchemaItems().at(j)->getColumnDBType()) {
+        switch (currCol.dbType) {
             case DBDataSchema::DBT_CHAR:
-                prepStmt->buffer[stride+i] = *(char**)(currRow+byteCount);    
-                prepStmt->parLenArray[stride+i] = strlen(*(char**)(currRow+byteCount)); //SQL_NTS;
-                byteCount += sizeof(char*);
+                prepStmt->buffer[stride+i] = *(char**)currCell;    
+                prepStmt->parLenArray[stride+i] = strlen(*(char**)currCell); //SQL_NTS;
                 break;
             case DBDataSchema::DBT_BIT:
-                prepStmt->buffer[stride+i] = (int8_t*)(currRow+byteCount);    
-                byteCount += sizeof(int8_t);
+                prepStmt->buffer[stride+i] = (int8_t*)currCell;    
                 break;
             case DBDataSchema::DBT_BIGINT:
-                prepStmt->buffer[stride+i] = (int64_t*)(currRow+byteCount);    
-                byteCount += sizeof(int64_t);
+                prepStmt->buffer[stride+i] = (int64_t*)currCell;    
                 break;
             case DBDataSchema::DBT_MEDIUMINT:
-                prepStmt->buffer[stride+i] = (int32_t*)(currRow+byteCount);    
-                byteCount += sizeof(int32_t);
+                prepStmt->buffer[stride+i] = (int32_t*)currCell;    
                 break;
             case DBDataSchema::DBT_INTEGER:
-                prepStmt->buffer[stride+i] = (int32_t*)(currRow+byteCount);    
-                byteCount += sizeof(int32_t);
+                prepStmt->buffer[stride+i] = (int32_t*)currCell;    
                 break;
             case DBDataSchema::DBT_SMALLINT:
-                prepStmt->buffer[stride+i] = (int16_t*)(currRow+byteCount);    
-                byteCount += sizeof(int16_t);
+                prepStmt->buffer[stride+i] = (int16_t*)currCell;    
                 break;
             case DBDataSchema::DBT_TINYINT:
-                prepStmt->buffer[stride+i] = (int8_t*)(currRow+byteCount);    
-                byteCount += sizeof(int8_t);
+                prepStmt->buffer[stride+i] = (int8_t*)currCell;    
                 break;
             case DBDataSchema::DBT_FLOAT:
-                prepStmt->buffer[stride+i] = (float*)(currRow+byteCount);    
-                byteCount += sizeof(float);
+                prepStmt->buffer[stride+i] = (float*)currCell;    
                 break;
             case DBDataSchema::DBT_REAL:
-                prepStmt->buffer[stride+i] = (double*)(currRow+byteCount);    
-                byteCount += sizeof(double);
+                prepStmt->buffer[stride+i] = (double*)currCell;    
                 break;
             default:
                 DBIngestor_error("DBODBC - bindOneRowToStmt: an error occured in bindOneRowToStmt in switch while binding\n", NULL);
         }
-        
-        i++;
     }
     
     return 1;
@@ -900,18 +892,12 @@ int DBODBC::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData,
     
     //now bind the NULLs
     ODBC_prepStmt * statement = (ODBC_prepStmt*) preparedStatement;
-    int stride = nInStmt * (int)thisSchema->getNumActiveItems();
+    int numCols = (int)thisSchema->getRowPlan().size();
+    int stride = nInStmt * numCols;
     
     //bind NULLs to the prepared statement
-    int i = 0;
-    for(int j=0; j<thisSchema->getArrSchemaItems().size(); j++) {
-        if(thisSchema->getArrSchemaItems().at(j)->getColumnName().compare(EMPTY_SCHEMAITEM_NAME) == 0) {
-            continue;
-        }
-        
+    for(int i=0; i<numCols; i++) {
         statement->isNullArray[stride+i] = isNullArray[i];
-        
-        i++;
     }
     
     return 1;
@@ -1005,13 +991,18 @@ int DBODBC::finalizePreparedStatement(void* preparedStatement) {
 }
 
 int DBODBC::maxRowsPerStmt(DBDataSchema::Schema * thisSchema) {
-    float numRows;
+    //most servers accept up to 65535 parameter markers per statement
+    float numRows = 65535.0 / thisSchema->getArrSchemaItems().size();
     
     //2100 magic number for MS SQL Server //apparently it is smaller...
     if(dbServerName.find("Microsoft") != dbServerName.npos) {
         numRows = 1024.0 / thisSchema->getArrSchemaItems().size();
     }
     
+    if(numRows < 1.0) {
+        numRows = 1.0;
+    }
+    
     return (int)numRows;
 }
 
@@ -145,6 +145,11 @@ namespace DBServer {
          Disconnects from the database server. If the disconnect was successfull, this shall return 1, otherwise 0.*/
 		virtual int disconnect();
         
+        /*! \brief creates a new adaptor with the same configuration.
+         
+         \return returns a new, unconnected DBODBC with the settings of this one*/
+        virtual DBAbstractor * createLike();
+        
         /*! \brief sets a new savepoint if supported by the DB engine. 
          
          \return returns 1 if successfull or 0 if not
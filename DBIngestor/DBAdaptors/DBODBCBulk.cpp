@@ -56,12 +56,18 @@ typedef struct {
 DBODBCBulk::DBODBCBulk() {
     odbcEnv = SQL_NULL_HENV;
     odbcDbc = SQL_NULL_HDBC;
+    supportsColumnBinding = true;
 }
 
 DBODBCBulk::~DBODBCBulk() {
     disconnect();
 }
 
+DBAbstractor * DBODBCBulk::createLike() {
+    //the settings of the ODBC adaptors all come from the DSN
+    return new DBODBCBulk();
+}
+
 int DBODBCBulk::connect(string usr, string pwd, string host, string port, string socket) {
     //ONLY ACCEPT DSNs. Anything else will fail miserably
     SQLCHAR output[1024];
@@ -668,51 +674,46 @@ int DBODBCBulk::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisDa
     assert(preparedStatement != NULL);
     
     ODBC_prepStmt * prepStmt = (ODBC_prepStmt*) preparedStatement;
-    long byteCount = 0;
+    vector<DBDataSchema::ColumnPlan> & rowPlan = thisSchema->getRowPlan();
     char * currRow = (char*)thisData;
     
     //bind data to the prepared statement
-    for(int i=0; i<thisSchema->getNumActiveItems(); i++) {
+    for(int i=0; i<rowPlan.size(); i++) {
+        char * currCell = currRow + rowPlan[i].offset;
+        
         switch (prepStmt->type[i]) {
             case DBDataSchema::DBT_BIT: {
                 SQLCHAR* arr = (SQLCHAR*)prepStmt->buffer[i];
-                arr[nInStmt] = (SQLCHAR)(*(int8_t*)(currRow+byteCount));    
-                byteCount += sizeof(int8_t);}
+                arr[nInStmt] = (SQLCHAR)(*(int8_t*)currCell);}
                 break;
             case DBDataSchema::DBT_BIGINT: {
                 SQLBIGINT* arr = (SQLBIGINT*)prepStmt->buffer[i];
-                arr[nInStmt] = (SQLBIGINT)(*(int64_t*)(currRow+byteCount));    
-                byteCount += sizeof(int64_t);}
+                arr[nInStmt] = (SQLBIGINT)(*(int64_t*)currCell);}
                 break;
             case DBDataSchema::DBT_MEDIUMINT: {
                 SQLINTEGER* arr = (SQLINTEGER*)prepStmt->buffer[i];
-                arr[nInStmt] = (SQLINTEGER)(*(int32_t*)(currRow+byteCount));    
-                byteCount += sizeof(int32_t);}
+                arr[nInStmt] = (SQLINTEGER)(*(int32_t*)currCell);}
                 break;
             case DBDataSchema::DBT_INTEGER: {
                 SQLINTEGER* arr = (SQLINTEGER*)prepStmt->buffer[i];
-                arr[nInStmt] = (SQLINTEGER)(*(int32_t*)(currRow+byteCount));    
-                byteCount += sizeof(int32_t);}
+                arr[nInStmt] = (SQLINTEGER)(*(int32_t*)currCell);}
                 break;
             case DBDataSchema::DBT_SMALLINT: {
                 SQLSMALLINT* arr = (SQLSMALLINT*)prepStmt->buffer[i];
-                arr[nInStmt] = (SQLSMALLINT)(*(int16_t*)(currRow+byteCount));    
-                byteCount += sizeof(int16_t);}
+                arr[nInStmt] = (SQLSMALLINT)(*(int16_t*)currCell);}
                 break;
             case DBDataSchema::DBT_TINYINT: {
                 SQLCHAR* arr = (SQLCHAR*)prepStmt->buffer[i];
-                arr[nInStmt] = (SQLCHAR)(*(int8_t*)(currRow+byteCount));    
-                byteCount += sizeof(int8_t);}
+                arr[nInStmt] = (SQLCHAR)(*(int8_t*)currCell);}
                 break;
             case DBDataSchema::DBT_FLOAT: {
                 SQLREAL* arr = (SQLREAL*)prepStmt->buffer[i];
-                arr[nInStmt] = (SQLREAL)(*(float*)(currRow+byteCount));    
-                byteCount += sizeof(float);}
+                arr[nInStmt] = (SQLREAL)(*(float*)currCell);}
                 break;
             case DBDataSchema::DBT_REAL: {
                 SQLDOUBLE* arr = (SQLDOUBLE*)prepStmt->buffer[i];
-                arr[nInStmt] = (SQLDOUBLE)(*(double*)(currRow+byteCount));    
-                byteCount += sizeof(double);}
+                arr[nInStmt] = (SQLDOUBLE)(*(double*)currCell);}
+                break;
             default:
                 DBIngestor_error("DBODBCBulk - bindOneRowToStmt: an error occured in bindOneRowToStmt in switch while binding\n", NULL);
         }
@@ -728,6 +729,51 @@ int DBODBCBulk::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisDa
     return 1;
 }
 
+int DBODBCBulk::bindColumnsToStmt(DBDataSchema::Schema * thisSchema, void** columnData, bool** isNullColumns, void* preparedStatement, int numRows) {
+    assert(thisSchema != NULL);
+    assert(columnData != NULL);
+    assert(preparedStatement != NULL);
+    
+    ODBC_prepStmt * prepStmt = (ODBC_prepStmt*) preparedStatement;
+    vector<DBDataSchema::ColumnPlan> & rowPlan = thisSchema->getRowPlan();
+    
+    if(numRows > prepStmt->size) {
+        DBIngestor_error("DBODBCBulk - bindColumnsToStmt: more rows than the statement holds\n", NULL);
+    }
+    
+    //bind data to the prepared statement
+    for(int i=0; i<rowPlan.size(); i++) {
+        switch (prepStmt->type[i]) {
+            case DBDataSchema::DBT_BIT:
+            case DBDataSchema::DBT_TINYINT:
+                assert(rowPlan[i].byteLen == sizeof(SQLCHAR));
+                break;
+            case DBDataSchema::DBT_BIGINT:
+                assert(rowPlan[i].byteLen == sizeof(SQLBIGINT));
+                break;
+            case DBDataSchema::DBT_MEDIUMINT:
+            case DBDataSchema::DBT_INTEGER:
+                assert(rowPlan[i].byteLen == sizeof(SQLINTEGER));
+                break;
+            case DBDataSchema::DBT_SMALLINT:
+                assert(rowPlan[i].byteLen == sizeof(SQLSMALLINT));
+                break;
+            case DBDataSchema::DBT_FLOAT:
+                assert(rowPlan[i].byteLen == sizeof(SQLREAL));
+                break;
+            case DBDataSchema::DBT_REAL:
+                assert(rowPlan[i].byteLen == sizeof(SQLDOUBLE));
+                break;
+            default:
+                DBIngestor_error("DBODBCBulk - bindColumnsToStmt: an error occured in bindColumnsToStmt in switch while binding\n", NULL);
+        }
+        
+        memcpy(prepStmt->buffer[i], columnData[i], (size_t)numRows * rowPlan[i].byteLen);
+    }
+    
+    return 1;
+}
+
 int DBODBCBulk::executeStmt(void* preparedStatement) {
     assert(preparedStatement != NULL);
     SQLRETURN result;
@@ -762,7 +808,8 @@ int DBODBCBulk::finalizePreparedStatement(void* preparedStatement) {
 }
 
 int DBODBCBulk::maxRowsPerStmt(DBDataSchema::Schema * thisSchema) {
-    float numRows;
+    //the rows are bound as parameter arrays, so the number of columns does not matter
+    float numRows = 10000;
     
     //2100 magic number for MS SQL Server
     if(dbServerName.find("Microsoft") != dbServerName.npos) {
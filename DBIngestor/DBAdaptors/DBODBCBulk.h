@@ -149,6 +149,11 @@ namespace DBServer {
          Disconnects from the database server. If the disconnect was successfull, this shall return 1, otherwise 0.*/
 		virtual int disconnect();
         
+        /*! \brief creates a new adaptor with the same configuration.
+         
+         \return returns a new, unconnected DBODBCBulk with the settings of this one*/
+        virtual DBAbstractor * createLike();
+        
         /*! \brief sets a new savepoint if supported by the DB engine. 
          
          \return returns 1 if successfull or 0 if not
@@ -278,6 +283,19 @@ namespace DBServer {
          size as Schema and needs to be of equal ordering!*/
         virtual int bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, bool* isNullArray, void* preparedStatement, int nInStmt);
 
+        /*! \brief binds whole columns to a prepared statement (works as well for multi statements).  
+         \param DBDataSchema::Schema * thisSchema: a valid Schema where the data should be inserted
+         \param void** columnData: for each column, the array of its values
+         \param bool** isNullColumns: for each column, the array of flags whether the value is null or not
+         \param void* preparedStatement: a pointer to a prepared statement object
+         \param int numRows: the number of rows to bind
+         
+         \return returns 1 if successfull, 0 if not
+         
+         The values are copied into the column arrays of the statement in one go, since they have the same
+         layout as the ODBC types they are bound with.*/
+        virtual int bindColumnsToStmt(DBDataSchema::Schema * thisSchema, void** columnData, bool** isNullColumns, void* preparedStatement, int numRows);
+
         /*! \brief executes the given statement.  
          \param void* preparedStatement: a pointer to a prepared statement object
          
@@ -25,6 +25,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <boost/format.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 #ifndef _WIN32
 #include <stdint.h>
 #else
@@ -39,6 +40,14 @@ using namespace std;
 
 DBSqlite3::DBSqlite3() {
     dbHandler = NULL;
+    //the first connection writing keeps the file locked until its transaction ends
+    supportsConcurrentWriters = false;
+    //dropped indexes are rebuilt before every commit
+    keepsKeysDisabledOnCommit = false;
+    cacheSize = 0;
+    pageSize = 0;
+    exclusiveLocking = false;
+    mmapSize = 0;
 }
 
 DBSqlite3::~DBSqlite3() {
@@ -47,6 +56,115 @@ DBSqlite3::~DBSqlite3() {
     }
 }
 
+void DBSqlite3::setBulkProfile() {
+    //MEMORY instead of OFF keeps the savepoints working, so a failed ingest can still be rolled back
+    journalMode = "MEMORY";
+    synchronous = "OFF";
+    cacheSize = -262144;
+    pageSize = 65536;
+    exclusiveLocking = true;
+    tempStore = "MEMORY";
+    mmapSize = 268435456;
+}
+
+string DBSqlite3::getJournalMode() {
+    return journalMode;
+}
+
+void DBSqlite3::setJournalMode(string newJournalMode) {
+    journalMode = newJournalMode;
+}
+
+string DBSqlite3::getSynchronous() {
+    return synchronous;
+}
+
+void DBSqlite3::setSynchronous(string newSynchronous) {
+    synchronous = newSynchronous;
+}
+
+int64_t DBSqlite3::getCacheSize() {
+    return cacheSize;
+}
+
+void DBSqlite3::setCacheSize(int64_t newCacheSize) {
+    cacheSize = newCacheSize;
+}
+
+int DBSqlite3::getPageSize() {
+    return pageSize;
+}
+
+void DBSqlite3::setPageSize(int newPageSize) {
+    pageSize = newPageSize;
+}
+
+bool DBSqlite3::getExclusiveLocking() {
+    return exclusiveLocking;
+}
+
+void DBSqlite3::setExclusiveLocking(bool newExclusiveLocking) {
+    exclusiveLocking = newExclusiveLocking;
+}
+
+string DBSqlite3::getTempStore() {
+    return tempStore;
+}
+
+void DBSqlite3::setTempStore(string newTempStore) {
+    tempStore = newTempStore;
+}
+
+int64_t DBSqlite3::getMmapSize() {
+    return mmapSize;
+}
+
+void DBSqlite3::setMmapSize(int64_t newMmapSize) {
+    mmapSize = newMmapSize;
+}
+
+string DBSqlite3::execPragma(string pragma) {
+    sqlite3_stmt *statement;
+    int err;
+    string result;
+    
+    string queryString = "PRAGMA " + pragma;
+    
+    err = sqlite3_prepare_v2(dbHandler, queryString.c_str(), -1, &statement, NULL);
+    
+    if(err == SQLITE_OK) {
+        while((err = sqlite3_step(statement)) == SQLITE_ROW) {
+            if(sqlite3_column_text(statement, 0) != NULL) {
+                result = (char*)sqlite3_column_text(statement, 0);
+            }
+        }
+        
+        sqlite3_finalize(statement);
+    }
+    
+    if(err != SQLITE_OK && err != SQLITE_DONE) {
+        printf("PRAGMA %s: %s\n", pragma.c_str(), sqlite3_errmsg(dbHandler));
+        sqlite3_close(dbHandler);
+        DBIngestor_error("DBSqlite3: could not set PRAGMA\n", NULL);
+    }
+    
+    return result;
+}
+
+DBAbstractor * DBSqlite3::createLike() {
+    DBSqlite3 * newSqlite = new DBSqlite3();
+    
+    newSqlite->journalMode = journalMode;
+    newSqlite->synchronous = synchronous;
+    newSqlite->cacheSize = cacheSize;
+    newSqlite->pageSize = pageSize;
+    newSqlite->exclusiveLocking = exclusiveLocking;
+    newSqlite->tempStore = tempStore;
+    newSqlite->mmapSize = mmapSize;
+    
+    return newSqlite;
+}
+
 int DBSqlite3::connect(string usr, string pwd, string host, string port, string socket) {
     int err;
     
@@ -56,6 +174,41 @@ int DBSqlite3::connect(string usr, string pwd, string host, string port, string
         DBIngestor_error("DBSqlite3: could not open a connection to the SQLite3 database\n", NULL);
     }
     
+    //wait for other processes holding a lock on the file instead of failing right away
+    sqlite3_busy_timeout(dbHandler, 60000);
+    
+    //the page size needs to be set before anything is written to a new file, including the journal mode
+    if(pageSize > 0) {
+        execPragma((boost::format("page_size=%i") % pageSize).str());
+    }
+    
+    if(journalMode.size() > 0) {
+        string currMode = execPragma("journal_mode=" + journalMode);
+        if(boost::algorithm::iequals(currMode, journalMode) == false) {
+            printf("DBSqlite3: journal_mode %s could not be set, using %s\n", journalMode.c_str(), currMode.c_str());
+        }
+    }
+    
+    if(synchronous.size() > 0) {
+        execPragma("synchronous=" + synchronous);
+    }
+    
+    if(cacheSize != 0) {
+        execPragma((boost::format("cache_size=%lld") % (long long)cacheSize).str());
+    }
+    
+    if(exclusiveLocking == true) {
+        execPragma("locking_mode=EXCLUSIVE");
+    }
+    
+    if(tempStore.size() > 0) {
+        execPragma("temp_store=" + tempStore);
+    }
+    
+    if(mmapSize != 0) {
+        execPragma((boost::format("mmap_size=%lld") % (long long)mmapSize).str());
+    }
+    
     isConnected = true;
     
     return 1;
@@ -105,6 +258,15 @@ int DBSqlite3::releaseSavepoint() {
     int err;
     
     if(resumeMode == false) {
+        //a dropped index must never be committed, rebuild them if the ingest commits in between
+        if(droppedIndexes.size() > 0) {
+            printf("DBSqlite3: committing before the end of the ingest, rebuilding the dropped indexes first\n");
+            
+            while(droppedIndexes.size() > 0) {
+                rebuildIndexes(droppedIndexes.begin()->first);
+            }
+        }
+        
         err = sqlite3_exec(dbHandler, "RELEASE SAVEPOINT dbIngst_sqlite_sp", NULL, NULL, NULL);
         
         if(err != SQLITE_OK) {
@@ -118,10 +280,100 @@ int DBSqlite3::releaseSavepoint() {
 }
 
 int DBSqlite3::disableKeys(DBDataSchema::Schema * thisSchema) {
+    sqlite3_stmt *statement;
+    int err;
+    vector<pair<string, string> > indexes;
+    string table = thisSchema->getTableName();
+    
+    //the CREATE statements are only kept in memory. if the drop was committed and the ingest failed
+    //afterwards, the indexes would be lost
+    if(sqlite3_get_autocommit(dbHandler) != 0) {
+        printf("DBSqlite3: indexes are only dropped inside a transaction, keeping the indexes on %s\n", table.c_str());
+        return 1;
+    }
+    
+    //indexes of PRIMARY KEY and UNIQUE constraints have no sql and cannot be dropped
+    err = sqlite3_prepare_v2(dbHandler, "SELECT name, sql FROM sqlite_master WHERE type = 'index' AND tbl_name = ?1 AND sql IS NOT NULL", -1, &statement, NULL);
+    
+    if(err != SQLITE_OK) {
+        printf("%s\n", sqlite3_errmsg(dbHandler));
+        sqlite3_close(dbHandler);
+        DBIngestor_error("DBSqlite3 - disableKeys: could not retrieve the indexes of the table\n", NULL);
+    }
+    
+    sqlite3_bind_text(statement, 1, table.c_str(), -1, SQLITE_TRANSIENT);
+    
+    while(sqlite3_step(statement) == SQLITE_ROW) {
+        indexes.push_back(make_pair(string((char*)sqlite3_column_text(statement, 0)), string((char*)sqlite3_column_text(statement, 1))));
+    }
+    
+    sqlite3_finalize(statement);
+    
+    for(size_t i=0; i<indexes.size(); i++) {
+        string dropIndex = "DROP INDEX \"" + indexes[i].first + "\"";
+        
+        err = sqlite3_exec(dbHandler, dropIndex.c_str(), NULL, NULL, NULL);
+        
+        if(err != SQLITE_OK) {
+            printf("%s\n", sqlite3_errmsg(dbHandler));
+            sqlite3_close(dbHandler);
+            DBIngestor_error("DBSqlite3 - disableKeys: could not drop index\n", NULL);
+        }
+        
+        printf("DBSqlite3: dropped index %s, it is rebuilt after the ingest with: %s\n", indexes[i].first.c_str(), indexes[i].second.c_str());
+        
+        droppedIndexes[table].push_back(indexes[i]);
+    }
+    
     return 1;
 }
 
 int DBSqlite3::enableKeys(DBDataSchema::Schema * thisSchema) {
+    return rebuildIndexes(thisSchema->getTableName());
+}
+
+int DBSqlite3::rebuildIndexes(string table) {
+    sqlite3_stmt *statement;
+    int err;
+    
+    map<string, vector<pair<string, string> > >::iterator currTable = droppedIndexes.find(table);
+    
+    if(currTable == droppedIndexes.end()) {
+        return 1;
+    }
+    
+    err = sqlite3_prepare_v2(dbHandler, "SELECT 1 FROM sqlite_master WHERE type = 'index' AND name = ?1", -1, &statement, NULL);
+    
+    if(err != SQLITE_OK) {
+        printf("%s\n", sqlite3_errmsg(dbHandler));
+        sqlite3_close(dbHandler);
+        DBIngestor_error("DBSqlite3 - rebuildIndexes: could not retrieve the indexes of the table\n", NULL);
+    }
+    
+    for(size_t i=0; i<currTable->second.size(); i++) {
+        sqlite3_reset(statement);
+        sqlite3_bind_text(statement, 1, currTable->second[i].first.c_str(), -1, SQLITE_TRANSIENT);
+        
+        if(sqlite3_step(statement) == SQLITE_ROW) {
+            continue;
+        }
+        
+        err = sqlite3_exec(dbHandler, currTable->second[i].second.c_str(), NULL, NULL, NULL);
+        
+        if(err != SQLITE_OK) {
+            printf("%s\n", sqlite3_errmsg(dbHandler));
+            sqlite3_finalize(statement);
+            sqlite3_close(dbHandler);
+            DBIngestor_error("DBSqlite3 - rebuildIndexes: could not recreate index\n", NULL);
+        }
+        
+        printf("DBSqlite3: rebuilt index %s on %s\n", currTable->second[i].first.c_str(), table.c_str());
+    }
+    
+    sqlite3_finalize(statement);
+    
+    droppedIndexes.erase(currTable);
+    
     return 1;
 }
 
@@ -346,115 +598,161 @@ int DBSqlite3::insertOneRow(DBDataSchema::Schema * thisSchema, void** thisData,
 }
 
 int DBSqlite3::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, void* preparedStatement, int nInStmt) {
+    
+    return bindOneRowToStmt(thisSchema, thisData, NULL, preparedStatement, nInStmt);
+}
+
+int DBSqlite3::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, bool* isNullArray, void* preparedStatement, int nInStmt) {
     assert(thisSchema != NULL);
     assert(thisData != NULL);
     assert(preparedStatement != NULL);
     
     int err;
     sqlite3_stmt *statement = (sqlite3_stmt*) preparedStatement;
-    long byteCount = 0;
-    int stride = nInStmt * (int)thisSchema->getNumActiveItems();
+    vector<DBDataSchema::ColumnPlan> & rowPlan = thisSchema->getRowPlan();
+    int stride = nInStmt * (int)rowPlan.size();
     char * currRow = (char*)thisData;
     
     //bind data to the prepared statement
-    int i = 0;
-    for(int j=0; j<thisSchema->getArrSchemaItems().size(); j++) {
-        if(thisSchema->getArrSchemaItems().at(j)->getColumnName().compare(EMPTY_SCHEMAITEM_NAME) == 0) {
-            continue;
-        }
-
-        DBDataSchema::DataObjDesc * currObj = thisSchema->getArrSchemaItems().at(j)->getDataDesc();        
-        unsigned long strLen;
-        char * theString;
-        int8_t tmpVal3;
-        int16_t tmpVal;
-        float tmpVal2;
-        int8_t tmpVal4;
-        int16_t tmpVal5;
-        int32_t tmpVal6;
-        int64_t tmpVal7;
+    for(int i=0; i<rowPlan.size(); i++) {
+        DBDataSchema::ColumnPlan & currCol = rowPlan[i];
         
-        switch (currObj->getDataObjDType()) {
-            case DBDataSchema::DT_STRING:
-                theString = *(char**)(currRow+byteCount);
-                strLen = strlen(theString);
-                err = sqlite3_bind_text(statement, stride+i+1, theString, (int)strLen, SQLITE_TRANSIENT);
-                byteCount += strLen + 1;
-                break;
-            case DBDataSchema::DT_INT1:
-                //for safety in the cast below
-                memcpy(&tmpVal3, (int8_t*)(currRow+byteCount), sizeof(int8_t));
-                err = sqlite3_bind_int(statement, stride+i+1, (int)tmpVal3);
-                byteCount += sizeof(int8_t);
-                break;
-            case DBDataSchema::DT_INT2:
-                //for safety in the cast below
-                memcpy(&tmpVal, (int16_t*)(currRow+byteCount), sizeof(int16_t));
-                err = sqlite3_bind_int(statement, stride+i+1, (int)tmpVal);
-                byteCount += sizeof(int16_t);
-                break;
-            case DBDataSchema::DT_INT4:
-                err = sqlite3_bind_int(statement, stride+i+1, *(int32_t*)(currRow+byteCount));
-                byteCount += sizeof(int32_t);
-                break;
-            case DBDataSchema::DT_INT8:
-                err = sqlite3_bind_int64(statement, stride+i+1, *(int64_t*)(currRow+byteCount));
-                byteCount += sizeof(int64_t);
-                break;
-            // Sqlite3 has troubles with unsigned stuff... casting to signed type... THIS IS A LIMITATION!
-            case DBDataSchema::DT_UINT1:
-                //for safety in the cast below
-                memcpy(&tmpVal4, (uint8_t*)(currRow+byteCount), sizeof(uint8_t));
-                err = sqlite3_bind_int(statement, stride+i+1, (int)tmpVal4);
-                byteCount += sizeof(uint8_t);
-                break;
-            case DBDataSchema::DT_UINT2:
-                //for safety in the cast below
-                memcpy(&tmpVal5, (uint16_t*)(currRow+byteCount), sizeof(uint16_t));
-                err = sqlite3_bind_int(statement, stride+i+1, (int)tmpVal5);
-                byteCount += sizeof(uint16_t);
-                break;
-            case DBDataSchema::DT_UINT4:
-                //for safety in the cast below
-                memcpy(&tmpVal6, (uint32_t*)(currRow+byteCount), sizeof(uint32_t));
-                err = sqlite3_bind_int(statement, stride+i+1, (int)tmpVal6);
-                byteCount += sizeof(uint32_t);
-                break;
-            case DBDataSchema::DT_UINT8:
-                //for safety in the cast below
-                memcpy(&tmpVal7, (uint64_t*)(currRow+byteCount), sizeof(uint64_t));
-                err = sqlite3_bind_int64(statement, stride+i+1, (int64_t)tmpVal7);
-                byteCount += sizeof(uint64_t);
-                break;
-            case DBDataSchema::DT_REAL4:
-                //for safety in the cast below
-                memcpy(&tmpVal2, (float*)(currRow+byteCount), sizeof(float));
-                err = sqlite3_bind_double(statement, stride+i+1, (double)tmpVal2);
-                byteCount += sizeof(float);
-                break;
-            case DBDataSchema::DT_REAL8:
-                err = sqlite3_bind_double(statement, stride+i+1, *(double*)(currRow+byteCount));
-                byteCount += sizeof(double);
-                break;
-            default:
-                sqlite3_close(dbHandler);
-                DBIngestor_error("DBSqlite3 - bindOneRowToStmt: an error occured in bindOneRowToStmt in switch while binding\n", NULL);
+        if(isNullArray != NULL && isNullArray[i] == true) {
+            err = sqlite3_bind_null(statement, stride+i+1);
+        } else {
+            //DBT_ANY holds the value as it was read
+            DBDataSchema::DBType bindType = currCol.dbType;
+            if(bindType == DBDataSchema::DBT_ANY) {
+                bindType = DBDataSchema::convDTypeToDBType(currCol.dType);
+            }
+            
+            err = bindValue(statement, stride+i+1, bindType, currRow + currCol.offset, SQLITE_TRANSIENT);
         }
         
         if(err != SQLITE_OK) {
             sqlite3_close(dbHandler);
             DBIngestor_error("DBSqlite3 - bindOneRowToStmt: an error occured in bindOneRowToStmt while binding\n", NULL);
         }
+    }
+    
+    return 1;
+}
+
+int DBSqlite3::bindBatch(const RowBatch & thisBatch, void* preparedStatement) {
+    assert(thisBatch.rows != NULL);
+    assert(preparedStatement != NULL);
+    
+    int err;
+    sqlite3_stmt *statement = (sqlite3_stmt*) preparedStatement;
+    
+    //resolve the types once for the whole batch
+    vector<DBDataSchema::DBType> bindTypes(thisBatch.numCols);
+    vector<sqlite3_destructor_type> stringDestructors(thisBatch.numCols);
+    vector<bool> skipCols(thisBatch.numCols);
+    for(int i=0; i<thisBatch.numCols; i++) {
+        //DBT_ANY holds the value as it was read
+        bindTypes[i] = thisBatch.rowPlan[i].dbType;
+        if(bindTypes[i] == DBDataSchema::DBT_ANY) {
+            bindTypes[i] = DBDataSchema::convDTypeToDBType(thisBatch.rowPlan[i].dType);
+        }
         
-        i++;
+        //the batch stays valid until the statement is executed, strings need not be copied. the values of
+        //invariant columns stay bound across executions (sqlite3_reset keeps the bindings), they are copied
+        //and only bound once per statement
+        stringDestructors[i] = SQLITE_STATIC;
+        skipCols[i] = false;
+        if(thisBatch.rowPlan[i].isInvariant == true) {
+            stringDestructors[i] = SQLITE_TRANSIENT;
+            skipCols[i] = thisBatch.skipInvariant;
+        }
+    }
+    
+    int paramId = 1;
+    for(int j=0; j<thisBatch.numRows; j++) {
+        char * currRow = thisBatch.getRow(j);
+        bool * currIsNull = thisBatch.getIsNullRow(j);
+        
+        for(int i=0; i<thisBatch.numCols; i++) {
+            if(skipCols[i] == true) {
+                err = SQLITE_OK;
+            } else if(currIsNull[i] == true) {
+                err = sqlite3_bind_null(statement, paramId);
+            } else {
+                err = bindValue(statement, paramId, bindTypes[i], currRow + thisBatch.rowPlan[i].offset, stringDestructors[i]);
+            }
+            
+            if(err != SQLITE_OK) {
+                sqlite3_close(dbHandler);
+                DBIngestor_error("DBSqlite3 - bindBatch: an error occured in bindBatch while binding\n", NULL);
+            }
+            
+            paramId++;
+        }
     }
     
     return 1;
 }
 
-int DBSqlite3::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, bool* isNullArray, void* preparedStatement, int nInStmt) {
+int DBSqlite3::bindValue(sqlite3_stmt * statement, int paramId, DBDataSchema::DBType bindType, char * currCell, sqlite3_destructor_type stringDestructor) {
+    int8_t tmpVal3;
+    int16_t tmpVal;
+    int32_t tmpVal6;
+    int64_t tmpVal7;
+    uint8_t tmpVal4;
+    uint16_t tmpVal5;
+    uint32_t tmpVal8;
+    uint64_t tmpVal9;
+    float tmpVal2;
+    double tmpVal10;
+    char * theString;
+    
+    switch (bindType) {
+        case DBDataSchema::DBT_CHAR:
+            memcpy(&theString, currCell, sizeof(char*));
+            return sqlite3_bind_text(statement, paramId, theString, -1, stringDestructor);
+        case DBDataSchema::DBT_BIT:
+        case DBDataSchema::DBT_TINYINT:
+            //for safety in the cast below
+            memcpy(&tmpVal3, currCell, sizeof(int8_t));
+            return sqlite3_bind_int(statement, paramId, (int)tmpVal3);
+        case DBDataSchema::DBT_SMALLINT:
+            memcpy(&tmpVal, currCell, sizeof(int16_t));
+            return sqlite3_bind_int(statement, paramId, (int)tmpVal);
+        case DBDataSchema::DBT_MEDIUMINT:
+        case DBDataSchema::DBT_INTEGER:
+            memcpy(&tmpVal6, currCell, sizeof(int32_t));
+            return sqlite3_bind_int(statement, paramId, tmpVal6);
+        case DBDataSchema::DBT_BIGINT:
+            memcpy(&tmpVal7, currCell, sizeof(int64_t));
+            return sqlite3_bind_int64(statement, paramId, tmpVal7);
+        case DBDataSchema::DBT_UTINYINT:
+            memcpy(&tmpVal4, currCell, sizeof(uint8_t));
+            return sqlite3_bind_int(statement, paramId, (int)tmpVal4);
+        case DBDataSchema::DBT_USMALLINT:
+            memcpy(&tmpVal5, currCell, sizeof(uint16_t));
+            return sqlite3_bind_int(statement, paramId, (int)tmpVal5);
+        case DBDataSchema::DBT_UMEDIUMINT:
+        case DBDataSchema::DBT_UINTEGER:
+            memcpy(&tmpVal8, currCell, sizeof(uint32_t));
+            return sqlite3_bind_int64(statement, paramId, (sqlite3_int64)tmpVal8);
+        // Sqlite3 has troubles with unsigned 64 bit integers... casting to signed type... THIS IS A LIMITATION!
+        case DBDataSchema::DBT_UBIGINT:
+            memcpy(&tmpVal9, currCell, sizeof(uint64_t));
+            return sqlite3_bind_int64(statement, paramId, (sqlite3_int64)tmpVal9);
+        case DBDataSchema::DBT_FLOAT:
+        case DBDataSchema::DBT_UFLOAT:
+            memcpy(&tmpVal2, currCell, sizeof(float));
+            return sqlite3_bind_double(statement, paramId, (double)tmpVal2);
+        case DBDataSchema::DBT_REAL:
+        case DBDataSchema::DBT_UREAL:
+            memcpy(&tmpVal10, currCell, sizeof(double));
+            return sqlite3_bind_double(statement, paramId, tmpVal10);
+        default:
+            sqlite3_close(dbHandler);
+            DBIngestor_error("DBSqlite3 - bindValue: an error occured in bindValue in switch while binding\n", NULL);
+    }
     
-    bindOneRowToStmt(thisSchema, thisData, preparedStatement, nInStmt);
+    return SQLITE_ERROR;
 }
 
 int DBSqlite3::executeStmt(void* preparedStatement) {
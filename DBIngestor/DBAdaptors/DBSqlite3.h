@@ -26,6 +26,14 @@
 
 #include "DBAbstractor.h"
 #include <sqlite3.h>
+#include <string>
+#include <vector>
+#include <map>
+#ifndef _WIN32
+#include <stdint.h>
+#else
+#include "stdint_win.h"
+#endif
 
 #ifndef DBIngestor_DBSqlite3_h
 #define DBIngestor_DBSqlite3_h
@@ -45,11 +53,100 @@ namespace DBServer {
          */
         sqlite3 * dbHandler;
 
+        /*! \var std::string journalMode
+         value of PRAGMA journal_mode set on connect (OFF, MEMORY, WAL, ...), empty to keep the default
+         */
+        std::string journalMode;
+
+        /*! \var std::string synchronous
+         value of PRAGMA synchronous set on connect (OFF, NORMAL, FULL), empty to keep the default
+         */
+        std::string synchronous;
+
+        /*! \var int64_t cacheSize
+         value of PRAGMA cache_size set on connect (pages if positive, KiB if negative), 0 to keep the default
+         */
+        int64_t cacheSize;
+
+        /*! \var int pageSize
+         value of PRAGMA page_size set on connect, 0 to keep the default. Only has an effect on new database files
+         */
+        int pageSize;
+
+        /*! \var bool exclusiveLocking
+         if true, PRAGMA locking_mode=EXCLUSIVE is set on connect
+         */
+        bool exclusiveLocking;
+
+        /*! \var std::string tempStore
+         value of PRAGMA temp_store set on connect (DEFAULT, FILE, MEMORY), empty to keep the default
+         */
+        std::string tempStore;
+
+        /*! \var int64_t mmapSize
+         value of PRAGMA mmap_size set on connect in bytes, 0 to keep the default
+         */
+        int64_t mmapSize;
+
+        /*! \var std::map<std::string, std::vector<std::pair<std::string, std::string> > > droppedIndexes
+         name and CREATE statement of the indexes dropped by disableKeys, per table
+         */
+        std::map<std::string, std::vector<std::pair<std::string, std::string> > > droppedIndexes;
+
+        /*! \brief executes a PRAGMA on the connection
+         \param std::string pragma: the pragma and its value (i.e. "synchronous=OFF")
+         \return the value reported back by SQLite, empty if the pragma does not report anything*/
+        std::string execPragma(std::string pragma);
+
+        /*! \brief recreates the indexes of a table dropped by disableKeys
+         \param std::string table: name of the table
+         \return returns 1 if successfull or 0 if not*/
+        int rebuildIndexes(std::string table);
+
+        /*! \brief binds one (non NULL) value to a parameter of a statement
+         \param sqlite3_stmt * statement: the statement
+         \param int paramId: index of the parameter (starting at 1)
+         \param DBDataSchema::DBType bindType: type of the value (DBT_ANY already resolved)
+         \param char * currCell: the value in the buffer row
+         \param sqlite3_destructor_type stringDestructor: SQLITE_TRANSIENT or SQLITE_STATIC, used for strings
+         \return the sqlite3 error code*/
+        int bindValue(sqlite3_stmt * statement, int paramId, DBDataSchema::DBType bindType, char * currCell, sqlite3_destructor_type stringDestructor);
+
     public:
         DBSqlite3();
         
         ~DBSqlite3();        
         
+        /*! \brief sets up the connection for bulk ingestion
+         
+         Sets journal_mode=MEMORY, synchronous=OFF, a 256 MiB page cache, a 64 KiB page size (new files only),
+         locking_mode=EXCLUSIVE, temp_store=MEMORY and a 256 MiB mmap_size. This trades durability for speed: 
+         if the process or the machine dies during the ingest, the database file may be corrupted. The exclusive
+         lock is held until the connection is closed, so only use this with a single connection.
+         Needs to be called before connect.*/
+        void setBulkProfile();
+        
+        std::string getJournalMode();
+        void setJournalMode(std::string newJournalMode);
+        
+        std::string getSynchronous();
+        void setSynchronous(std::string newSynchronous);
+        
+        int64_t getCacheSize();
+        void setCacheSize(int64_t newCacheSize);
+        
+        int getPageSize();
+        void setPageSize(int newPageSize);
+        
+        bool getExclusiveLocking();
+        void setExclusiveLocking(bool newExclusiveLocking);
+        
+        std::string getTempStore();
+        void setTempStore(std::string newTempStore);
+        
+        int64_t getMmapSize();
+        void setMmapSize(int64_t newMmapSize);
+        
         /*! \brief connects to a database server. 
          \param string usr: username with which to connect to the DB server
          \param string pwd: password for the given user
@@ -60,6 +157,7 @@ namespace DBServer {
          \return returns 1 if successfull or 0 if not
          
          Place path to file in port! Remaining options are ignored...
+         The configured PRAGMAs (see setBulkProfile) are applied right after the file is opened.
          Opens a connection to a database server at the given host and port, using the given username
          and password. If the connection was sucessfully established, this shall return 1, otherwise 0.*/
 		virtual int connect(std::string usr, std::string pwd, std::string host, std::string port, std::string socket);
@@ -71,6 +169,11 @@ namespace DBServer {
          Disconnects from the database server. If the disconnect was successfull, this shall return 1, otherwise 0.*/
 		virtual int disconnect();
         
+        /*! \brief creates a new adaptor with the same configuration.
+         
+         \return returns a new, unconnected DBSqlite3 with the settings of this one*/
+        virtual DBAbstractor * createLike();
+        
         /*! \brief sets a new savepoint if supported by the DB engine. 
          
          \return returns 1 if successfull or 0 if not
@@ -103,7 +206,12 @@ namespace DBServer {
          
          \return returns 1 if successfull or 0 if not
          
-         THIS FUNCTION IS NOT SUPPORTED BY SQLITE3: Calling this function will disable (not delete!) all the keys/indexes on a given table.*/
+         SQLite3 cannot disable indexes. Instead the CREATE statements of all the secondary indexes on the table are
+         remembered and the indexes are dropped, so that they are built in one go by enableKeys after the ingest.
+         Indexes created by PRIMARY KEY or UNIQUE constraints cannot be dropped and are kept. The CREATE statements
+         only live in memory, so the drop is never committed: outside of a transaction nothing is dropped, and if
+         the ingest commits in between (see DBIngest::DBIngestor::setCommitIntervalRows), the indexes are rebuilt
+         before the first commit.*/
         virtual int disableKeys(DBDataSchema::Schema * thisSchema);
         
         /*! \brief reenables the keys of a given table. 
@@ -111,7 +219,8 @@ namespace DBServer {
          
          \return returns 1 if successfull or 0 if not
          
-         THIS FUNCTION IS NOT SUPPORTED BY SQLITE3: Calling this function will reenable all the keys/indexes on a given table.*/
+         Recreates the indexes dropped by disableKeys. Indexes that exist again (i.e. since the drop has been 
+         rolled back) are skipped.*/
         virtual int enableKeys(DBDataSchema::Schema * thisSchema);
 
         /*! \brief retrieves a Schema object from a given database table. 
@@ -198,6 +307,16 @@ namespace DBServer {
          size as Schema and needs to be of equal ordering!*/
         virtual int bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, bool* isNullArray, void* preparedStatement, int nInStmt);
 
+        /*! \brief binds a batch of rows to a prepared statement (works as well for multi statements).  
+         \param const RowBatch & thisBatch: the rows to bind
+         \param void* preparedStatement: a pointer to a prepared statement object
+         
+         \return returns 1 if successfull, 0 if not
+         
+         Resolves the column types once for the batch and binds the strings without copying them. Invariant columns
+         are only bound the first time a statement is used (see RowBatch::skipInvariant).*/
+        virtual int bindBatch(const RowBatch & thisBatch, void* preparedStatement);
+
         /*! \brief executes the given statement.  
          \param void* preparedStatement: a pointer to a prepared statement object
          
@@ -32,6 +32,7 @@
 
 #ifdef DB_MYSQL
 #include "DBAdaptors/DBMySQL.h"
+#include "DBAdaptors/DBMySQLLoadData.h"
 #endif
 
 #ifdef DB_ODBC
@@ -61,6 +62,25 @@ DBAbstractor * DBAdaptorsFactory::getDBAdaptors(string name) {
         found = 1;
         dbServer = new DBServer::DBMySQL();
     } 
+
+    if(name.compare("mysql_array") == 0) {
+        found = 1;
+        DBServer::DBMySQL * mysqlServer = new DBServer::DBMySQL();
+        mysqlServer->setArrayBinding(true);
+        dbServer = mysqlServer;
+    }
+
+    if(name.compare("mysql_async") == 0) {
+        found = 1;
+        DBServer::DBMySQL * mysqlServer = new DBServer::DBMySQL();
+        mysqlServer->setAsyncExecution(true);
+        dbServer = mysqlServer;
+    }
+
+    if(name.compare("mysql_loaddata") == 0) {
+        found = 1;
+        dbServer = new DBServer::DBMySQLLoadData();
+    }
 #endif
     
 #ifdef DB_SQLITE3
@@ -68,6 +88,13 @@ DBAbstractor * DBAdaptorsFactory::getDBAdaptors(string name) {
         found = 1;
         dbServer = new DBServer::DBSqlite3();
     }
+
+    if (name.compare("sqlite3_bulk") == 0) {
+        found = 1;
+        DBServer::DBSqlite3 * sqliteServer = new DBServer::DBSqlite3();
+        sqliteServer->setBulkProfile();
+        dbServer = sqliteServer;
+    }
 #endif
     
 #ifdef DB_ODBC
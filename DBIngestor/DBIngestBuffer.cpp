@@ -23,44 +23,77 @@
 #include "DBType.h"
 #include <string.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <stdio.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
 
 using namespace DBIngest;
 using namespace std;
 
 DBIngestBuffer::DBIngestBuffer() {
     currSize = 0;
+    maxBytes = 0;
+    currBytes = 0;
+    maxBytesUsed = 0;
+    maxLatency = 0;
+    trackLatency = false;
+    firstRowTime = 0;
+    lastRowTime = 0;
+    sumRowTime = 0;
+    latencyRows = 0;
+    latencySum = 0;
+    latencyMax = 0;
     myDBSchema = NULL;
     myDBAbstractor = NULL;
-    bufferArray = NULL;
-    isNullArray = NULL;
-    colLookupArray = NULL;
-    preparedStmt = NULL;
-    lenPreparedStmt = 0;
-    preparedStmtRemain = NULL;
-    lenPreparedStmtRemain = 0;
+    rowSlab = NULL;
+    isNullSlab = NULL;
+    rowPlan = NULL;
+    numCols = 0;
+    numStmtsUsed = 0;
+    maxStmtRows = 0;
+    stmtSizeTuner = NULL;
+    commitIntervalRows = 0;
+    commitIntervalBytes = 0;
+    commitIntervalTime = 0;
+    txnRows = 0;
+    txnBytes = 0;
+    txnStartTime = 0;
+    numRowsCommitted = 0;
+    commitsInputPrefix = true;
+    invariantRow = NULL;
+    invariantIsNull = NULL;
+    hasInvariant = NULL;
+    hasInvariantCols = false;
     basicSizeRow = 0;
     currRowItemId = 0;
+    isDryRun = false;
+    ingestStats = NULL;
+    stringArena = new StringArena();
+    invariantArena = new StringArena(1024);
     
     setBufferSize(1);
 }
 
 DBIngestBuffer::~DBIngestBuffer() {
-    if(preparedStmt != NULL) {
-        myDBAbstractor->finalizePreparedStatement(preparedStmt);
+    finalizePreparedStmts();
+    
+    if(stmtSizeTuner != NULL) {
+        delete stmtSizeTuner;
     }
     
-    if(bufferArray != NULL) {
+    if(rowSlab != NULL) {
         clear();
-        free(bufferArray);
-    }
-
-    if(isNullArray != NULL) {
-        free(isNullArray);
-    }
-
-    if(colLookupArray != NULL) {
-        free(colLookupArray);
+        
+        freeAligned(rowSlab);
+        freeAligned(isNullSlab);
     }
+    
+    freeInvariants();
+    
+    delete stringArena;
+    delete invariantArena;
 }
 
 
@@ -69,17 +102,44 @@ DBIngestBuffer::DBIngestBuffer(DBDataSchema::Schema * newSchema, DBServer::DBAbs
     assert(newDBAbstractor != NULL);
 
     currSize = 0;
+    maxBytes = 0;
+    currBytes = 0;
+    maxBytesUsed = 0;
+    maxLatency = 0;
+    trackLatency = false;
+    firstRowTime = 0;
+    lastRowTime = 0;
+    sumRowTime = 0;
+    latencyRows = 0;
+    latencySum = 0;
+    latencyMax = 0;
     myDBSchema = NULL;
     myDBAbstractor = NULL;
-    bufferArray = NULL;
-    isNullArray = NULL;
-    colLookupArray = NULL;
-    preparedStmt = NULL;
-    lenPreparedStmt = 0;
-    preparedStmtRemain = NULL;
-    lenPreparedStmtRemain = 0;
+    rowSlab = NULL;
+    isNullSlab = NULL;
+    rowPlan = NULL;
+    numCols = 0;
+    numStmtsUsed = 0;
+    maxStmtRows = 0;
+    stmtSizeTuner = NULL;
+    commitIntervalRows = 0;
+    commitIntervalBytes = 0;
+    commitIntervalTime = 0;
+    txnRows = 0;
+    txnBytes = 0;
+    txnStartTime = 0;
+    numRowsCommitted = 0;
+    commitsInputPrefix = true;
+    invariantRow = NULL;
+    invariantIsNull = NULL;
+    hasInvariant = NULL;
+    hasInvariantCols = false;
     basicSizeRow = 0;
     currRowItemId = 0;
+    isDryRun = false;
+    ingestStats = NULL;
+    stringArena = new StringArena();
+    invariantArena = new StringArena(1024);
     
     setBufferSize(1);
 
@@ -88,12 +148,12 @@ DBIngestBuffer::DBIngestBuffer(DBDataSchema::Schema * newSchema, DBServer::DBAbs
 }
 
 int DBIngestBuffer::newRow() {
-    assert(bufferArray != NULL);
-    assert(colLookupArray != NULL);
+    assert(rowSlab != NULL);
+    assert(rowPlan != NULL);
     assert(basicSizeRow > 0);
     
     //if buffer is full, commit
-    if(currSize >= bufferSize) {
+    if(isFull()) {
         if(isDryRun != true) {
             commit();
         }
@@ -101,140 +161,189 @@ int DBIngestBuffer::newRow() {
         clear();
     }
     
-    if(bufferArray[currSize] == NULL) {
-        bufferArray[currSize] = (void*)malloc(basicSizeRow);
-        isNullArray[currSize] = (bool*)malloc(myDBSchema->getNumActiveItems() * sizeof(bool));
-        if(bufferArray[currSize] == NULL || isNullArray[currSize] == NULL) {
-            DBIngestor_error("DBIngestBuffer: Not enough memory for allocating new row in the buffer.\n", NULL);
-        }
+    if(trackLatency == true) {
+        addRowTime();
     }
     
-    //set stuff to 0
-    memset(bufferArray[currSize], 0, basicSizeRow);
-    memset((void*)isNullArray[currSize], 0, myDBSchema->getNumActiveItems() * sizeof(bool));
-    
+    //no need to clear the row, addToRow writes every column and its NULL flag
     currSize++;
-    currRowItemByte = 0;
+    currBytes += basicSizeRow;
     currRowItemId = 0;
     
 	return 1;
 }
 
-int DBIngestBuffer::addToRow(void* value, bool isNull, DBDataSchema::SchemaItem * thisSchemaItem) {
-    assert(bufferArray != NULL);
-    assert(colLookupArray != NULL);
+int DBIngestBuffer::addToRow(void* value, bool isNull) {
+    assert(rowSlab != NULL);
+    assert(rowPlan != NULL);
     assert(basicSizeRow > 0);
     assert(value != NULL);
-    assert(thisSchemaItem != NULL);
+    assert(currRowItemId < numCols);
     
     //adding value to the current buffer row
-    DBDataSchema::DataObjDesc * currObj = thisSchemaItem->getDataDesc();
-    char * currRow = (char*)bufferArray[currSize-1];
+    DBDataSchema::ColumnPlan & currCol = rowPlan[currRowItemId];
+    char * cell = getRow(currSize-1) + currCol.offset;
+    bool * cellIsNull = getIsNullRow(currSize-1) + currRowItemId;
     
-    if(isNull == false) {
-        castDTypeToDBType(value, currObj->getDataObjDType(), thisSchemaItem->getColumnDBType(), (currRow+currRowItemByte));
-        isNullArray[currSize-1][currRowItemId] = 0;
-    } else {
-        //check if this row can be null
-        if(thisSchemaItem->getIsNotNull() == true)
-            return 0;
-        
-        isNullArray[currSize-1][currRowItemId] = 1;
+    if(addToCell(currCol, cell, cellIsNull, value, isNull) != 1) {
+        return 0;
+    }
+    
+    if(currCol.isInvariant == true) {
+        setInvariant(currRowItemId, cell, *cellIsNull);
     }
         
-    currRowItemByte += getByteLenOfDBType(thisSchemaItem->getColumnDBType());
     currRowItemId++;
     
     return 1;
 }
 
-int DBIngestBuffer::clear() {
-    int32_t numStrings = 0;
+int DBIngestBuffer::addInvariantToRow() {
+    assert(rowSlab != NULL);
+    assert(rowPlan != NULL);
+    assert(currRowItemId < numCols);
+    assert(rowPlan[currRowItemId].isInvariant == true);
     
-    //first find all the strings in the Schema to free, free them, then free the rows
-    for(int i=0; i<myDBSchema->getArrSchemaItems().size(); i++) {
-        if(myDBSchema->getArrSchemaItems().at(i)->getColumnName().compare(EMPTY_SCHEMAITEM_NAME) == 0) {
-            continue;
-        }
+    if(hasInvariant[currRowItemId] == false) {
+        return 0;
+    }
+    
+    DBDataSchema::ColumnPlan & currCol = rowPlan[currRowItemId];
+    
+    memcpy(getRow(currSize-1) + currCol.offset, invariantRow + currCol.offset, currCol.byteLen);
+    getIsNullRow(currSize-1)[currRowItemId] = invariantIsNull[currRowItemId];
+    
+    currRowItemId++;
+    
+    return 1;
+}
 
-        DBDataSchema::DataObjDesc * currObj = myDBSchema->getArrSchemaItems().at(i)->getDataDesc();        
+void DBIngestBuffer::setInvariant(int colId, char * cell, bool cellIsNull) {
+    assert(invariantRow != NULL);
+    
+    if(hasInvariant[colId] == true) {
+        return;
+    }
+    
+    DBDataSchema::ColumnPlan & currCol = rowPlan[colId];
+    char * invariantCell = invariantRow + currCol.offset;
+    
+    if(currCol.ownsString == true && cellIsNull == false) {
+        //the string in the cell is released with the arena, keep a copy that lasts as long as the buffer
+        char * arenaString;
+        memcpy(&arenaString, cell, sizeof(char*));
         
-        if(currObj->getDataObjDType() == DBDataSchema::DT_STRING) {
-            numStrings++;
+        char * ownString = invariantArena->copyString(arenaString, StringArena::getStringLength(arenaString));
+        
+        memcpy(invariantCell, &ownString, sizeof(char*));
+    } else {
+        memcpy(invariantCell, cell, currCol.byteLen);
+    }
+    
+    invariantIsNull[colId] = cellIsNull;
+    hasInvariant[colId] = true;
+}
+
+void DBIngestBuffer::allocateInvariants() {
+    freeInvariants();
+    
+    hasInvariantCols = false;
+    for(int i=0; i<numCols; i++) {
+        if(rowPlan[i].isInvariant == true) {
+            hasInvariantCols = true;
         }
     }
     
-    int32_t * arrayOfStrings = (int32_t*)malloc(numStrings*sizeof(int32_t));
-    if(arrayOfStrings == NULL) {
-        DBIngestor_error("DBIngestBuffer - clear: could not allocate array for freeing strings.\n", NULL);
+    if(hasInvariantCols == false) {
+        return;
     }
     
-    int counter = 0;
-    currRowItemByte = 0;
-    currRowItemId = 0;
-    for(int i=0; i<myDBSchema->getArrSchemaItems().size(); i++) {
-        if(myDBSchema->getArrSchemaItems().at(i)->getColumnName().compare(EMPTY_SCHEMAITEM_NAME) == 0) {
-            continue;
-        }
+    invariantRow = (char*)allocAligned((size_t)basicSizeRow);
+    invariantIsNull = (bool*)malloc(numCols * sizeof(bool));
+    hasInvariant = (bool*)malloc(numCols * sizeof(bool));
+    if(invariantRow == NULL || invariantIsNull == NULL || hasInvariant == NULL) {
+        DBIngestor_error("DBIngestBuffer: Not enough memory for allocating the invariant columns of the buffer.\n", NULL);
+    }
+    
+    for(int i=0; i<numCols; i++) {
+        hasInvariant[i] = false;
+    }
+}
 
-        DBDataSchema::DataObjDesc * currObj = myDBSchema->getArrSchemaItems().at(i)->getDataDesc();        
+void DBIngestBuffer::freeInvariants() {
+    if(invariantRow == NULL) {
+        return;
+    }
+    
+    //the strings of the invariant columns
+    invariantArena->reset();
+    
+    freeAligned(invariantRow);
+    free(invariantIsNull);
+    free(hasInvariant);
+    
+    invariantRow = NULL;
+    invariantIsNull = NULL;
+    hasInvariant = NULL;
+}
 
-        if(currObj->getDataObjDType() == DBDataSchema::DT_STRING) {
-            arrayOfStrings[counter] = currRowItemByte;
-            counter++;
+int DBIngestBuffer::addToCell(DBDataSchema::ColumnPlan & currCol, char * cell, bool * cellIsNull, void* value, bool isNull) {
+    if(isNull == false) {
+        if(currCol.ownsString == true) {
+            //strings are copied into the arena, numbers are formatted by the cast first
+            char * currString;
+            if(currCol.dType == DBDataSchema::DT_STRING) {
+                currString = *(char**)value;
+            } else {
+                currCol.castFunc(value, &currString);
+            }
+            
+            size_t len = strlen(currString);
+            char * arenaString = stringArena->copyString(currString, len);
+            memcpy(cell, &arenaString, sizeof(char*));
+            currBytes += len + 1;
+            
+            if(currCol.dType != DBDataSchema::DT_STRING) {
+                free(currString);
+            }
+        } else {
+            currCol.castFunc(value, cell);
         }
+        *cellIsNull = 0;
+    } else {
+        //check if this row can be null
+        if(currCol.isNotNull == true)
+            return 0;
+        
+        //the row is reused, do not leave the value of an earlier row behind
+        memset(cell, 0, currCol.byteLen);
+        *cellIsNull = 1;
+    }
+    
+    return 1;
+}
 
-        switch (currObj->getDataObjDType()) {
-            case DBDataSchema::DT_STRING:
-                currRowItemByte += sizeof(char*) / sizeof(char);
-                break;
-            case DBDataSchema::DT_INT1:
-                currRowItemByte += sizeof(int8_t) / sizeof(char);
-                break;
-            case DBDataSchema::DT_INT2:
-                currRowItemByte += sizeof(int16_t) / sizeof(char);
-                break;
-            case DBDataSchema::DT_INT4:
-                currRowItemByte += sizeof(int32_t) / sizeof(char);
-                break;
-            case DBDataSchema::DT_INT8:
-                currRowItemByte += sizeof(int64_t) / sizeof(char);
-                break;
-            case DBDataSchema::DT_UINT1:
-                currRowItemByte += sizeof(int8_t) / sizeof(char);
-                break;
-            case DBDataSchema::DT_UINT2:
-                currRowItemByte += sizeof(int16_t) / sizeof(char);
-                break;
-            case DBDataSchema::DT_UINT4:
-                currRowItemByte += sizeof(int32_t) / sizeof(char);
-                break;
-            case DBDataSchema::DT_UINT8:
-                currRowItemByte += sizeof(int64_t) / sizeof(char);
-                break;
-            case DBDataSchema::DT_REAL4:
-                currRowItemByte += sizeof(float) / sizeof(char);
-                break;
-            case DBDataSchema::DT_REAL8:
-                currRowItemByte += sizeof(double) / sizeof(char);
-                break;
-
-        }
+int DBIngestBuffer::clear() {
+    int64_t startTime = 0;
+    if(ingestStats != NULL) {
+        startTime = IngestStats::getTimestamp();
     }
     
-    //loop through all the rows and free the strings
-    for(int i=0; i<currSize; i++) {
-        char * currRow = (char*)bufferArray[i];
-        
-        for(int j=0; j<numStrings; j++) {
-            char * currString = *(char**)(currRow+arrayOfStrings[j]);
-            free(currString);
-        }
+    //all the strings that have been copied into the rows are released at once
+    stringArena->reset();
+
+    if(ingestStats != NULL) {
+        ingestStats->addTime(STAGE_FREE, IngestStats::getTimestamp() - startTime);
     }
 
-    currSize = 0;
+    if(currBytes > maxBytesUsed) {
+        maxBytesUsed = currBytes;
+    }
     
-    free(arrayOfStrings);
+    currSize = 0;
+    currBytes = 0;
+    sumRowTime = 0;
+    currRowItemId = 0;
     
     return 1;
 }
@@ -247,54 +356,210 @@ int DBIngestBuffer::commit() {
         return 0;
     }
     
-    //check that a prepared statement exisits
-    if(preparedStmt == NULL) {
-        initPreparedStmt(min(bufferSize, myDBAbstractor->maxRowsPerStmt(myDBSchema)));
+    //the limit of the adaptor may need a round trip to the server, only ask once
+    if(maxStmtRows <= 0) {
+        maxStmtRows = max(1, min(bufferSize, myDBAbstractor->maxRowsPerStmt(myDBSchema)));
+        
+        if(stmtSizeTuner != NULL) {
+            stmtSizeTuner->setMaxRows(maxStmtRows);
+        }
     }
     
-    int numLoops = (int)((float)currSize/(float)lenPreparedStmt);
-    int remainder = currSize % lenPreparedStmt;
+    bool needTime = (ingestStats != NULL || stmtSizeTuner != NULL);
+    int64_t startTime = 0;
+    int64_t bindTime = 0;
+    int64_t endTime = 0;
+    int firstRow = 0;
     
-    for(int i=0; i<numLoops; i++) {
-        for(int j=0; j<lenPreparedStmt; j++) {
-            myDBAbstractor->bindOneRowToStmt(myDBSchema, (void*)bufferArray[i*lenPreparedStmt + j], isNullArray[i*lenPreparedStmt + j], preparedStmt, j);
+    while(firstRow < currSize) {
+        int stmtRows = maxStmtRows;
+        if(stmtSizeTuner != NULL) {
+            stmtRows = stmtSizeTuner->getStmtRows();
         }
         
-        if(myDBAbstractor->executeStmt(preparedStmt) == -2) {
-            initPreparedStmt(min(bufferSize, myDBAbstractor->maxRowsPerStmt(myDBSchema)));
-
-            //resetting preparedStmtRemain through lenPreparedStmtRemain
-            lenPreparedStmtRemain = 0;
+        int numRows = min(stmtRows, currSize - firstRow);
+        PreparedStmtEntry & currEntry = getPreparedStmt(numRows);
+        void* currStmt = currEntry.stmt;
+        
+        if(needTime == true) {
+            startTime = IngestStats::getTimestamp();
+        }
+        
+        //the invariant columns hold the same values in every row, the adaptor may keep them bound with the statement
+        bindRows(currStmt, firstRow, numRows, currEntry.invariantBound);
+        currEntry.invariantBound = hasInvariantCols;
+        
+        if(needTime == true) {
+            bindTime = IngestStats::getTimestamp();
+        }
+        
+        //the adaptor may return before the server has answered, it waits for the statement before it sends
+        //the next one, so that binding the next rows overlaps with the round trip
+        int err = myDBAbstractor->executeStmtAsync(currStmt);
+        
+        if(needTime == true) {
+            endTime = IngestStats::getTimestamp();
+        }
+        
+        if(ingestStats != NULL) {
+            ingestStats->addTime(STAGE_BIND, bindTime - startTime, numRows);
+            ingestStats->addTime(STAGE_EXECUTE, endTime - bindTime);
         }
+        
+        //only full sized statements tell the tuner something about the current size. with asynchronous execution
+        //the time is not the round trip of the statement, the tuner is not used then
+        if(stmtSizeTuner != NULL && numRows == stmtRows) {
+            assert(myDBAbstractor->getExecutesAsync() == false);
+            stmtSizeTuner->addStmt(endTime - startTime);
+        }
+        
+        if(err == -2) {
+            //the connection has been reestablished, the statements prepared on the old one cannot be used
+            //anymore, but the adaptor still holds their resources
+            finalizePreparedStmts();
+            maxStmtRows = max(1, min(bufferSize, myDBAbstractor->maxRowsPerStmt(myDBSchema)));
+        }
+        
+        firstRow += numRows;
     }
     
-    if(remainder > 0) {
-        if(remainder != lenPreparedStmtRemain) {
-            //finish this prepared statement off before creating a new one
-            if(lenPreparedStmtRemain != 0 && preparedStmtRemain != NULL)
-                myDBAbstractor->finalizePreparedStatement(preparedStmtRemain);
-            
-            preparedStmtRemain = myDBAbstractor->prepareMultiIngestStatement(myDBSchema, remainder);
-            lenPreparedStmtRemain = remainder;
-        }
-        assert(preparedStmtRemain != NULL);
+    if(trackLatency == true) {
+        //the first row has waited the longest
+        int64_t firstRowLatency = IngestStats::getTimestamp() - firstRowTime;
         
-        for(int i=0; i<remainder; i++) {
-            myDBAbstractor->bindOneRowToStmt(myDBSchema, (void**)bufferArray[numLoops*lenPreparedStmt + i], isNullArray[numLoops*lenPreparedStmt + i], preparedStmtRemain, i);
+        latencyRows += currSize;
+        latencySum += (int64_t)currSize * firstRowLatency - sumRowTime;
+        if(firstRowLatency > latencyMax) {
+            latencyMax = firstRowLatency;
         }
+    }
+    
+    if(commitIntervalRows > 0 || commitIntervalBytes > 0 || commitIntervalTime > 0) {
+        txnRows += currSize;
+        txnBytes += currBytes;
         
-        if(myDBAbstractor->executeStmt(preparedStmtRemain) == -2) {
-            initPreparedStmt(min(bufferSize, myDBAbstractor->maxRowsPerStmt(myDBSchema)));
+        if((commitIntervalRows > 0 && txnRows >= commitIntervalRows) ||
+           (commitIntervalBytes > 0 && txnBytes >= commitIntervalBytes) ||
+           (commitIntervalTime > 0 && IngestStats::getTimestamp() - txnStartTime >= commitIntervalTime)) {
+            commitTransaction();
         }
     }
     
     return 1;
 }
 
+void DBIngestBuffer::commitTransaction() {
+    myDBAbstractor->releaseSavepoint();
+    myDBAbstractor->setSavepoint();
+    
+    numRowsCommitted += txnRows;
+    
+    if(commitsInputPrefix == true) {
+        printf("Transaction committed: %lld rows, the first %lld rows of the input are committed\n", (long long)txnRows, (long long)numRowsCommitted);
+    } else {
+        //other connections commit rows as well, or the rows are not in the order of the input
+        printf("Transaction committed: %lld rows\n", (long long)txnRows);
+    }
+    fflush(stdout);
+    
+    txnRows = 0;
+    txnBytes = 0;
+    txnStartTime = IngestStats::getTimestamp();
+}
+
+PreparedStmtEntry & DBIngestBuffer::getPreparedStmt(int numRows) {
+    map<int, PreparedStmtEntry>::iterator currEntry = preparedStmts.find(numRows);
+    
+    if(currEntry == preparedStmts.end()) {
+        //make room by finalizing the statement that has not been used for the longest time
+        if(preparedStmts.size() >= DBING_MAX_PREPARED_STMTS) {
+            map<int, PreparedStmtEntry>::iterator oldestEntry = preparedStmts.begin();
+            for(map<int, PreparedStmtEntry>::iterator it = preparedStmts.begin(); it != preparedStmts.end(); ++it) {
+                if(it->second.lastUsed < oldestEntry->second.lastUsed) {
+                    oldestEntry = it;
+                }
+            }
+            
+            myDBAbstractor->finalizePreparedStatement(oldestEntry->second.stmt);
+            preparedStmts.erase(oldestEntry);
+        }
+        
+        PreparedStmtEntry newEntry;
+        newEntry.stmt = myDBAbstractor->prepareMultiIngestStatement(myDBSchema, numRows);
+        newEntry.lastUsed = 0;
+        newEntry.invariantBound = false;
+        
+        if(newEntry.stmt == NULL) {
+            DBIngestor_error("DBIngestBuffer: Error in generating prepared statement.\n", NULL);
+        }
+        
+        currEntry = preparedStmts.insert(make_pair(numRows, newEntry)).first;
+    }
+    
+    numStmtsUsed++;
+    currEntry->second.lastUsed = numStmtsUsed;
+    
+    return currEntry->second;
+}
+
+void DBIngestBuffer::finalizePreparedStmts() {
+    for(map<int, PreparedStmtEntry>::iterator it = preparedStmts.begin(); it != preparedStmts.end(); ++it) {
+        myDBAbstractor->finalizePreparedStatement(it->second.stmt);
+    }
+    
+    preparedStmts.clear();
+}
+
+void DBIngestBuffer::bindRows(void* preparedStatement, int firstRow, int numRows, bool skipInvariant) {
+    DBServer::RowBatch batch;
+    batch.schema = myDBSchema;
+    batch.rowPlan = rowPlan;
+    batch.numCols = numCols;
+    batch.numRows = numRows;
+    batch.rows = getRow(firstRow);
+    batch.rowSize = basicSizeRow;
+    batch.isNull = getIsNullRow(firstRow);
+    batch.skipInvariant = skipInvariant;
+    
+    myDBAbstractor->bindBatch(batch, preparedStatement);
+}
+
 int DBIngestBuffer::getCurrSize() {
 	return currSize;
 }
 
+bool DBIngestBuffer::isFull() {
+    if(currSize >= bufferSize || (maxBytes > 0 && currBytes >= maxBytes)) {
+        return true;
+    }
+    
+    //the rows are timestamped anyway, no need to look at the clock once more
+    return maxLatency > 0 && currSize > 0 && lastRowTime - firstRowTime >= maxLatency;
+}
+
+void DBIngestBuffer::swapRows(DBIngestBuffer * otherBuffer) {
+    assert(otherBuffer != NULL);
+    assert(otherBuffer->myDBSchema == myDBSchema);
+    
+    if(otherBuffer->bufferSize != bufferSize) {
+        DBIngestor_error("DBIngestBuffer: Rows can only be swapped between buffers of equal size.\n", NULL);
+    }
+    
+    //buffers keeping their rows elsewhere (e.g. column by column) need to swap them themselves
+    if(rowSlab == NULL || otherBuffer->rowSlab == NULL) {
+        DBIngestor_error("DBIngestBuffer: Rows can only be swapped between buffers of the same kind.\n", NULL);
+    }
+    
+    std::swap(rowSlab, otherBuffer->rowSlab);
+    std::swap(isNullSlab, otherBuffer->isNullSlab);
+    std::swap(currSize, otherBuffer->currSize);
+    std::swap(currBytes, otherBuffer->currBytes);
+    std::swap(firstRowTime, otherBuffer->firstRowTime);
+    std::swap(lastRowTime, otherBuffer->lastRowTime);
+    std::swap(sumRowTime, otherBuffer->sumRowTime);
+    std::swap(stringArena, otherBuffer->stringArena);
+}
+
 int DBIngestBuffer::getBufferSize() {
 	return bufferSize;
 }
@@ -307,20 +572,93 @@ void DBIngestBuffer::setBufferSize(int newBufferSize) {
     }
     
     bufferSize = newBufferSize;
+    maxStmtRows = 0;
+    
+    allocateRows();
+}
+
+int64_t DBIngestBuffer::getMaxBytes() {
+    return maxBytes;
+}
+
+void DBIngestBuffer::setMaxBytes(int64_t newMaxBytes) {
+    assert(newMaxBytes >= 0);
     
-    if(bufferArray != NULL) {
-        free(bufferArray);
-        free(isNullArray);
+    maxBytes = newMaxBytes;
+}
+
+int64_t DBIngestBuffer::getCurrBytes() {
+    return currBytes;
+}
+
+int64_t DBIngestBuffer::getMaxBytesUsed() {
+    if(currBytes > maxBytesUsed) {
+        return currBytes;
     }
     
-    bufferArray = (void**)malloc(bufferSize * sizeof(void**));
-    isNullArray = (bool**)malloc(bufferSize * sizeof(bool**));
-    if(bufferArray == NULL || isNullArray == NULL) {
-        DBIngestor_error("DBIngestBuffer: Not enough memory for allocating bufferArray.\n", NULL);
+    return maxBytesUsed;
+}
+
+int64_t DBIngestBuffer::getMaxLatency() {
+    return maxLatency;
+}
+
+void DBIngestBuffer::setMaxLatency(int64_t newMaxLatency) {
+    assert(newMaxLatency >= 0);
+    
+    maxLatency = newMaxLatency;
+    
+    if(maxLatency > 0) {
+        setTrackLatency(true);
+    }
+}
+
+int64_t DBIngestBuffer::getFirstRowTime() {
+    return firstRowTime;
+}
+
+bool DBIngestBuffer::getTrackLatency() {
+    return trackLatency;
+}
+
+void DBIngestBuffer::setTrackLatency(bool newTrackLatency) {
+    if(currSize != 0) {
+        DBIngestor_error("DBIngestBuffer: The latency can only be tracked, if the buffer is cleared beforehand.\n", NULL);
     }
     
-    memset(bufferArray, NULL, bufferSize * sizeof(void*));
-    memset(isNullArray, 0, bufferSize * sizeof(bool*));
+    trackLatency = newTrackLatency;
+}
+
+int64_t DBIngestBuffer::getLatencyRows() {
+    return latencyRows;
+}
+
+int64_t DBIngestBuffer::getLatencySum() {
+    return latencySum;
+}
+
+int64_t DBIngestBuffer::getLatencyMax() {
+    return latencyMax;
+}
+
+void DBIngestBuffer::allocateRows() {
+    if(rowSlab != NULL) {
+        freeAligned(rowSlab);
+        freeAligned(isNullSlab);
+        rowSlab = NULL;
+        isNullSlab = NULL;
+    }
+    
+    //the size of a row is only known once the Schema is set
+    if(basicSizeRow <= 0) {
+        return;
+    }
+    
+    rowSlab = (char*)allocAligned((size_t)bufferSize * basicSizeRow);
+    isNullSlab = (bool*)allocAligned((size_t)bufferSize * numCols * sizeof(bool));
+    if(rowSlab == NULL || isNullSlab == NULL) {
+        DBIngestor_error("DBIngestBuffer: Not enough memory for allocating the rows of the buffer.\n", NULL);
+    }
 }
 
 DBDataSchema::Schema * DBIngestBuffer::getDBSchema() {
@@ -330,50 +668,35 @@ DBDataSchema::Schema * DBIngestBuffer::getDBSchema() {
 void DBIngestBuffer::setDBSchema(DBDataSchema::Schema * newSchema) {
     assert(newSchema != NULL);
     
-    //allocate the offset lookup array to the size of a row
-    if(colLookupArray != NULL) {
-        free(colLookupArray);
+    if(currSize != 0) {
+        DBIngestor_error("DBIngestBuffer: The Schema can only be changed, if the buffer is cleared beforehand.\n", NULL);
     }
     
-    //count active elements in schema
-    int colCount = 0;
-    for(int i=0; i<newSchema->getArrSchemaItems().size(); i++) {
-        if(newSchema->getArrSchemaItems().at(i)->getColumnName().compare(EMPTY_SCHEMAITEM_NAME) == 0) {
-            continue;
-        }
-        
-        colCount++;
-    }
+    //the strings kept for the invariant columns are found through the old row plan
+    freeInvariants();
     
-    colLookupArray = (int64_t *)malloc(colCount * sizeof(int64_t));
-    if(colLookupArray == NULL) {
-        DBIngestor_error("DBIngestBuffer: Not enough memory for allocating column lookup accellerator array.\n", NULL);
+    //the offsets of the elements in a row are taken from the row plan (this compiles the schema if needed)
+    vector<DBDataSchema::ColumnPlan> & newRowPlan = newSchema->getRowPlan();
+    
+    if(newRowPlan.size() == 0) {
+        DBIngestor_error("DBIngestBuffer: The Schema has no columns to ingest.\n", NULL);
     }
     
-    //determine minimum size of a row and set the offset lookup array
-    int64_t byteCount = 0;
+    rowPlan = &newRowPlan[0];
+    numCols = (int)newRowPlan.size();
+    basicSizeRow = newSchema->getRowSizeInBytes();
     
-    int i = 0;
-    for(int j=0; j<newSchema->getArrSchemaItems().size(); j++) {
-        if(newSchema->getArrSchemaItems().at(j)->getColumnName().compare(EMPTY_SCHEMAITEM_NAME) == 0) {
-            continue;
-        }
-
-        DBDataSchema::SchemaItem * currObj = newSchema->getArrSchemaItems().at(j);        
-        
-        colLookupArray[i] = byteCount / sizeof(char);
-        
-        if(currObj->getColumnDBType() == DBDataSchema::DBT_CHAR) {
-            byteCount += sizeof(char*);
-        } else {
-            byteCount += DBDataSchema::getByteLenOfDBType(currObj->getColumnDBType());
-        }
-        
-        i++;
+    //statements prepared for another Schema cannot be reused
+    if(newSchema != myDBSchema) {
+        finalizePreparedStmts();
+        maxStmtRows = 0;
     }
     
-    basicSizeRow = byteCount;
 	myDBSchema = newSchema;
+    
+    //rows with the old layout cannot be reused
+    allocateRows();
+    allocateInvariants();
 }
 
 DBServer::DBAbstractor * DBIngestBuffer::getDBAbstractor() {
@@ -389,18 +712,89 @@ void DBIngestBuffer::setDBAbstractor(DBServer::DBAbstractor * newDBAbstractor) {
 int DBIngestBuffer::initPreparedStmt(int numRows) {
     assert(numRows > 0);
     assert(myDBSchema != NULL);
+    assert(myDBAbstractor != NULL);
     
-    preparedStmt = myDBAbstractor->prepareMultiIngestStatement(myDBSchema, numRows);
+    getPreparedStmt(numRows);
     
-    if(preparedStmt == NULL) {
-        DBIngestor_error("DBIngestBuffer: Error in generating prepared statement.\n", NULL);
-    }
+    return 1;
+}
+
+bool DBIngestBuffer::getAdaptiveStmtSize() {
+    return stmtSizeTuner != NULL;
+}
+
+void DBIngestBuffer::setAdaptiveStmtSize(bool newAdaptiveStmtSize, int64_t maxStmtLatency) {
+    assert(maxStmtLatency >= 0);
     
-    lenPreparedStmt = numRows;
+    if(stmtSizeTuner != NULL) {
+        delete stmtSizeTuner;
+        stmtSizeTuner = NULL;
+    }
     
-    return 1;
+    if(newAdaptiveStmtSize == true) {
+        stmtSizeTuner = new StmtSizeTuner();
+        stmtSizeTuner->setMaxLatency(maxStmtLatency);
+        
+        //the tuner is set up with the limit on the next commit
+        maxStmtRows = 0;
+    }
+}
+
+StmtSizeTuner * DBIngestBuffer::getStmtSizeTuner() {
+    return stmtSizeTuner;
+}
+
+void DBIngestBuffer::setCommitInterval(int64_t newIntervalRows, int64_t newIntervalBytes, int64_t newIntervalTime) {
+    assert(newIntervalRows >= 0);
+    assert(newIntervalBytes >= 0);
+    assert(newIntervalTime >= 0);
+    
+    commitIntervalRows = newIntervalRows;
+    commitIntervalBytes = newIntervalBytes;
+    commitIntervalTime = newIntervalTime;
+    
+    txnRows = 0;
+    txnBytes = 0;
+    txnStartTime = IngestStats::getTimestamp();
+}
+
+int64_t DBIngestBuffer::getNumRowsCommitted() {
+    return numRowsCommitted;
+}
+
+void DBIngestBuffer::setCommitsInputPrefix(bool newCommitsInputPrefix) {
+    commitsInputPrefix = newCommitsInputPrefix;
 }
 
 void DBIngestBuffer::setIsDryRun(bool newIsDryRun) {
     isDryRun = newIsDryRun;
 }
+
+IngestStats * DBIngestBuffer::getIngestStats() {
+    return ingestStats;
+}
+
+void DBIngestBuffer::setIngestStats(IngestStats * newIngestStats) {
+    ingestStats = newIngestStats;
+}
+
+void * DBIngestBuffer::allocAligned(size_t size) {
+#ifdef _WIN32
+    return _aligned_malloc(size, DBING_CACHE_LINE_SIZE);
+#else
+    void * newMem = NULL;
+    if(posix_memalign(&newMem, DBING_CACHE_LINE_SIZE, size) != 0) {
+        return NULL;
+    }
+    
+    return newMem;
+#endif
+}
+
+void DBIngestBuffer::freeAligned(void * thisMem) {
+#ifdef _WIN32
+    _aligned_free(thisMem);
+#else
+    free(thisMem);
+#endif
+}
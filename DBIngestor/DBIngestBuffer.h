@@ -28,6 +28,10 @@
 
 #include "Schema.h"
 #include "DBAbstractor.h"
+#include "IngestStats.h"
+#include "StringArena.h"
+#include "StmtSizeTuner.h"
+#include <map>
 #ifndef _WIN32
 #include <stdint.h>
 #else
@@ -38,6 +42,22 @@
 #define DBIngestor_DBIngestBuffer_h
 
 namespace DBIngest  {
+
+//alignment of the row storage of a buffer
+#define DBING_CACHE_LINE_SIZE 64
+
+//maximum number of prepared statements (of different sizes) a buffer keeps
+#define DBING_MAX_PREPARED_STMTS 16
+
+    /*! \struct PreparedStmtEntry
+     \brief a prepared statement cached by a DBIngestBuffer
+     */
+    typedef struct PreparedStmtEntry {
+        void* stmt;
+        int64_t lastUsed;
+        bool invariantBound;
+    } PreparedStmtEntry;
+
     /*! \class DBIngestBuffer
      \brief DBIngestBuffer Interface class
      
@@ -58,16 +78,74 @@ namespace DBIngest  {
          */
         int currSize;
 
-        /*! \var void ** bufferArray
-         the bufferArray holding buffers: buffer holds columns in row subsequently. for strings, a pointer to a string
-         is saved (i.e. char**) and the buffer is set up according to the Schema object in that ordering.
+        /*! \var int64_t maxBytes
+         the maximum number of bytes the rows of the buffer may hold before data is commited. 0 if only bufferSize limits the buffer.
+         */
+        int64_t maxBytes;
+
+        /*! \var int64_t currBytes
+         number of bytes held by the rows currently in the buffer: the size of a row for each row plus the strings copied
+         into the string arena (including their \0)
+         */
+        int64_t currBytes;
+
+        /*! \var int64_t maxBytesUsed
+         the largest value currBytes had when the buffer was cleared (high-water mark)
+         */
+        int64_t maxBytesUsed;
+
+        /*! \var int64_t maxLatency
+         if larger than 0, the buffer counts as full once its first row has waited this many nanoseconds
+         */
+        int64_t maxLatency;
+
+        /*! \var bool trackLatency
+         if set to true, newRow() takes a timestamp of each row and commit() measures how long the rows have waited
+         */
+        bool trackLatency;
+
+        /*! \var int64_t firstRowTime
+         timestamp of the first row in the buffer, only kept when tracking the latency
+         */
+        int64_t firstRowTime;
+
+        /*! \var int64_t lastRowTime
+         timestamp of the last row in the buffer, only kept when tracking the latency
+         */
+        int64_t lastRowTime;
+
+        /*! \var int64_t sumRowTime
+         sum of the nanoseconds each row in the buffer was added after the first one, only kept when tracking the latency
+         */
+        int64_t sumRowTime;
+
+        /*! \var int64_t latencyRows
+         number of rows commit() has measured the latency of
+         */
+        int64_t latencyRows;
+
+        /*! \var int64_t latencySum
+         sum of the nanoseconds each of the latencyRows rows waited between newRow() and being written to the database
+         */
+        int64_t latencySum;
+
+        /*! \var int64_t latencyMax
+         the longest any row waited between newRow() and being written to the database
+         */
+        int64_t latencyMax;
+
+        /*! \var char * rowSlab
+         all the rows of the buffer in one block of bufferSize * basicSizeRow bytes, aligned to DBING_CACHE_LINE_SIZE.
+         a row holds the columns subsequently, set up according to the row plan of the Schema. for strings, a pointer to
+         a string is saved (i.e. char**). the block is allocated once the Schema and the buffer size are known and reused
+         for all the rows that follow.
          */
-        void ** bufferArray;
+        char * rowSlab;
 
-        /*! \var bool ** isNullArray
-         array storing information if given field is NULL
+        /*! \var bool * isNullSlab
+         information if a given field is NULL: numCols flags per row, for all rows in one block
          */
-        bool ** isNullArray;
+        bool * isNullSlab;
 
         /*! \var int32_t * lenArray
          array holding the length of the row arrays in the buffer array. 
@@ -84,15 +162,15 @@ namespace DBIngest  {
          */
         int64_t basicSizeRow;
 
-        /*! \var int64_t * colLookupArray
-         array holding an offset lookup table for fast access to the various elements in a row
+        /*! \var DBDataSchema::ColumnPlan * rowPlan
+         the row plan of the Schema, holding the offset and cast function of each element in a row
          */
-        int64_t * colLookupArray;
+        DBDataSchema::ColumnPlan * rowPlan;
         
-        /*! \var int currRowItemByte
-         the current byte into which a value is added
+        /*! \var int numCols
+         number of columns in a row, i.e. length of rowPlan
          */
-        int currRowItemByte;
+        int numCols;
 
         /*! \var int currRowItemId
          the current index of the value to add
@@ -104,25 +182,90 @@ namespace DBIngest  {
          */
         DBServer::DBAbstractor * myDBAbstractor;
         
-        /*! \var void* preparedStmt
-         prepared statement to use for the ingest
+        /*! \var std::map<int, PreparedStmtEntry> preparedStmts
+         prepared statements to use for the ingest, by the number of rows they cover. holds at most
+         DBING_MAX_PREPARED_STMTS statements, the one used least recently is finalized first.
          */
-        void* preparedStmt;
+        std::map<int, PreparedStmtEntry> preparedStmts;
 
-        /*! \var int lenPreparedStmt
-         length of the prepared statement, i.e. the numbers of rows covered
+        /*! \var int64_t numStmtsUsed
+         number of statements taken from preparedStmts so far, used to find the least recently used one
          */
-        int lenPreparedStmt;
+        int64_t numStmtsUsed;
 
-        /*! \var void* preparedStmtRemain
-         prepared statement to use for the remainding buffer items per ingest
+        /*! \var int maxStmtRows
+         the largest number of rows per statement, i.e. the smaller of bufferSize and the limit of the DBAbstractor. 0 if not
+         yet determined.
          */
-        void* preparedStmtRemain;
-        
-        /*! \var int lenPreparedStmtRemain
-         length of the remainder prepared statement, i.e. the numbers of rows covered
+        int maxStmtRows;
+
+        /*! \var int64_t commitIntervalRows
+         if larger than 0, the transaction is committed (and a new one opened) once it holds this many rows
+         */
+        int64_t commitIntervalRows;
+
+        /*! \var int64_t commitIntervalBytes
+         if larger than 0, the transaction is committed once it holds this many bytes (as counted by currBytes)
+         */
+        int64_t commitIntervalBytes;
+
+        /*! \var int64_t commitIntervalTime
+         if larger than 0, the transaction is committed once it has been open for this many nanoseconds
+         */
+        int64_t commitIntervalTime;
+
+        /*! \var int64_t txnRows
+         number of rows written in the current transaction
+         */
+        int64_t txnRows;
+
+        /*! \var int64_t txnBytes
+         number of bytes written in the current transaction
+         */
+        int64_t txnBytes;
+
+        /*! \var int64_t txnStartTime
+         timestamp of when the current transaction was opened
+         */
+        int64_t txnStartTime;
+
+        /*! \var int64_t numRowsCommitted
+         number of rows this buffer has written in transactions that are committed
+         */
+        int64_t numRowsCommitted;
+
+        /*! \var bool commitsInputPrefix
+         true if the rows committed by this buffer are the first rows of the input, i.e. there is no other buffer
+         committing rows and the rows arrive in the order of the input
+         */
+        bool commitsInputPrefix;
+
+        /*! \var StmtSizeTuner * stmtSizeTuner
+         if not NULL, the number of rows per statement is tuned by this, otherwise maxStmtRows rows are bound to each statement
+         */
+        StmtSizeTuner * stmtSizeTuner;
+
+        /*! \var char * invariantRow
+         the values of the columns with isInvariant set in the row plan, laid out like a row. each is stored the first
+         time it is added and copied into the rows that follow. strings are copied into invariantArena, since the string
+         arena is reset with every commit.
+         */
+        char * invariantRow;
+
+        /*! \var bool * invariantIsNull
+         the NULL flags of the values in invariantRow
+         */
+        bool * invariantIsNull;
+
+        /*! \var bool * hasInvariant
+         for each column, true if its value is held in invariantRow
+         */
+        bool * hasInvariant;
+
+        /*! \var bool hasInvariantCols
+         true if any column of the row plan is invariant
          */
-        int lenPreparedStmtRemain;
+        bool hasInvariantCols;
 
         /*! \var bool isDryRun
          if this is set to true, a dry run is carried out. This means, that newRow will not issue the
@@ -130,11 +273,108 @@ namespace DBIngest  {
          */
         bool isDryRun;
 
+        /*! \brief (re)allocates rowSlab and isNullSlab for bufferSize rows of the current Schema
+         
+         Does nothing as long as no Schema is set.*/
+        virtual void allocateRows();
+
+        /*! \brief binds rows of the buffer to a prepared statement
+         \param void* preparedStatement: the statement, covering numRows rows
+         \param int firstRow: index of the first row in the buffer to bind
+         \param int numRows: number of rows to bind
+         
+         \param bool skipInvariant: true if the invariant columns of the statement have been bound before
+         
+         Called by commit() for each statement, before it is executed. The rows are handed to the DBAbstractor as one RowBatch.*/
+        virtual void bindRows(void* preparedStatement, int firstRow, int numRows, bool skipInvariant);
+
+        /*! \brief returns the cached prepared statement for numRows rows, preparing it if it is not cached yet
+         */
+        PreparedStmtEntry & getPreparedStmt(int numRows);
+
+        /*! \brief finalizes all cached prepared statements
+         */
+        void finalizePreparedStmts();
+
+        /*! \brief commits the current transaction and opens a new one
+         
+         Releases the savepoint of the DBAbstractor and sets a new one.*/
+        void commitTransaction();
+
+        /*! \brief stores a value in a cell of the buffer, see addToRow
+         \param DBDataSchema::ColumnPlan & currCol: the column of the cell
+         \param char * cell: where the DBType value is stored
+         \param bool * cellIsNull: where the NULL flag of the cell is stored
+         \param void* value: the value in the DType of the column
+         \param bool isNull: whether the value is NULL
+         \return returns 1 if successfull or 0 if a NULL is added to a NOT NULL column*/
+        int addToCell(DBDataSchema::ColumnPlan & currCol, char * cell, bool * cellIsNull, void* value, bool isNull);
+
+        /*! \brief keeps the value of an invariant column for the rows that follow, see addInvariantToRow
+         \param int colId: index of the column in the row plan
+         \param char * cell: the cell the value has been stored in by addToCell
+         \param bool cellIsNull: the NULL flag of the cell
+         */
+        void setInvariant(int colId, char * cell, bool cellIsNull);
+
+        /*! \brief (re)allocates invariantRow and its flags for the current Schema, without any values
+         */
+        void allocateInvariants();
+
+        void freeInvariants();
+
+        /*! \brief allocates memory aligned to DBING_CACHE_LINE_SIZE, needs to be released with freeAligned
+         */
+        static void * allocAligned(size_t size);
+
+        static void freeAligned(void * thisMem);
+
+        /*! \brief returns the row with the given index in the buffer
+         */
+        inline char * getRow(int rowId) {
+            return rowSlab + (int64_t)rowId * basicSizeRow;
+        }
+
+        /*! \brief records the timestamp of the row newRow() is about to add
+         */
+        inline void addRowTime() {
+            int64_t rowTime = IngestStats::getTimestamp();
+            
+            if(currSize == 0) {
+                firstRowTime = rowTime;
+            }
+            lastRowTime = rowTime;
+            sumRowTime += rowTime - firstRowTime;
+        }
+
+        /*! \brief returns the NULL flags of the row with the given index in the buffer
+         */
+        inline bool * getIsNullRow(int rowId) {
+            return isNullSlab + (int64_t)rowId * numCols;
+        }
+
+        /*! \var StringArena * stringArena
+         the strings of the rows in the buffer (i.e. of the columns with ownsString set in the row plan) are
+         allocated here. they are released all at once in clear().
+         */
+        StringArena * stringArena;
+
+        /*! \var StringArena * invariantArena
+         the strings of the invariant columns (see invariantRow), which need to outlive the commits. released when
+         the invariants are freed.
+         */
+        StringArena * invariantArena;
+
+        /*! \var IngestStats * ingestStats
+         if not NULL, binding, executing and freeing the rows is timed with these counters
+         */
+        IngestStats * ingestStats;
+
 
 	public:
         DBIngestBuffer();
         
-        ~DBIngestBuffer();
+        virtual ~DBIngestBuffer();
         
         /*! \brief constructor of a DBIngestBuffer 
                     object to a given Schema and DBAbstractor. 
@@ -148,8 +388,9 @@ namespace DBIngest  {
 
          \return returns 1 if successfull or 0 if not
          
-         INTERFACE METHOD: developer needs to implement this. This method adds a new row to the buffer. If the buffer is full, the buffer
-         will be commited to the database and the buffer is flushed. A new row is then added again.*/
+         INTERFACE METHOD: developer needs to implement this. This method adds a new row to the buffer. If the buffer is full (see isFull), the buffer
+         will be commited to the database and the buffer is flushed. A new row is then added again. The row is not cleared, all its columns
+         are overwritten by addToRow.*/
 		virtual int newRow() ;
 	
         /*! \brief interface method for adding a data field
@@ -157,15 +398,26 @@ namespace DBIngest  {
 
          \param void* value: void pointer to the data field
          \param bool isNull: decodes whether current value is NULL or not
-         \param DBDataSchema::SchemaItem * thisSchemaItem: pointer to the SchemaItem
 
          \return returns 1 if successfull or 0 if not
          
-         INTERFACE METHOD: developer needs to implement this. This method adds a data field to the currently active row according to the
-         SchemaItem. HOWEVER: To improve performance, this method does not put value at the right place in bufferArray. This would require
-         a lookup in the Schema for every item added. Therefore it is THE DEVELOPERS responsability to add the data in the RIGHT ORDER ACCORDING
-         TO THE SCHEMA! Data has to be in the DBT_Type format, i.e. in the format as is on the database side.*/
-		virtual int addToRow(void* value, bool isNull, DBDataSchema::SchemaItem * thisSchemaItem);
+         INTERFACE METHOD: developer needs to implement this. This method adds a data field to the currently active row. The column
+         it is stored in is taken from the row plan of the Schema, value by value. Therefore it is THE DEVELOPERS responsability to add
+         the data in the RIGHT ORDER ACCORDING TO THE ROW PLAN (i.e. the active items of the Schema)! Data has to be in the DType format
+         of the column, it is cast into the DBType format (i.e. in the format as is on the database side) using the cast function of the
+         row plan. Strings are copied into the string arena of the buffer, the caller keeps ownership of value. Every column of the row plan
+         needs to be added, since rows are reused without clearing them.*/
+		virtual int addToRow(void* value, bool isNull);
+
+        /*! \brief adds the value an invariant column had in an earlier row to the current row
+         
+         \return returns 1 if the value has been added, or 0 if the buffer does not know the value yet
+         
+         The current column needs to have isInvariant set in the row plan. The value is copied from the first row the
+         column has been added to with addToRow, without casting it or copying strings. If 0 is returned, nothing is
+         added and the value needs to be added with addToRow. The values are kept until the Schema is changed, a buffer
+         is therefore meant to be used for one file only.*/
+        virtual int addInvariantToRow();
 	
         /*! \brief clears the buffer
          
@@ -173,7 +425,7 @@ namespace DBIngest  {
          \return returns 1 if successfull or 0 if not
          
          INTERFACE METHOD: developer needs to implement this. This method clears the buffer, sets its size to 0, freeing all memory for new
-         additions of rows. Additionally it starts a new transaction.*/
+         additions of rows (the strings are released by resetting the string arena). Additionally it starts a new transaction.*/
 		virtual int clear();
         
         /*! \brief commits the buffer to the database
@@ -181,16 +433,86 @@ namespace DBIngest  {
          
          \return returns 1 if successfull or 0 if not
          
-         INTERFACE METHOD: developer needs to implement this. This method commits the buffer to the database, closing the active transaction.*/
+         INTERFACE METHOD: developer needs to implement this. This method commits the buffer to the database, closing the active transaction.
+         The rows are split into statements of maxStmtRows rows (or as many as the StmtSizeTuner asks for) and a last one for the
+         remaining rows. The statements are executed with executeStmtAsync(), so the last one may still be running on the server
+         when this returns.*/
         virtual int commit();
         
         void setIsDryRun(bool newIsDryRun);
         
         int getCurrSize();
+
+        /*! \brief checks whether the buffer is full
+         
+         \return returns true if the buffer is full
+         
+         The buffer is full if it holds bufferSize rows or if a byte budget is set and the rows hold at least maxBytes bytes. Since
+         the size of a row is only known once it is added, the last row may take the buffer past maxBytes. If a maximum latency
+         is set, a buffer is full as well once the rows in it were added over more than that time. If this returns true, the next
+         call to newRow() will commit the buffer.*/
+        bool isFull();
+        
+        /*! \brief swaps the rows held in this buffer with the ones in another buffer
+         \param DBIngestBuffer * otherBuffer: the buffer to swap the rows with
+         
+         Exchanges the row storage (including the string arenas and the number of rows) of the two buffers, without copying any data. Both
+         buffers need to be of the same class and set up with the same Schema and buffer size. This is used to hand a full buffer over
+         to a buffer that is bound to a different thread or connection.*/
+        virtual void swapRows(DBIngestBuffer * otherBuffer);
         
         int getBufferSize();
         
         virtual void setBufferSize(int newBufferSize);
+
+        int64_t getMaxBytes();
+
+        /*! \brief sets the byte budget of the buffer
+         \param int64_t newMaxBytes: maximum number of bytes the rows may hold before the buffer is commited, 0 for no limit
+
+         The buffer is commited as soon as either bufferSize rows or newMaxBytes bytes are reached. The row storage is still
+         allocated for bufferSize rows, the budget limits the strings held in the arena and the amount of data sent to the
+         database with each commit.*/
+        void setMaxBytes(int64_t newMaxBytes);
+
+        int64_t getCurrBytes();
+
+        /*! \brief returns the largest number of bytes the rows of this buffer have held so far
+         */
+        int64_t getMaxBytesUsed();
+
+        int64_t getMaxLatency();
+
+        /*! \brief sets how long rows may wait in the buffer
+         \param int64_t newMaxLatency: nanoseconds after which a buffer that is not empty counts as full, 0 for no limit
+         
+         The buffer only checks the age of its rows in isFull(), i.e. when the next row is added. To flush a buffer while no rows
+         arrive, compare getFirstRowTime() with the current time. Also switches on the tracking of the latency.*/
+        void setMaxLatency(int64_t newMaxLatency);
+
+        /*! \brief returns the timestamp (see IngestStats::getTimestamp) the first row in the buffer was added at
+         
+         Only valid if the buffer is not empty and tracks the latency.*/
+        int64_t getFirstRowTime();
+
+        bool getTrackLatency();
+
+        /*! \brief switches the measuring of the time between adding a row and writing it to the database on or off
+         
+         Needs to be set on all buffers rows are swapped between.*/
+        void setTrackLatency(bool newTrackLatency);
+
+        /*! \brief returns the number of rows whose latency has been measured
+         */
+        int64_t getLatencyRows();
+
+        /*! \brief returns the sum of the latencies of all measured rows in nanoseconds
+         */
+        int64_t getLatencySum();
+
+        /*! \brief returns the largest latency of a measured row in nanoseconds
+         */
+        int64_t getLatencyMax();
         
         DBDataSchema::Schema * getDBSchema();
         
@@ -200,7 +522,51 @@ namespace DBIngest  {
         
         void setDBAbstractor(DBServer::DBAbstractor * newDBAbstractor);       
         
+        /*! \brief makes sure a prepared statement for numRows rows is cached
+         */
         int initPreparedStmt(int numRows);
+
+        bool getAdaptiveStmtSize();
+
+        /*! \brief switches the tuning of the number of rows per statement on or off
+         \param bool newAdaptiveStmtSize: if true, the statement size is tuned with a StmtSizeTuner (see there), otherwise
+                    each statement covers as many rows as the buffer and the DBAbstractor allow
+         \param int64_t maxStmtLatency: if tuning, the maximum average time in nanoseconds a statement may take, 0 for no limit
+         */
+        void setAdaptiveStmtSize(bool newAdaptiveStmtSize, int64_t maxStmtLatency = 0);
+
+        /*! \brief returns the tuner of the statement size, NULL if the size is not tuned
+         */
+        StmtSizeTuner * getStmtSizeTuner();
+
+        /*! \brief sets when commit() closes the running transaction
+         \param int64_t newIntervalRows: commit after this many rows, 0 for no limit
+         \param int64_t newIntervalBytes: commit after this many bytes, 0 for no limit
+         \param int64_t newIntervalTime: commit after this many nanoseconds, 0 for no limit
+         
+         If any of the limits is set, commit() checks them after the rows of the buffer have been written. Once one is reached,
+         the savepoint of the DBAbstractor is released (which commits the transaction) and a new one is set. The limits are
+         therefore only checked once per buffer and a transaction always ends with a full buffer. The savepoint needs to be
+         set before the first commit. If all limits are 0 (the default), the transaction is left to the caller.*/
+        void setCommitInterval(int64_t newIntervalRows, int64_t newIntervalBytes, int64_t newIntervalTime);
+
+        /*! \brief returns the number of rows this buffer has written in transactions that are committed
+         
+         Only counts the transactions committed through the commit interval.*/
+        int64_t getNumRowsCommitted();
+
+        /*! \brief tells the buffer whether the rows it commits are the first rows of the input
+         \param bool newCommitsInputPrefix: true (the default) if this buffer commits all the rows in the order of the input
+         
+         Only then the number of committed rows printed after each transaction tells how far the input has been ingested.*/
+        void setCommitsInputPrefix(bool newCommitsInputPrefix);
+
+        IngestStats * getIngestStats();
+
+        /*! \brief sets the counters commit() and clear() are timed with
+         \param IngestStats * newIngestStats: counters owned by the thread using this buffer, or NULL to not time anything
+         */
+        void setIngestStats(IngestStats * newIngestStats);
     };
 }
 
@@ -0,0 +1,261 @@
+/*
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>,
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "DBIngestColumnBuffer.h"
+#include "dbingestor_error.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+
+using namespace DBIngest;
+using namespace std;
+
+DBIngestColumnBuffer::DBIngestColumnBuffer(DBDataSchema::Schema * newSchema, DBServer::DBAbstractor * newDBAbstractor) : DBIngestBuffer(newSchema, newDBAbstractor) {
+    columnArrays = NULL;
+    isNullColumns = NULL;
+    numAllocatedCols = 0;
+    bindColumns = NULL;
+    bindIsNull = NULL;
+    rowScratch = NULL;
+    isNullScratch = NULL;
+
+    //the base class has set up its row storage, replace it with the columns
+    allocateRows();
+}
+
+DBIngestColumnBuffer::~DBIngestColumnBuffer() {
+    clear();
+
+    freeColumns();
+}
+
+void DBIngestColumnBuffer::freeColumns() {
+    for(int i=0; i<numAllocatedCols; i++) {
+        freeAligned(columnArrays[i]);
+        freeAligned(isNullColumns[i]);
+    }
+
+    if(columnArrays != NULL) {
+        free(columnArrays);
+        free(isNullColumns);
+        free(bindColumns);
+        free(bindIsNull);
+    }
+
+    if(rowScratch != NULL) {
+        freeAligned(rowScratch);
+        freeAligned(isNullScratch);
+    }
+
+    columnArrays = NULL;
+    isNullColumns = NULL;
+    numAllocatedCols = 0;
+    bindColumns = NULL;
+    bindIsNull = NULL;
+    rowScratch = NULL;
+    isNullScratch = NULL;
+}
+
+void DBIngestColumnBuffer::allocateRows() {
+    freeColumns();
+
+    //the rows of the base class are not used
+    if(rowSlab != NULL) {
+        freeAligned(rowSlab);
+        freeAligned(isNullSlab);
+        rowSlab = NULL;
+        isNullSlab = NULL;
+    }
+
+    //the size of a row is only known once the Schema is set
+    if(basicSizeRow <= 0) {
+        return;
+    }
+
+    columnArrays = (char**)malloc(numCols * sizeof(char*));
+    isNullColumns = (bool**)malloc(numCols * sizeof(bool*));
+    bindColumns = (void**)malloc(numCols * sizeof(void*));
+    bindIsNull = (bool**)malloc(numCols * sizeof(bool*));
+    if(columnArrays == NULL || isNullColumns == NULL || bindColumns == NULL || bindIsNull == NULL) {
+        DBIngestor_error("DBIngestColumnBuffer: Not enough memory for allocating the columns of the buffer.\n", NULL);
+    }
+
+    for(int i=0; i<numCols; i++) {
+        columnArrays[i] = (char*)allocAligned((size_t)bufferSize * rowPlan[i].byteLen);
+        isNullColumns[i] = (bool*)allocAligned((size_t)bufferSize * sizeof(bool));
+        if(columnArrays[i] == NULL || isNullColumns[i] == NULL) {
+            DBIngestor_error("DBIngestColumnBuffer: Not enough memory for allocating the columns of the buffer.\n", NULL);
+        }
+
+        numAllocatedCols++;
+    }
+}
+
+int DBIngestColumnBuffer::newRow() {
+    assert(columnArrays != NULL);
+    assert(rowPlan != NULL);
+
+    //if buffer is full, commit
+    if(isFull()) {
+        if(isDryRun != true) {
+            commit();
+        }
+
+        clear();
+    }
+
+    if(trackLatency == true) {
+        addRowTime();
+    }
+    
+    //no need to clear the row, addToRow writes every column and its NULL flag
+    currSize++;
+    currBytes += basicSizeRow;
+    currRowItemId = 0;
+
+	return 1;
+}
+
+int DBIngestColumnBuffer::addToRow(void* value, bool isNull) {
+    assert(columnArrays != NULL);
+    assert(rowPlan != NULL);
+    assert(value != NULL);
+    assert(currRowItemId < numCols);
+
+    DBDataSchema::ColumnPlan & currCol = rowPlan[currRowItemId];
+    int rowId = currSize - 1;
+    char * cell = columnArrays[currRowItemId] + (int64_t)rowId * currCol.byteLen;
+    bool * cellIsNull = isNullColumns[currRowItemId] + rowId;
+
+    if(addToCell(currCol, cell, cellIsNull, value, isNull) != 1) {
+        return 0;
+    }
+
+    if(currCol.isInvariant == true) {
+        setInvariant(currRowItemId, cell, *cellIsNull);
+    }
+
+    currRowItemId++;
+
+    return 1;
+}
+
+int DBIngestColumnBuffer::addInvariantToRow() {
+    assert(columnArrays != NULL);
+    assert(rowPlan != NULL);
+    assert(currRowItemId < numCols);
+    assert(rowPlan[currRowItemId].isInvariant == true);
+
+    if(hasInvariant[currRowItemId] == false) {
+        return 0;
+    }
+
+    DBDataSchema::ColumnPlan & currCol = rowPlan[currRowItemId];
+    int rowId = currSize - 1;
+
+    memcpy(columnArrays[currRowItemId] + (int64_t)rowId * currCol.byteLen, invariantRow + currCol.offset, currCol.byteLen);
+    isNullColumns[currRowItemId][rowId] = invariantIsNull[currRowItemId];
+
+    currRowItemId++;
+
+    return 1;
+}
+
+void DBIngestColumnBuffer::bindRows(void* preparedStatement, int firstRow, int numRows, bool skipInvariant) {
+    if(myDBAbstractor->getSupportsColumnBinding() == true) {
+        for(int i=0; i<numCols; i++) {
+            bindColumns[i] = (void*)(columnArrays[i] + (int64_t)firstRow * rowPlan[i].byteLen);
+            bindIsNull[i] = isNullColumns[i] + firstRow;
+        }
+
+        myDBAbstractor->bindColumnsToStmt(myDBSchema, bindColumns, bindIsNull, preparedStatement, numRows);
+
+        return;
+    }
+
+    //assemble the rows for adaptors that only bind rows
+    if(rowScratch == NULL) {
+        rowScratch = (char*)allocAligned((size_t)bufferSize * basicSizeRow);
+        isNullScratch = (bool*)allocAligned((size_t)bufferSize * numCols * sizeof(bool));
+        if(rowScratch == NULL || isNullScratch == NULL) {
+            DBIngestor_error("DBIngestColumnBuffer: Not enough memory for assembling the rows of the buffer.\n", NULL);
+        }
+    }
+
+    for(int i=0; i<numCols; i++) {
+        DBDataSchema::ColumnPlan & currCol = rowPlan[i];
+        char * currValue = columnArrays[i] + (int64_t)firstRow * currCol.byteLen;
+        bool * currIsNull = isNullColumns[i] + firstRow;
+
+        for(int j=0; j<numRows; j++) {
+            memcpy(rowScratch + (int64_t)j * basicSizeRow + currCol.offset, currValue, currCol.byteLen);
+            isNullScratch[(int64_t)j * numCols + i] = currIsNull[j];
+            currValue += currCol.byteLen;
+        }
+    }
+
+    DBServer::RowBatch batch;
+    batch.schema = myDBSchema;
+    batch.rowPlan = rowPlan;
+    batch.numCols = numCols;
+    batch.numRows = numRows;
+    batch.rows = rowScratch;
+    batch.rowSize = basicSizeRow;
+    batch.isNull = isNullScratch;
+    batch.skipInvariant = skipInvariant;
+    
+    myDBAbstractor->bindBatch(batch, preparedStatement);
+}
+
+void DBIngestColumnBuffer::swapRows(DBIngestBuffer * otherBuffer) {
+    assert(otherBuffer != NULL);
+    assert(otherBuffer->getDBSchema() == myDBSchema);
+
+    DBIngestColumnBuffer * otherColumnBuffer = dynamic_cast<DBIngestColumnBuffer*>(otherBuffer);
+
+    if(otherColumnBuffer == NULL) {
+        DBIngestor_error("DBIngestColumnBuffer: Rows can only be swapped with another column buffer.\n", NULL);
+    }
+
+    if(otherColumnBuffer->bufferSize != bufferSize) {
+        DBIngestor_error("DBIngestColumnBuffer: Rows can only be swapped between buffers of equal size.\n", NULL);
+    }
+
+    std::swap(columnArrays, otherColumnBuffer->columnArrays);
+    std::swap(isNullColumns, otherColumnBuffer->isNullColumns);
+    std::swap(currSize, otherColumnBuffer->currSize);
+    std::swap(currBytes, otherColumnBuffer->currBytes);
+    std::swap(firstRowTime, otherColumnBuffer->firstRowTime);
+    std::swap(lastRowTime, otherColumnBuffer->lastRowTime);
+    std::swap(sumRowTime, otherColumnBuffer->sumRowTime);
+    std::swap(stringArena, otherColumnBuffer->stringArena);
+}
+
+char * DBIngestColumnBuffer::getColumn(int colId) {
+    assert(colId >= 0 && colId < numCols);
+
+    return columnArrays[colId];
+}
+
+bool * DBIngestColumnBuffer::getIsNullColumn(int colId) {
+    assert(colId >= 0 && colId < numCols);
+
+    return isNullColumns[colId];
+}
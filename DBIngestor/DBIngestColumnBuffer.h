@@ -0,0 +1,135 @@
+/*
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>,
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file DBIngestColumnBuffer.h
+ \brief Column oriented Data Ingest Buffer
+
+ A DBIngestBuffer that stores the data column by column (struct of arrays), for
+ adaptors that bind whole columns at once.
+ */
+
+#include "DBIngestBuffer.h"
+
+#ifndef DBIngestor_DBIngestColumnBuffer_h
+#define DBIngestor_DBIngestColumnBuffer_h
+
+namespace DBIngest  {
+    /*! \class DBIngestColumnBuffer
+     \brief DBIngestColumnBuffer class
+
+     Keeps one contiguous array per column of the row plan (bufferSize values of byteLen bytes each, strings as char*
+     into the string arena of the buffer) and one array of NULL flags per column. Rows are added through the same
+     interface as with the DBIngestBuffer.
+
+     If the DBAbstractor supports column binding, the columns of each statement are handed over with bindColumnsToStmt
+     without copying. Otherwise the rows of each statement are assembled from the columns and bound as a RowBatch, so that
+     the buffer works with any adaptor.
+     */
+	class DBIngestColumnBuffer : public DBIngestBuffer {
+
+	private:
+        /*! \var char ** columnArrays
+         the values of each column, aligned to DBING_CACHE_LINE_SIZE
+         */
+        char ** columnArrays;
+
+        /*! \var bool ** isNullColumns
+         the NULL flags of each column
+         */
+        bool ** isNullColumns;
+
+        /*! \var int numAllocatedCols
+         number of columns in columnArrays and isNullColumns
+         */
+        int numAllocatedCols;
+
+        /*! \var void ** bindColumns
+         scratch space for the start of each column handed to bindColumnsToStmt
+         */
+        void ** bindColumns;
+
+        /*! \var bool ** bindIsNull
+         scratch space for the start of the NULL flags of each column handed to bindColumnsToStmt
+         */
+        bool ** bindIsNull;
+
+        /*! \var char * rowScratch
+         rows assembled for adaptors without column binding. holds up to bufferSize rows, since the adaptors may
+         refer to the bound rows until the statement is executed. allocated when first needed.
+         */
+        char * rowScratch;
+
+        /*! \var bool * isNullScratch
+         NULL flags of the rows in rowScratch
+         */
+        bool * isNullScratch;
+
+        void freeColumns();
+
+    protected:
+        /*! \brief (re)allocates the column arrays for bufferSize rows of the current Schema
+
+         Does nothing as long as no Schema is set.*/
+        virtual void allocateRows();
+
+        /*! \brief binds rows of the buffer to a prepared statement
+         \param void* preparedStatement: the statement, covering numRows rows
+         \param int firstRow: index of the first row in the buffer to bind
+         \param int numRows: number of rows to bind
+         \param bool skipInvariant: true if the invariant columns of the statement have been bound before
+
+         Binds the columns at once if the DBAbstractor supports it, otherwise the assembled rows.*/
+        virtual void bindRows(void* preparedStatement, int firstRow, int numRows, bool skipInvariant);
+
+	public:
+        /*! \brief constructor of a DBIngestColumnBuffer
+                    object to a given Schema and DBAbstractor.
+         \param DBDataSchema::Schema * newSchema: the Schema used for reading and storing the data in the database
+         \param DBServer::DBAbstractor * newDBAbstractor: the Schema used for reading and storing the data in the database
+
+         Initialises a DBIngestColumnBuffer with a Schema and a DBAbstractor.*/
+		DBIngestColumnBuffer(DBDataSchema::Schema * newSchema, DBServer::DBAbstractor * newDBAbstractor);
+
+        virtual ~DBIngestColumnBuffer();
+
+		virtual int newRow();
+
+		virtual int addToRow(void* value, bool isNull);
+
+        virtual int addInvariantToRow();
+
+        /*! \brief swaps the rows held in this buffer with the ones in another buffer
+         \param DBIngestBuffer * otherBuffer: the buffer to swap the rows with, needs to be a DBIngestColumnBuffer as well
+         */
+        virtual void swapRows(DBIngestBuffer * otherBuffer);
+
+        /*! \brief returns the values of a column
+         \param int colId: index of the column in the row plan
+         \return array of getCurrSize() values of byteLen bytes*/
+        char * getColumn(int colId);
+
+        /*! \brief returns the NULL flags of a column
+         \param int colId: index of the column in the row plan
+         \return array of getCurrSize() flags*/
+        bool * getIsNullColumn(int colId);
+    };
+}
+
+#endif
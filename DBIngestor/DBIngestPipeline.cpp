@@ -0,0 +1,553 @@
+/*  
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>, 
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "DBIngestPipeline.h"
+#include "DBIngestColumnBuffer.h"
+#include "dbingestor_error.h"
+#include <assert.h>
+#include <algorithm>
+#include <boost/bind.hpp>
+
+using namespace DBIngest;
+using namespace std;
+
+DBIngestPipeline::DBIngestPipeline(DBDataSchema::Schema * newSchema, DBServer::DBAbstractor * newDBAbstractor, int newBufferSize, int newQueueDepth) {
+    assert(newDBAbstractor != NULL);
+
+    myDBAbstractors.push_back(newDBAbstractor);
+
+    init(newSchema, newBufferSize, newQueueDepth);
+}
+
+DBIngestPipeline::DBIngestPipeline(DBDataSchema::Schema * newSchema, vector<DBServer::DBAbstractor*> & newDBAbstractors, int newBufferSize, int newQueueDepth) {
+    assert(newDBAbstractors.size() > 0);
+
+    for(int i=0; i<newDBAbstractors.size(); i++) {
+        assert(newDBAbstractors.at(i) != NULL);
+        myDBAbstractors.push_back(newDBAbstractors.at(i));
+    }
+
+    init(newSchema, newBufferSize, newQueueDepth);
+}
+
+void DBIngestPipeline::init(DBDataSchema::Schema * newSchema, int newBufferSize, int newQueueDepth) {
+    assert(newSchema != NULL);
+    assert(newBufferSize > 0);
+    assert(newQueueDepth > 0);
+
+    myDBSchema = newSchema;
+    bufferSize = newBufferSize;
+    queueDepth = newQueueDepth;
+    isRunning = false;
+    isFinished = false;
+    isOrdered = false;
+    headChunk = 0;
+    maxLatency = 0;
+    isFlushing = false;
+    
+    setNumProducers(1);
+
+    //all buffers need the same layout to swap rows, the column oriented one works with any adaptor
+    bool columnLayout = myDBAbstractors.at(0)->getSupportsColumnBinding();
+
+    //one buffer for each queue slot plus the one the producer is currently filling. the producer
+    //buffers never commit, so it does not matter which abstractor they are set up with
+    for(int i=0; i<queueDepth + 1; i++) {
+        DBIngestBuffer * newBuffer = newIngestBuffer(myDBAbstractors.at(0), columnLayout);
+
+        buffers.push_back(newBuffer);
+        freeBuffers.push_back(newBuffer);
+    }
+
+    //one commit buffer per connection, holding this connection's prepared statements
+    for(int i=0; i<myDBAbstractors.size(); i++) {
+        DBIngestBuffer * newBuffer = newIngestBuffer(myDBAbstractors.at(i), columnLayout);
+
+        commitBuffers.push_back(newBuffer);
+    }
+    
+    commitStats.resize(myDBAbstractors.size());
+}
+
+DBIngestBuffer * DBIngestPipeline::newIngestBuffer(DBServer::DBAbstractor * thisDBAbstractor, bool columnLayout) {
+    DBIngestBuffer * newBuffer;
+
+    if(columnLayout == true) {
+        newBuffer = new DBIngestColumnBuffer(myDBSchema, thisDBAbstractor);
+    } else {
+        newBuffer = new DBIngestBuffer(myDBSchema, thisDBAbstractor);
+    }
+
+    newBuffer->setBufferSize(bufferSize);
+    newBuffer->setIsDryRun(false);
+
+    return newBuffer;
+}
+
+DBIngestPipeline::~DBIngestPipeline() {
+    if(isRunning == true) {
+        finish();
+    }
+
+    for(int i=0; i<buffers.size(); i++) {
+        delete buffers.at(i);
+    }
+
+    for(int i=0; i<producerMutexes.size(); i++) {
+        delete producerMutexes.at(i);
+    }
+
+    for(int i=0; i<commitBuffers.size(); i++) {
+        delete commitBuffers.at(i);
+    }
+}
+
+void DBIngestPipeline::start() {
+    assert(isRunning == false);
+
+    isFinished = false;
+    isRunning = true;
+    headChunk = 0;
+
+    for(int i=0; i<commitBuffers.size(); i++) {
+        commitThreads.create_thread(boost::bind(&DBIngestPipeline::commitLoop, this, i));
+    }
+
+    if(maxLatency > 0) {
+        isFlushing = true;
+        flushThreads.create_thread(boost::bind(&DBIngestPipeline::flushLoop, this));
+    }
+}
+
+DBIngestBuffer * DBIngestPipeline::getFreeBuffer() {
+    boost::unique_lock<boost::mutex> lock(queueMutex);
+
+    while(freeBuffers.empty()) {
+        freeCond.wait(lock);
+    }
+
+    DBIngestBuffer * freeBuffer = freeBuffers.front();
+    freeBuffers.pop_front();
+
+    return freeBuffer;
+}
+
+DBIngestBuffer * DBIngestPipeline::getFreeBuffer(int chunkId) {
+    assert(chunkId >= 0);
+
+    boost::unique_lock<boost::mutex> lock(queueMutex);
+
+    while(freeBuffers.empty() || (isOrdered == true && chunkId != headChunk && freeBuffers.size() < 2)) {
+        freeCond.wait(lock);
+    }
+
+    DBIngestBuffer * freeBuffer = freeBuffers.front();
+    freeBuffers.pop_front();
+
+    return freeBuffer;
+}
+
+void DBIngestPipeline::submitBuffer(DBIngestBuffer * fullBuffer) {
+    assert(fullBuffer != NULL);
+
+    boost::unique_lock<boost::mutex> lock(queueMutex);
+
+    if(fullBuffer->getCurrSize() == 0) {
+        freeBuffers.push_back(fullBuffer);
+        freeCond.notify_all();
+        return;
+    }
+
+    if(isRunning == false) {
+        DBIngestor_error("DBIngestPipeline: Buffer submitted, but the commit threads are not running.\n", NULL);
+    }
+
+    fullBuffers.push_back(fullBuffer);
+    fullCond.notify_one();
+}
+
+void DBIngestPipeline::submitBuffer(DBIngestBuffer * fullBuffer, int chunkId, bool isLastInChunk) {
+    assert(fullBuffer != NULL);
+    assert(chunkId >= 0);
+
+    if(isOrdered == false) {
+        submitBuffer(fullBuffer);
+        return;
+    }
+
+    boost::unique_lock<boost::mutex> lock(queueMutex);
+
+    if(isRunning == false) {
+        DBIngestor_error("DBIngestPipeline: Buffer submitted, but the commit threads are not running.\n", NULL);
+    }
+
+    if(chunkId < headChunk) {
+        DBIngestor_error("DBIngestPipeline: Buffer submitted to a chunk that is already finished.\n", NULL);
+    }
+
+    if(fullBuffer->getCurrSize() == 0) {
+        freeBuffers.push_back(fullBuffer);
+        freeCond.notify_all();
+    } else {
+        pendingBuffers[chunkId].push_back(fullBuffer);
+    }
+
+    if(isLastInChunk == true) {
+        finishedChunks.insert(chunkId);
+    }
+
+    releaseOrderedBuffers();
+}
+
+void DBIngestPipeline::releaseOrderedBuffers() {
+    while(true) {
+        map<int, deque<DBIngestBuffer*> >::iterator currChunk = pendingBuffers.find(headChunk);
+
+        if(currChunk != pendingBuffers.end()) {
+            while(currChunk->second.empty() == false) {
+                fullBuffers.push_back(currChunk->second.front());
+                currChunk->second.pop_front();
+                fullCond.notify_one();
+            }
+
+            pendingBuffers.erase(currChunk);
+        }
+
+        if(finishedChunks.count(headChunk) == 0) {
+            break;
+        }
+
+        //the head chunk is done, the producers of the next chunk may now use the reserved buffer
+        finishedChunks.erase(headChunk);
+        headChunk++;
+        freeCond.notify_all();
+    }
+}
+
+void DBIngestPipeline::flushBuffer(DBIngestBuffer * producerBuffer) {
+    assert(producerBuffer != NULL);
+
+    if(producerBuffer->getCurrSize() == 0) {
+        return;
+    }
+
+    DBIngestBuffer * fullBuffer = getFreeBuffer();
+    fullBuffer->swapRows(producerBuffer);
+    submitBuffer(fullBuffer);
+}
+
+DBIngestBuffer * DBIngestPipeline::replaceBuffer(int producerId) {
+    assert(producerId >= 0 && producerId < (int)watchedBuffers.size());
+    assert(watchedBuffers[producerId] != NULL);
+    assert(watchedChunks[producerId] >= 0);
+
+    int chunkId = watchedChunks[producerId];
+
+    submitBuffer(watchedBuffers[producerId], chunkId, false);
+    watchedBuffers[producerId] = getFreeBuffer(chunkId);
+
+    return watchedBuffers[producerId];
+}
+
+DBIngestBuffer * DBIngestPipeline::getWatchedBuffer(int producerId) {
+    assert(producerId >= 0 && producerId < (int)watchedBuffers.size());
+
+    return watchedBuffers[producerId];
+}
+
+void DBIngestPipeline::watchBuffer(DBIngestBuffer * producerBuffer, int producerId, int chunkId) {
+    assert(producerId >= 0 && producerId < (int)watchedBuffers.size());
+
+    watchedBuffers[producerId] = producerBuffer;
+    watchedChunks[producerId] = chunkId;
+}
+
+void DBIngestPipeline::setNumProducers(int newNumProducers) {
+    assert(newNumProducers > 0);
+
+    if(isRunning == true) {
+        DBIngestor_error("DBIngestPipeline: The number of producers can only be changed before the pipeline is started.\n", NULL);
+    }
+
+    for(int i=0; i<producerMutexes.size(); i++) {
+        delete producerMutexes.at(i);
+    }
+    producerMutexes.clear();
+
+    for(int i=0; i<newNumProducers; i++) {
+        producerMutexes.push_back(new boost::mutex());
+    }
+
+    watchedBuffers.assign(newNumProducers, (DBIngestBuffer*)NULL);
+    watchedChunks.assign(newNumProducers, -1);
+}
+
+void DBIngestPipeline::flushLoop() {
+    boost::unique_lock<boost::mutex> lock(flushMutex);
+
+    //look a few times per period, so that rows do not wait much longer than maxLatency
+    boost::posix_time::time_duration checkInterval = boost::posix_time::microseconds(max((int64_t)1, maxLatency / 4000));
+
+    while(isFlushing == true) {
+        flushCond.timed_wait(lock, checkInterval);
+
+        for(int i=0; i<producerMutexes.size() && isFlushing == true; i++) {
+            //a producer holding its lock is adding a row and checks the age of its buffer itself
+            boost::unique_lock<boost::mutex> producerLock(*producerMutexes.at(i), boost::try_to_lock);
+
+            if(producerLock.owns_lock() == false) {
+                continue;
+            }
+
+            DBIngestBuffer * currBuffer = watchedBuffers.at(i);
+
+            if(currBuffer != NULL && currBuffer->getCurrSize() > 0 &&
+               IngestStats::getTimestamp() - currBuffer->getFirstRowTime() >= maxLatency) {
+                if(watchedChunks.at(i) < 0) {
+                    flushBuffer(currBuffer);
+                } else {
+                    replaceBuffer(i);
+                }
+            }
+        }
+    }
+}
+
+void DBIngestPipeline::finish() {
+    if(isRunning == false) {
+        return;
+    }
+
+    if(maxLatency > 0) {
+        {
+            boost::unique_lock<boost::mutex> lock(flushMutex);
+            isFlushing = false;
+            flushCond.notify_all();
+        }
+
+        flushThreads.join_all();
+
+        watchedBuffers.assign(watchedBuffers.size(), (DBIngestBuffer*)NULL);
+    }
+
+    {
+        boost::unique_lock<boost::mutex> lock(queueMutex);
+
+        if(pendingBuffers.empty() == false || finishedChunks.empty() == false) {
+            DBIngestor_error("DBIngestPipeline: Pipeline finished, but not all chunks have been closed.\n", NULL);
+        }
+
+        isFinished = true;
+        fullCond.notify_all();
+    }
+
+    commitThreads.join_all();
+    isRunning = false;
+}
+
+int DBIngestPipeline::getQueueDepth() {
+    return queueDepth;
+}
+
+int DBIngestPipeline::getNumConnections() {
+    return (int)myDBAbstractors.size();
+}
+
+bool DBIngestPipeline::getIsOrdered() {
+    return isOrdered;
+}
+
+void DBIngestPipeline::setIsOrdered(bool newIsOrdered) {
+    if(isRunning == true) {
+        DBIngestor_error("DBIngestPipeline: The commit order can only be changed before the pipeline is started.\n", NULL);
+    }
+
+    isOrdered = newIsOrdered;
+}
+
+void DBIngestPipeline::setStageTiming(bool newStageTiming) {
+    if(isRunning == true) {
+        DBIngestor_error("DBIngestPipeline: The timing can only be switched on or off before the pipeline is started.\n", NULL);
+    }
+    
+    for(int i=0; i<commitBuffers.size(); i++) {
+        commitStats.at(i).reset();
+        commitBuffers.at(i)->setIngestStats(newStageTiming == true ? &commitStats.at(i) : NULL);
+    }
+}
+
+void DBIngestPipeline::setMaxBufferBytes(int64_t newMaxBytes) {
+    assert(newMaxBytes >= 0);
+    
+    if(isRunning == true) {
+        DBIngestor_error("DBIngestPipeline: The byte budget can only be changed before the pipeline is started.\n", NULL);
+    }
+    
+    for(int i=0; i<buffers.size(); i++) {
+        buffers.at(i)->setMaxBytes(newMaxBytes);
+    }
+    
+    for(int i=0; i<commitBuffers.size(); i++) {
+        commitBuffers.at(i)->setMaxBytes(newMaxBytes);
+    }
+}
+
+void DBIngestPipeline::setAdaptiveStmtSize(bool newAdaptiveStmtSize, int64_t maxStmtLatency) {
+    if(isRunning == true) {
+        DBIngestor_error("DBIngestPipeline: The tuning of the statement size can only be switched on or off before the pipeline is started.\n", NULL);
+    }
+    
+    //the producer buffers never commit
+    for(int i=0; i<commitBuffers.size(); i++) {
+        commitBuffers.at(i)->setAdaptiveStmtSize(newAdaptiveStmtSize, maxStmtLatency);
+    }
+}
+
+void DBIngestPipeline::setCommitInterval(int64_t newIntervalRows, int64_t newIntervalBytes, int64_t newIntervalTime) {
+    if(isRunning == true) {
+        DBIngestor_error("DBIngestPipeline: The commit interval can only be changed before the pipeline is started.\n", NULL);
+    }
+    
+    for(int i=0; i<commitBuffers.size(); i++) {
+        commitBuffers.at(i)->setCommitInterval(newIntervalRows, newIntervalBytes, newIntervalTime);
+    }
+}
+
+void DBIngestPipeline::setCommitsInputPrefix(bool newCommitsInputPrefix) {
+    if(isRunning == true) {
+        DBIngestor_error("DBIngestPipeline: Whether the committed rows are a prefix of the input can only be changed before the pipeline is started.\n", NULL);
+    }
+    
+    for(int i=0; i<commitBuffers.size(); i++) {
+        commitBuffers.at(i)->setCommitsInputPrefix(newCommitsInputPrefix);
+    }
+}
+
+void DBIngestPipeline::setMaxLatency(int64_t newMaxLatency) {
+    assert(newMaxLatency >= 0);
+    
+    if(isRunning == true) {
+        DBIngestor_error("DBIngestPipeline: The maximum latency can only be changed before the pipeline is started.\n", NULL);
+    }
+    
+    maxLatency = newMaxLatency;
+    
+    for(int i=0; i<buffers.size(); i++) {
+        buffers.at(i)->setMaxLatency(newMaxLatency);
+    }
+    
+    for(int i=0; i<commitBuffers.size(); i++) {
+        commitBuffers.at(i)->setMaxLatency(newMaxLatency);
+    }
+}
+
+void DBIngestPipeline::setTrackLatency(bool newTrackLatency) {
+    if(isRunning == true) {
+        DBIngestor_error("DBIngestPipeline: The latency can only be tracked if set before the pipeline is started.\n", NULL);
+    }
+    
+    //the timestamps of the rows are swapped along with them, so every buffer needs to take them
+    for(int i=0; i<buffers.size(); i++) {
+        buffers.at(i)->setTrackLatency(newTrackLatency);
+    }
+    
+    for(int i=0; i<commitBuffers.size(); i++) {
+        commitBuffers.at(i)->setTrackLatency(newTrackLatency);
+    }
+}
+
+void DBIngestPipeline::getRowLatency(int64_t * numRows, int64_t * sumLatency, int64_t * maxRowLatency) {
+    assert(isRunning == false);
+    assert(numRows != NULL);
+    assert(sumLatency != NULL);
+    assert(maxRowLatency != NULL);
+    
+    *numRows = 0;
+    *sumLatency = 0;
+    *maxRowLatency = 0;
+    
+    for(int i=0; i<commitBuffers.size(); i++) {
+        *numRows += commitBuffers.at(i)->getLatencyRows();
+        *sumLatency += commitBuffers.at(i)->getLatencySum();
+        if(commitBuffers.at(i)->getLatencyMax() > *maxRowLatency) {
+            *maxRowLatency = commitBuffers.at(i)->getLatencyMax();
+        }
+    }
+}
+
+int64_t DBIngestPipeline::getMaxBytesUsed() {
+    assert(isRunning == false);
+    
+    //every full buffer has been swapped into one of the commit buffers
+    int64_t maxBytesUsed = 0;
+    for(int i=0; i<commitBuffers.size(); i++) {
+        if(commitBuffers.at(i)->getMaxBytesUsed() > maxBytesUsed) {
+            maxBytesUsed = commitBuffers.at(i)->getMaxBytesUsed();
+        }
+    }
+    
+    return maxBytesUsed;
+}
+
+void DBIngestPipeline::mergeIngestStats(IngestStats & totalStats) {
+    assert(isRunning == false);
+    
+    for(int i=0; i<commitStats.size(); i++) {
+        totalStats.merge(commitStats.at(i));
+    }
+}
+
+void DBIngestPipeline::commitLoop(int connId) {
+    DBIngestBuffer * commitBuffer = commitBuffers.at(connId);
+
+    while(true) {
+        DBIngestBuffer * fullBuffer;
+
+        {
+            boost::unique_lock<boost::mutex> lock(queueMutex);
+
+            while(fullBuffers.empty() && isFinished == false) {
+                fullCond.wait(lock);
+            }
+
+            //only leave once everything that has been submitted is committed
+            if(fullBuffers.empty()) {
+                break;
+            }
+
+            fullBuffer = fullBuffers.front();
+            fullBuffers.pop_front();
+        }
+
+        //take over the rows and give the (now empty) buffer back to the producer
+        commitBuffer->swapRows(fullBuffer);
+
+        {
+            boost::unique_lock<boost::mutex> lock(queueMutex);
+            freeBuffers.push_back(fullBuffer);
+            freeCond.notify_all();
+        }
+
+        commitBuffer->commit();
+        commitBuffer->clear();
+    }
+
+    //the last statement may still be running on this connection
+    myDBAbstractors.at(connId)->waitStmt();
+}
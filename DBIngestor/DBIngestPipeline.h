@@ -0,0 +1,419 @@
+/*  
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>, 
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file DBIngestPipeline.h
+ \brief Pipelined Ingest Class
+
+ This class overlaps the parsing of the data with the commits to the database.
+ Rows are parsed into a set of DBIngestBuffers, while dedicated commit threads
+ (one per database connection) drain full buffers through their DBAbstractor.
+ */
+
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
+#include <boost/thread.hpp>
+#include "Schema.h"
+#include "DBAbstractor.h"
+#include "DBIngestBuffer.h"
+#include "IngestStats.h"
+
+#ifndef DBIngestor_DBIngestPipeline_h
+#define DBIngestor_DBIngestPipeline_h
+
+namespace DBIngest {
+    /*! \class DBIngestPipeline
+     \brief DBIngestPipeline class
+
+     Double (or multi) buffered ingest: the producer (i.e. the reader loop) fills one DBIngestBuffer,
+     while the commit threads send previously filled buffers to the database. There is one commit thread
+     per DBAbstractor (i.e. per connection) and all of them take their work from the same queue, so a full
+     buffer is committed by whichever connection becomes free first. Full buffers are handed over to a
+     commit thread by swapping their rows into its commit buffer, which is the only buffer that ever talks
+     to that DBAbstractor and holds its prepared statements. The producer buffer is returned to the free
+     list right after the swap, so that parsing can continue while the server round trip is running.
+
+     Several producers (i.e. parallel parsing threads) may fill buffers at the same time. In that case the input is
+     split into chunks numbered from 0 onwards and each producer tags its buffers with the chunk they belong to. In
+     ordered mode, buffers are handed to the commit threads chunk by chunk and in the order they were submitted
+     within a chunk, so that the rows are sent to the database in input order (with more than one connection the
+     commits of consecutive buffers may still overlap). In unordered mode, buffers are committed as soon as they are
+     full.
+
+     If a maximum latency is set, a flush thread hands the buffer of a producer over to the commit threads once its
+     oldest row has waited that long, even if the producer is blocked waiting for the next row. Every producer registers
+     its buffer with watchBuffer() and holds its producer lock (lockProducer()) while it adds a row. A single producer
+     submits full buffers through flushBuffer(), so that it keeps filling the same buffer object. Producers working in
+     chunks hand full buffers over with replaceBuffer() instead and take the buffer to fill from getWatchedBuffer()
+     every time they hold the lock, since the flush thread may have replaced it. With several producers, their number
+     needs to be set with setNumProducers() before start().
+
+     While the pipeline is running, the DBAbstractors MUST NOT be used by any other thread. Setting
+     savepoints and disabling keys needs to be done before start() and releasing savepoints and
+     enabling keys after finish().
+     */
+	class DBIngestPipeline {
+
+	private:
+        /*! \var DBDataSchema::Schema * myDBSchema
+         pointer to the associated Schema
+         */
+        DBDataSchema::Schema * myDBSchema;
+
+        /*! \var std::vector<DBServer::DBAbstractor*> myDBAbstractors
+         the DBAbstractor objects used by the commit threads, one per thread
+         */
+        std::vector<DBServer::DBAbstractor*> myDBAbstractors;
+
+        /*! \var int bufferSize
+         number of rows in each of the buffers
+         */
+        int bufferSize;
+
+        /*! \var int queueDepth
+         maximum number of full buffers waiting to be committed
+         */
+        int queueDepth;
+
+        /*! \var std::vector<DBIngestBuffer*> buffers
+         all the buffers that are filled by the producer
+         */
+        std::vector<DBIngestBuffer*> buffers;
+
+        /*! \var std::deque<DBIngestBuffer*> freeBuffers
+         buffers that are empty and can be filled by the producer
+         */
+        std::deque<DBIngestBuffer*> freeBuffers;
+
+        /*! \var std::deque<DBIngestBuffer*> fullBuffers
+         buffers that are waiting to be committed
+         */
+        std::deque<DBIngestBuffer*> fullBuffers;
+
+        /*! \var std::vector<DBIngestBuffer*> commitBuffers
+         the buffers owned by the commit threads. these hold the prepared statements of each connection.
+         */
+        std::vector<DBIngestBuffer*> commitBuffers;
+
+        /*! \var std::vector<IngestStats> commitStats
+         the timing counters of the commit threads, one per commit buffer
+         */
+        std::vector<IngestStats> commitStats;
+
+        /*! \var boost::thread_group commitThreads
+         the threads draining fullBuffers
+         */
+        boost::thread_group commitThreads;
+
+        /*! \var bool isRunning
+         true between start() and finish()
+         */
+        bool isRunning;
+
+        /*! \var boost::mutex queueMutex
+         mutex guarding freeBuffers, fullBuffers and isFinished
+         */
+        boost::mutex queueMutex;
+
+        /*! \var boost::condition_variable freeCond
+         signaled whenever a buffer is returned to freeBuffers
+         */
+        boost::condition_variable freeCond;
+
+        /*! \var boost::condition_variable fullCond
+         signaled whenever a buffer is added to fullBuffers or the pipeline is finished
+         */
+        boost::condition_variable fullCond;
+
+        /*! \var bool isFinished
+         set to true, once the producer has submitted the last buffer
+         */
+        bool isFinished;
+
+        /*! \var bool isOrdered
+         if true, buffers are committed in chunk order (see submitBuffer)
+         */
+        bool isOrdered;
+
+        /*! \var int headChunk
+         in ordered mode, the chunk whose buffers are currently passed on to the commit threads
+         */
+        int headChunk;
+
+        /*! \var std::map<int, std::deque<DBIngestBuffer*> > pendingBuffers
+         in ordered mode, full buffers of chunks that are not yet allowed to be committed
+         */
+        std::map<int, std::deque<DBIngestBuffer*> > pendingBuffers;
+
+        /*! \var std::set<int> finishedChunks
+         in ordered mode, chunks whose last buffer has been submitted, but which are not yet passed on
+         */
+        std::set<int> finishedChunks;
+
+        /*! \var int64_t maxLatency
+         if larger than 0, the nanoseconds a row may wait in a producer buffer before it is flushed
+         */
+        int64_t maxLatency;
+
+        /*! \var std::vector<DBIngestBuffer*> watchedBuffers
+         the buffer of each producer the flush thread checks, NULL if none
+         */
+        std::vector<DBIngestBuffer*> watchedBuffers;
+
+        /*! \var std::vector<int> watchedChunks
+         the chunk each watched buffer belongs to, -1 if the producer does not work in chunks
+         */
+        std::vector<int> watchedChunks;
+
+        /*! \var std::vector<boost::mutex*> producerMutexes
+         one mutex per producer guarding its watched buffer and its rows, held by the producer while it adds a row
+         */
+        std::vector<boost::mutex*> producerMutexes;
+
+        /*! \var boost::mutex flushMutex
+         mutex guarding isFlushing
+         */
+        boost::mutex flushMutex;
+
+        /*! \var boost::condition_variable flushCond
+         signaled when the flush thread needs to stop
+         */
+        boost::condition_variable flushCond;
+
+        /*! \var bool isFlushing
+         true while the flush thread is running
+         */
+        bool isFlushing;
+
+        /*! \var boost::thread_group flushThreads
+         the flush thread, if a maximum latency is set
+         */
+        boost::thread_group flushThreads;
+
+        /*! \brief initialises the buffers of the pipeline
+         */
+        void init(DBDataSchema::Schema * newSchema, int newBufferSize, int newQueueDepth);
+
+        /*! \brief creates a buffer of the pipeline
+         \param DBServer::DBAbstractor * thisDBAbstractor: the abstractor the buffer commits to
+         \param bool columnLayout: if true, a DBIngestColumnBuffer is created, otherwise a DBIngestBuffer
+         */
+        DBIngestBuffer * newIngestBuffer(DBServer::DBAbstractor * thisDBAbstractor, bool columnLayout);
+
+        /*! \brief main loop of a commit thread
+         \param int connId: index of the DBAbstractor (and commit buffer) this thread is using
+
+         Waits for full buffers, swaps their rows into the commit buffer, returns the emptied buffer
+         to the producer and commits the rows to the database.*/
+        void commitLoop(int connId);
+
+        /*! \brief main loop of the flush thread
+         
+         Checks the watched buffers a few times per maxLatency and flushes them, if their rows are too old.*/
+        void flushLoop();
+
+        /*! \brief passes the buffers of the head chunk on to the commit threads
+         
+         Needs to be called with queueMutex locked. Moves the pending buffers of the head chunk to fullBuffers and
+         advances to the next chunk as long as the head chunk is finished.*/
+        void releaseOrderedBuffers();
+
+	public:
+        /*! \brief constructor of a DBIngestPipeline
+         \param DBDataSchema::Schema * newSchema: the Schema used for reading and storing the data in the database
+         \param DBServer::DBAbstractor * newDBAbstractor: the (connected) database abstractor used for the commits
+         \param int newBufferSize: number of rows in each buffer
+         \param int newQueueDepth: maximum number of full buffers waiting to be committed
+
+         Initialises the pipeline and allocates newQueueDepth + 1 buffers for the producer.*/
+        DBIngestPipeline(DBDataSchema::Schema * newSchema, DBServer::DBAbstractor * newDBAbstractor, int newBufferSize, int newQueueDepth);
+
+        /*! \brief constructor of a DBIngestPipeline committing through several connections
+         \param DBDataSchema::Schema * newSchema: the Schema used for reading and storing the data in the database
+         \param std::vector<DBServer::DBAbstractor*> & newDBAbstractors: the (connected) database abstractors, one commit thread is run for each
+         \param int newBufferSize: number of rows in each buffer
+         \param int newQueueDepth: maximum number of full buffers waiting to be committed
+
+         Initialises the pipeline and allocates newQueueDepth + 1 buffers for the producer. Each DBAbstractor needs to have
+         its own connection to the server.*/
+        DBIngestPipeline(DBDataSchema::Schema * newSchema, std::vector<DBServer::DBAbstractor*> & newDBAbstractors, int newBufferSize, int newQueueDepth);
+
+        ~DBIngestPipeline();
+
+        /*! \brief starts the commit threads
+         */
+        void start();
+
+        /*! \brief retrieves an empty buffer for the producer to fill
+
+         \return returns an empty DBIngestBuffer
+
+         Blocks until a buffer is available, i.e. until the commit threads have caught up.*/
+        DBIngestBuffer * getFreeBuffer();
+
+        /*! \brief retrieves an empty buffer for a producer working on the given chunk
+         \param int chunkId: the chunk the buffer will be filled with
+
+         \return returns an empty DBIngestBuffer
+
+         Blocks until a buffer is available. In ordered mode the last free buffer is reserved for the producer
+         of the head chunk, otherwise producers working ahead could take all buffers and stall the pipeline.*/
+        DBIngestBuffer * getFreeBuffer(int chunkId);
+
+        /*! \brief hands a filled buffer over to the commit threads
+         \param DBIngestBuffer * fullBuffer: a buffer obtained through getFreeBuffer()
+
+         The producer MUST NOT touch the buffer after submitting it. Submitting empty buffers is allowed, they
+         are directly returned to the free list.*/
+        void submitBuffer(DBIngestBuffer * fullBuffer);
+
+        /*! \brief hands a filled buffer of a given chunk over to the commit threads
+         \param DBIngestBuffer * fullBuffer: a buffer obtained through getFreeBuffer(chunkId)
+         \param int chunkId: the chunk the rows in the buffer belong to
+         \param bool isLastInChunk: true, if this is the last buffer of the chunk
+
+         In ordered mode, every chunk from 0 onwards needs to be closed by submitting a buffer with isLastInChunk
+         set (which may be empty), otherwise the following chunks are never committed.*/
+        void submitBuffer(DBIngestBuffer * fullBuffer, int chunkId, bool isLastInChunk);
+
+        /*! \brief hands the rows of a producer buffer over to the commit threads, keeping the buffer itself
+         \param DBIngestBuffer * producerBuffer: a buffer obtained through getFreeBuffer()
+
+         Moves the rows into a free buffer (waiting for one if needed), which is then submitted. The producer buffer is empty
+         afterwards and can be filled further. If the buffer is watched, the producer lock needs to be held.*/
+        void flushBuffer(DBIngestBuffer * producerBuffer);
+
+        /*! \brief submits the watched buffer of a producer working in chunks and watches a new one instead
+         \param int producerId: the producer (starting at 0)
+         \return the new buffer of the producer
+
+         Unlike flushBuffer(), the producer never holds more than one buffer, which the reservation of the head chunk in
+         ordered mode relies on. The producer lock needs to be held.*/
+        DBIngestBuffer * replaceBuffer(int producerId);
+
+        /*! \brief returns the buffer watched for a producer, NULL if none. The producer lock needs to be held.
+         \param int producerId: the producer (starting at 0)*/
+        DBIngestBuffer * getWatchedBuffer(int producerId);
+
+        /*! \brief sets the buffer the flush thread keeps an eye on
+         \param DBIngestBuffer * producerBuffer: the buffer the producer fills, NULL to stop watching
+         \param int producerId: the producer filling the buffer (starting at 0)
+         \param int chunkId: the chunk the rows of the buffer belong to, -1 if the producer does not work in chunks
+
+         The producer lock needs to be held, if a buffer is watched already. Stop watching the buffer before submitting it.*/
+        void watchBuffer(DBIngestBuffer * producerBuffer, int producerId = 0, int chunkId = -1);
+
+        /*! \brief sets the number of producers filling watched buffers. Can only be changed before start().
+         \param int newNumProducers: number of producers, defaults to 1*/
+        void setNumProducers(int newNumProducers);
+
+        /*! \brief takes the lock of a producer, if the pipeline has a flush thread
+         \param int producerId: the producer (starting at 0)
+         
+         The producer holds this lock while it adds a row to a watched buffer, so that the flush thread never sees half a row.*/
+        inline void lockProducer(int producerId = 0) {
+            if(maxLatency > 0) {
+                producerMutexes[producerId]->lock();
+            }
+        }
+
+        inline void unlockProducer(int producerId = 0) {
+            if(maxLatency > 0) {
+                producerMutexes[producerId]->unlock();
+            }
+        }
+
+        /*! \brief finishes the pipeline
+
+         Waits until all submitted buffers are committed and joins the commit threads. Buffers that the producer
+         still holds are NOT committed, submit them before calling finish().*/
+        void finish();
+
+        int getQueueDepth();
+
+        int getNumConnections();
+
+        bool getIsOrdered();
+
+        /*! \brief sets ordered or unordered mode. Can only be changed before start().
+         */
+        void setIsOrdered(bool newIsOrdered);
+
+        /*! \brief switches the timing of the commit threads on or off. Can only be changed before start().
+         */
+        void setStageTiming(bool newStageTiming);
+
+        /*! \brief sets the byte budget of all buffers (see DBIngestBuffer::setMaxBytes). Can only be changed before start().
+         
+         Every buffer of the pipeline may hold up to newMaxBytes bytes, i.e. up to (queueDepth + 1 + number of connections)
+         times that much are held at once.*/
+        void setMaxBufferBytes(int64_t newMaxBytes);
+
+        /*! \brief switches the tuning of the statement size of the commit buffers on or off (see DBIngestBuffer::setAdaptiveStmtSize).
+         Can only be changed before start().
+         
+         Every connection tunes its statement size on its own.*/
+        void setAdaptiveStmtSize(bool newAdaptiveStmtSize, int64_t maxStmtLatency);
+
+        /*! \brief sets when the commit threads close their transactions (see DBIngestBuffer::setCommitInterval). Can only be changed
+         before start().
+         
+         Every connection commits its own transaction, the limits apply to each of them separately.*/
+        void setCommitInterval(int64_t newIntervalRows, int64_t newIntervalBytes, int64_t newIntervalTime);
+
+        /*! \brief tells the commit threads whether the rows they commit are the first rows of the input (see
+         DBIngestBuffer::setCommitsInputPrefix). This is only the case with one connection and the rows arriving in
+         the order of the input. Can only be changed before start().*/
+        void setCommitsInputPrefix(bool newCommitsInputPrefix);
+
+        /*! \brief sets how long rows may wait in a producer buffer (see DBIngestBuffer::setMaxLatency). Can only be changed before
+         start().
+         \param int64_t newMaxLatency: nanoseconds, 0 for no limit
+         
+         With a maximum latency, start() runs a flush thread for the buffer set with watchBuffer().*/
+        void setMaxLatency(int64_t newMaxLatency);
+
+        /*! \brief switches the measuring of the row latency of all buffers on or off. Can only be changed before start().
+         */
+        void setTrackLatency(bool newTrackLatency);
+
+        /*! \brief returns the latency of the rows committed so far, summed over all connections
+         \param int64_t * numRows: the number of rows measured
+         \param int64_t * sumLatency: the sum of the latencies of these rows in nanoseconds
+         \param int64_t * maxRowLatency: the largest latency of a row in nanoseconds
+
+         Call this after finish().*/
+        void getRowLatency(int64_t * numRows, int64_t * sumLatency, int64_t * maxRowLatency);
+
+        /*! \brief returns the largest number of bytes a committed buffer has held
+         
+         Call this after finish().*/
+        int64_t getMaxBytesUsed();
+
+        /*! \brief adds the timing counters of all commit threads to the given counters
+         \param IngestStats & totalStats: the counters to add to
+
+         Call this after finish().*/
+        void mergeIngestStats(IngestStats & totalStats);
+	};
+}
+
+#endif
@@ -19,11 +19,17 @@
 
 #include "DBIngestor.h"
 #include "DBIngestBuffer.h"
+#include "DBIngestColumnBuffer.h"
+#include "DBIngestPipeline.h"
+#include "DBAdaptorsFactory.h"
+#include "RowContext.h"
 #include "dbingestor_error.h"
 #include <assert.h>
 #include <stdio.h>
 #include <string>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 
 #include "DType.h"
 
@@ -32,12 +38,41 @@ using namespace std;
 
 #define DBING_RESULT_BUFFER_SIZE 128
 
+//number of chunks per parsing thread the input is split into for parallel parsing
+#define DBING_CHUNKS_PER_THREAD 4
+
+namespace {
+    //adds the time since startTime (less the time already accounted to other stages) to a stage and returns the current time
+    inline int64_t addStageTime(IngestStats * stats, IngestStage thisStage, int64_t startTime, int64_t nestedTime) {
+        int64_t currTime = IngestStats::getTimestamp();
+        stats->addTime(thisStage, currTime - startTime - nestedTime);
+        
+        return currTime;
+    }
+}
+
 DBIngestor::DBIngestor() {
     disableKeys = 0;
     enableKeys = 0;
     askUserToValidateRead = 1;
     resumeMode = false;
     isDryRun = false;
+    commitIntervalRows = 0;
+    commitIntervalBytes = 0;
+    commitIntervalSeconds = 0;
+    pipelineDepth = 0;
+    numConnections = 1;
+    numParseThreads = 1;
+    orderedCommit = true;
+    stageTiming = false;
+    maxBufferBytes = 0;
+    maxBufferBytesUsed = 0;
+    maxFlushLatency = 0;
+    meanRowLatency = 0;
+    maxRowLatency = 0;
+    adaptiveStmtSize = false;
+    maxStmtLatency = 0;
+    strictRangeCheck = false;
     myDBAbstractor = NULL;
     myDBSchema = NULL;
     myReader = NULL;
@@ -60,6 +95,22 @@ DBIngestor::DBIngestor(DBDataSchema::Schema * newSchema, DBReader::Reader * newR
     askUserToValidateRead = 1;
     resumeMode = false;
     isDryRun = false;
+    commitIntervalRows = 0;
+    commitIntervalBytes = 0;
+    commitIntervalSeconds = 0;
+    pipelineDepth = 0;
+    numConnections = 1;
+    numParseThreads = 1;
+    orderedCommit = true;
+    stageTiming = false;
+    maxBufferBytes = 0;
+    maxBufferBytesUsed = 0;
+    maxFlushLatency = 0;
+    meanRowLatency = 0;
+    maxRowLatency = 0;
+    adaptiveStmtSize = false;
+    maxStmtLatency = 0;
+    strictRangeCheck = false;
     
     setSchema(newSchema);
     setReader(newReader);
@@ -170,100 +221,301 @@ int DBIngestor::ingestData(int lenBuffer) {
     }
         
     myDBAbstractor->setResumeMode(getResumeMode());
+    
+    ingestStats.reset();
+    IngestStats * parseStats = NULL;
+    if(stageTiming == true) {
+        parseStats = &ingestStats;
+    }
 
+    //integers out of range are clamped and counted, unless they should stop the ingest
+    DBDataSchema::setStrictRangeCheck(strictRangeCheck);
+    DBDataSchema::resetNumOutOfRange();
+    
     //first validate schema
     err = validateSchema();
     if(err != 1) {
         DBIngestor_error("DBIngestor: Error in matching the schemas. Check the errors above for information\n", NULL);
     }
     
+    //from here on the schema is only read, the row contexts of the parsing threads share it
+    myDBSchema->compile();
+    
+    //set up the additional connections for committing in parallel
+    myDBAbstractors.clear();
+    myDBAbstractors.push_back(myDBAbstractor);
+    
+    int numWriters = numConnections;
+    if(numWriters > 1 && myDBAbstractor->getSupportsConcurrentWriters() == false) {
+        printf("DBIngestor: The DB adaptor only allows one writer at a time, committing through one connection only.\n");
+        numWriters = 1;
+    }
+    
+    if(numWriters > 1 && isDryRun != true) {
+        DBServer::DBAdaptorsFactory adaptorFac;
+        
+        printf("Opening %i additional connections...\n", numWriters - 1);
+        for(int i=1; i<numWriters; i++) {
+            //copy the settings of the user's adaptor, if it cannot be copied fall back to the factory defaults
+            DBServer::DBAbstractor * newAbstractor = myDBAbstractor->createLike();
+            
+            if(newAbstractor == NULL) {
+                if(dbAdaptorName.length() == 0) {
+                    DBIngestor_error("DBIngestor: Using more than one connection needs the name of the DB adaptor. Please set it with setDBAdaptorName.\n", NULL);
+                }
+                
+                newAbstractor = adaptorFac.getDBAdaptors(dbAdaptorName);
+            }
+            
+            if(newAbstractor->connect(getUsrName(), getPasswd(), getHost(), getPort(), getSocket()) != 1) {
+                DBIngestor_error("DBIngestor: Could not open an additional connection to the database.\n", NULL);
+            }
+            newAbstractor->setResumeMode(getResumeMode());
+            
+            myDBAbstractors.push_back(newAbstractor);
+        }
+        printf("Opening additional connections DONE\n");
+    }
+    
+    //transactions are only committed in between, if there is one
+    bool commitsInBetween = (isDryRun != true && resumeMode != true) &&
+                            (commitIntervalRows > 0 || commitIntervalBytes > 0 || commitIntervalSeconds > 0);
+    
+    //some adaptors restore disabled keys on every commit. disabling them would only slow down the first
+    //part of the ingest, the rest would update the keys row by row anyway
+    bool dropKeys = (disableKeys != 0 && isDryRun != true);
+    if(dropKeys == true && commitsInBetween == true && myDBAbstractor->getKeepsKeysDisabledOnCommit() == false) {
+        printf("DBIngestor: The DB adaptor restores disabled keys when committing. Since the ingest commits in between (see setCommitIntervalRows), the keys are kept.\n");
+        dropKeys = false;
+    }
+    
+    //with several connections, keys are disabled before any transaction is opened, so that
+    //ALTER TABLE does not need to wait for the other connections
+    if(dropKeys == true && myDBAbstractors.size() > 1) {
+        printf("Disabling keys...\n");
+        err = myDBAbstractor->disableKeys(myDBSchema);
+        printf("Disabling keys DONE\n");
+    }
+    
     if(isDryRun != true && resumeMode != true) {
         printf("Setting savepoint...\n");
-        err = myDBAbstractor->setSavepoint();
+        for(int i=0; i<myDBAbstractors.size(); i++) {
+            err = myDBAbstractors.at(i)->setSavepoint();
+        }
         printf("Setting savepoint DONE\n");
     }
     
-    if(disableKeys != 0 && isDryRun != true) {
+    if(dropKeys == true && myDBAbstractors.size() == 1) {
         printf("Disabling keys...\n");
         err = myDBAbstractor->disableKeys(myDBSchema);
         printf("Disabling keys DONE\n");
     }
     
-    DBIngest::DBIngestBuffer * ingestBuff = new DBIngestBuffer(myDBSchema, myDBAbstractor);
-    ingestBuff->setBufferSize(lenBuffer);
-        
-    ingestBuff->setIsDryRun(isDryRun);
+    //the statement size is tuned on the round trip of each statement, which is not measured if the adaptor
+    //returns before the server has answered
+    bool tuneStmtSize = adaptiveStmtSize;
+    if(tuneStmtSize == true && myDBAbstractor->getExecutesAsync() == true) {
+        printf("DBIngestor: The DB adaptor executes statements asynchronously, the statement size is not tuned.\n");
+        tuneStmtSize = false;
+    }
     
-    //loop through the data and ingest
-    myReader->rewind();
-    myReader->skipHeader();
+    //parse in parallel, if the reader can be split into chunks
+    int numWorkers = 1;
+    if(numParseThreads > 1 && isDryRun != true) {
+        if(myReader->getIsSplittable() == true) {
+            numWorkers = numParseThreads;
+        } else {
+            printf("DBIngestor: The reader cannot be split into chunks, parsing with one thread only.\n");
+        }
+    }
     
-    //this is a buffer for the results of various size (double or long long is the maximum?)
-    char result[DBING_RESULT_BUFFER_SIZE];
-    bool isNull;
+    DBIngest::DBIngestBuffer * ingestBuff = NULL;
+    DBIngest::DBIngestPipeline * ingestPipeline = NULL;
+    bool trackLatency = (maxFlushLatency > 0 || stageTiming == true);
+    
+    int64_t txnIntervalRows = 0;
+    int64_t txnIntervalBytes = 0;
+    int64_t txnIntervalTime = 0;
+    if(commitsInBetween == true) {
+        txnIntervalRows = commitIntervalRows;
+        txnIntervalBytes = commitIntervalBytes;
+        txnIntervalTime = commitIntervalSeconds * 1000000000;
+    }
+    
+    //buffers are flushed on time by the pipeline
+    if((pipelineDepth > 0 || myDBAbstractors.size() > 1 || numWorkers > 1 || maxFlushLatency > 0) && isDryRun != true) {
+        //commits are done by the pipeline's commit threads, while we continue parsing here. make sure
+        //there is at least one buffer in the queue for every connection
+        int queueDepth = pipelineDepth;
+        if(queueDepth < (int)myDBAbstractors.size()) {
+            queueDepth = (int)myDBAbstractors.size();
+        }
+        
+        //every parsing thread holds on to the buffer it is currently filling
+        queueDepth += numWorkers - 1;
+        
+        ingestPipeline = new DBIngestPipeline(myDBSchema, myDBAbstractors, lenBuffer, queueDepth);
+        ingestPipeline->setIsOrdered(numWorkers > 1 && orderedCommit == true);
+        ingestPipeline->setStageTiming(stageTiming);
+        ingestPipeline->setMaxBufferBytes(maxBufferBytes);
+        ingestPipeline->setAdaptiveStmtSize(tuneStmtSize, maxStmtLatency);
+        ingestPipeline->setCommitInterval(txnIntervalRows, txnIntervalBytes, txnIntervalTime);
+        ingestPipeline->setCommitsInputPrefix(myDBAbstractors.size() == 1 && (numWorkers == 1 || orderedCommit == true));
+        ingestPipeline->setTrackLatency(trackLatency);
+        ingestPipeline->setMaxLatency(maxFlushLatency * 1000000);
+        ingestPipeline->setNumProducers(numWorkers);
+        ingestPipeline->start();
+    } else {
+        //adaptors that bind whole columns are fed from a column oriented buffer
+        if(myDBAbstractor->getSupportsColumnBinding() == true) {
+            ingestBuff = new DBIngestColumnBuffer(myDBSchema, myDBAbstractor);
+        } else {
+            ingestBuff = new DBIngestBuffer(myDBSchema, myDBAbstractor);
+        }
+        ingestBuff->setBufferSize(lenBuffer);
+        ingestBuff->setMaxBytes(maxBufferBytes);
+        ingestBuff->setAdaptiveStmtSize(tuneStmtSize, maxStmtLatency);
+        ingestBuff->setCommitInterval(txnIntervalRows, txnIntervalBytes, txnIntervalTime);
+        ingestBuff->setTrackLatency(trackLatency);
+        
+        ingestBuff->setIsDryRun(isDryRun);
+        ingestBuff->setIngestStats(parseStats);
+    }
     
     //performance output stuff
     int64_t counter = 0;
     boost::posix_time::ptime startTime;
     boost::posix_time::ptime endTime;
-    startTime = boost::posix_time::microsec_clock::universal_time();
-    
-    printf("Starting ingest...\n");
+    int64_t wallStartTime = IngestStats::getTimestamp();
     
-    while(myReader->getNextRow()) {
-        myDBSchema->prepareSchemaForNextRow();
+    if(numWorkers > 1) {
+        startTime = boost::posix_time::microsec_clock::universal_time();
+        
+        printf("Starting ingest with %i parsing threads...\n", numWorkers);
+        
+        counter = parseParallel(ingestPipeline, numWorkers);
+    } else {
+        //with the pipeline, we keep filling the same buffer and only hand its rows over. the flush thread may
+        //do so as well while we are waiting for the next row
+        if(ingestPipeline != NULL) {
+            ingestBuff = ingestPipeline->getFreeBuffer();
+            ingestPipeline->watchBuffer(ingestBuff);
+        }
         
-        ingestBuff->newRow();
+        DBDataSchema::RowContext rowContext(myDBSchema);
+        rowContext.setIngestStats(parseStats);
+        myReader->setRowContext(&rowContext);
         
-        for(int i=0; i<myDBSchema->getArrSchemaItems().size(); i++) {
-            //skip any schema item that we donot want to add to the database
-            if(myDBSchema->getArrSchemaItems().at(i)->getColumnName().compare(EMPTY_SCHEMAITEM_NAME) == 0) {
-                continue;
+        //loop through the data and ingest
+        myReader->rewind();
+        myReader->skipHeader();
+        
+        startTime = boost::posix_time::microsec_clock::universal_time();
+        
+        printf("Starting ingest...\n");
+        
+        while(readNextRow(myReader)) {
+            rowContext.nextRow();
+            
+            //hand full buffers over to the commit thread, instead of letting newRow commit them
+            if(ingestPipeline != NULL) {
+                ingestPipeline->lockProducer();
+                
+                if(ingestBuff->isFull()) {
+                    ingestPipeline->flushBuffer(ingestBuff);
+                }
             }
-
-            isNull = myReader->getItemInRow(myDBSchema->getArrSchemaItems().at(i)->getDataDesc(), 1, 1, &result);
             
-            err = ingestBuff->addToRow(result, isNull, myDBSchema->getArrSchemaItems().at(i));
+            ingestBuff->newRow();
+            
+            readRow(myReader, ingestBuff, counter);
             
-            if(err != 1) {
-                printf("Error in reading line %i\n", counter);
-                printf("Problem with schema item number: %i\n", i);
-                DBIngestor_error("DBIngestor: Ingesting NULL in column that is set IS NOT NULL!\n", NULL);
+            if(ingestPipeline != NULL) {
+                ingestPipeline->unlockProducer();
             }
             
-            //if this was a string, free it on the reader side... it was already copied somewhere else...
-            if(myDBSchema->getArrSchemaItems().at(i)->getDataDesc()->getDataObjDType() == DBDataSchema::DT_STRING) {
-                if(myDBSchema->getArrSchemaItems().at(i)->getDataDesc()->getIsConstItem() != true)
-                    free(*(char**)result);
+            counter++;
+            
+            if(performanceMeter != -1 && counter % performanceMeter == 0) {
+                endTime = boost::posix_time::microsec_clock::universal_time();
+                printf("Time took to ingest %lld (current %lld) rows: %lld ms\n", performanceMeter, counter, (endTime-startTime).total_milliseconds());
+                fflush(stdout);
+                startTime = boost::posix_time::microsec_clock::universal_time();
             }
         }
         
-        counter++;
-        
-        if(performanceMeter != -1 && counter % performanceMeter == 0) {
-            endTime = boost::posix_time::microsec_clock::universal_time();
-            printf("Time took to ingest %lld (current %lld) rows: %lld ms\n", performanceMeter, counter, (endTime-startTime).total_milliseconds());
-            fflush(stdout);
-            startTime = boost::posix_time::microsec_clock::universal_time();
+        if(ingestPipeline != NULL) {
+            ingestPipeline->lockProducer();
+            ingestPipeline->flushBuffer(ingestBuff);
+            ingestPipeline->watchBuffer(NULL);
+            ingestPipeline->unlockProducer();
+            
+            //the buffer is empty now and goes back to the free list
+            ingestPipeline->submitBuffer(ingestBuff);
         }
+        
+        myReader->setRowContext(NULL);
     }
 
-    if(isDryRun != true) {
-        ingestBuff->commit();
+    if(ingestPipeline != NULL) {
+        ingestPipeline->finish();
+        
+        if(stageTiming == true) {
+            ingestPipeline->mergeIngestStats(ingestStats);
+        }
+        
+        maxBufferBytesUsed = ingestPipeline->getMaxBytesUsed();
+    } else {
+        if(isDryRun != true) {
+            ingestBuff->commit();
+            myDBAbstractor->waitStmt();
+        }
+        
+        maxBufferBytesUsed = ingestBuff->getMaxBytesUsed();
+    }
+    
+    meanRowLatency = 0;
+    maxRowLatency = 0;
+    if(trackLatency == true) {
+        int64_t latencyRows;
+        int64_t latencySum;
+        
+        if(ingestPipeline != NULL) {
+            ingestPipeline->getRowLatency(&latencyRows, &latencySum, &maxRowLatency);
+        } else {
+            latencyRows = ingestBuff->getLatencyRows();
+            latencySum = ingestBuff->getLatencySum();
+            maxRowLatency = ingestBuff->getLatencyMax();
+        }
+        
+        if(latencyRows > 0) {
+            meanRowLatency = latencySum / latencyRows;
+        }
     }
+    
+    int64_t wallTime = IngestStats::getTimestamp() - wallStartTime;
 
     if(performanceMeter != -1) {
         endTime = boost::posix_time::microsec_clock::universal_time();
         printf("Time took to ingest %lld (current %lld) rows: %lld ms\n", performanceMeter, counter, (endTime-startTime).total_milliseconds());
+        printf("Largest buffer: %lld bytes\n", (long long)maxBufferBytesUsed);
         fflush(stdout);
         startTime = boost::posix_time::microsec_clock::universal_time();
     }
 
-    delete ingestBuff;
+    if(ingestPipeline != NULL) {
+        delete ingestPipeline;
+    } else {
+        delete ingestBuff;
+    }
     
     printf("Ingest DONE\n");
+    
+    if(DBDataSchema::getNumOutOfRange() > 0) {
+        printf("DBIngestor: Warning: %lld integers were out of range for their data type and have been stored as the closest value.\n", (long long)DBDataSchema::getNumOutOfRange());
+    }
 
-    if(enableKeys != 0 && isDryRun != true) {
+    if(enableKeys != 0 && isDryRun != true && myDBAbstractors.size() == 1) {
         printf("Re-enabling keys...\n");
         err = myDBAbstractor->enableKeys(myDBSchema);
         printf("Re-enabling key DONE\n");
@@ -271,13 +523,207 @@ int DBIngestor::ingestData(int lenBuffer) {
 
     if(isDryRun != true && resumeMode != true) {
         printf("Releasing savepoint...\n");
-        myDBAbstractor->releaseSavepoint();
+        for(int i=0; i<myDBAbstractors.size(); i++) {
+            myDBAbstractors.at(i)->releaseSavepoint();
+        }
         printf("Releasing savepoint DONE\n");
     }
     
+    //with several connections, keys are only enabled once all the transactions are closed
+    if(enableKeys != 0 && isDryRun != true && myDBAbstractors.size() > 1) {
+        printf("Re-enabling keys...\n");
+        err = myDBAbstractor->enableKeys(myDBSchema);
+        printf("Re-enabling key DONE\n");
+    }
+    
+    //close the additional connections, the first one belongs to the user
+    for(int i=1; i<myDBAbstractors.size(); i++) {
+        myDBAbstractors.at(i)->disconnect();
+        delete myDBAbstractors.at(i);
+    }
+    myDBAbstractors.clear();
+    
+    if(stageTiming == true) {
+        ingestStats.printSummary(wallTime);
+    }
+    
+    if(trackLatency == true && (stageTiming == true || performanceMeter != -1)) {
+        printf("Row latency (read to written): mean %.3f ms, max %.3f ms\n", (double)meanRowLatency / 1.0e6, (double)maxRowLatency / 1.0e6);
+    }
+    
     return 1;
 }
 
+void DBIngestor::readRow(DBReader::Reader * reader, DBIngestBuffer * ingestBuff, int64_t rowNumber) {
+    //this is a buffer for the results of various size (double or long long is the maximum?)
+    char result[DBING_RESULT_BUFFER_SIZE];
+    bool isNull;
+    int err;
+    
+    vector<DBDataSchema::ColumnPlan> & rowPlan = myDBSchema->getRowPlan();
+    
+    //the stages follow each other, so the end of one stage is the start of the next
+    IngestStats * stats = reader->getRowContext()->getIngestStats();
+    int64_t currTime = 0;
+    int64_t nestedTime = 0;
+    if(stats != NULL) {
+        currTime = IngestStats::getTimestamp();
+    }
+    
+    for(int i=0; i<rowPlan.size(); i++) {
+        DBDataSchema::ColumnPlan & currCol = rowPlan[i];
+        
+        //constant and header columns are only read, converted and cast for the first row of the buffer
+        if(currCol.isInvariant == true && ingestBuff->addInvariantToRow() == 1) {
+            if(stats != NULL) {
+                currTime = addStageTime(stats, STAGE_CAST, currTime, 0);
+            }
+            
+            continue;
+        }
+        
+        if(stats != NULL) {
+            nestedTime = stats->getStageTime(STAGE_ASSERT) + stats->getStageTime(STAGE_CONVERT);
+        }
+        
+        isNull = reader->getItemInRow(currCol.dataDesc, 1, 1, &result);
+        
+        //the asserters and converters run within getItemInRow, but are timed on their own
+        if(stats != NULL) {
+            nestedTime = stats->getStageTime(STAGE_ASSERT) + stats->getStageTime(STAGE_CONVERT) - nestedTime;
+            currTime = addStageTime(stats, STAGE_PARSE, currTime, nestedTime);
+        }
+        
+        err = ingestBuff->addToRow(result, isNull);
+        
+        if(stats != NULL) {
+            currTime = addStageTime(stats, STAGE_CAST, currTime, 0);
+        }
+        
+        if(err != 1) {
+            printf("Error in reading line %lld\n", rowNumber);
+            printf("Problem with column: %s\n", currCol.schemaItem->getColumnName().c_str());
+            DBIngestor_error("DBIngestor: Ingesting NULL in column that is set IS NOT NULL!\n", NULL);
+        }
+        
+        //if this was a string, release it on the reader side... it was already copied somewhere else...
+        if(currCol.dType == DBDataSchema::DT_STRING && currCol.isConstItem != true) {
+            reader->getRowContext()->releaseString(*(char**)result);
+            
+            if(stats != NULL) {
+                currTime = addStageTime(stats, STAGE_FREE, currTime, 0);
+            }
+        }
+    }
+}
+
+int DBIngestor::readNextRow(DBReader::Reader * reader) {
+    IngestStats * stats = reader->getRowContext()->getIngestStats();
+    
+    if(stats == NULL) {
+        return reader->getNextRow();
+    }
+    
+    int64_t startTime = IngestStats::getTimestamp();
+    int hasRow = reader->getNextRow();
+    addStageTime(stats, STAGE_READ_ROW, startTime, 0);
+    
+    return hasRow;
+}
+
+int64_t DBIngestor::parseParallel(DBIngestPipeline * ingestPipeline, int numWorkers) {
+    assert(ingestPipeline != NULL);
+    assert(numWorkers > 1);
+    
+    //use more chunks than threads, so that in ordered mode the threads working ahead do not
+    //need to hold back too many rows
+    int numChunks = numWorkers * DBING_CHUNKS_PER_THREAD;
+    
+    vector<DBReader::Reader*> chunkReaders;
+    vector<int64_t> numRows(numWorkers, 0);
+    vector<IngestStats> threadStats(numWorkers);
+    
+    for(int i=0; i<numWorkers; i++) {
+        DBReader::Reader * chunkReader = myReader->getChunkReader();
+        
+        if(chunkReader == NULL) {
+            DBIngestor_error("DBIngestor: The reader did not provide a chunk reader.\n", NULL);
+        }
+        
+        chunkReaders.push_back(chunkReader);
+    }
+    
+    boost::thread_group parseThreads;
+    
+    for(int i=0; i<numWorkers; i++) {
+        parseThreads.create_thread(boost::bind(&DBIngestor::parseChunks, this, chunkReaders.at(i), i, numWorkers, numChunks, ingestPipeline, &numRows.at(i),
+                                               stageTiming == true ? &threadStats.at(i) : (IngestStats*)NULL));
+    }
+    
+    parseThreads.join_all();
+    
+    int64_t counter = 0;
+    for(int i=0; i<numWorkers; i++) {
+        counter += numRows.at(i);
+        ingestStats.merge(threadStats.at(i));
+        delete chunkReaders.at(i);
+    }
+    
+    return counter;
+}
+
+void DBIngestor::parseChunks(DBReader::Reader * chunkReader, int workerId, int numWorkers, int numChunks, DBIngestPipeline * ingestPipeline, int64_t * numRows, IngestStats * threadStats) {
+    //the schema is shared, everything that changes from row to row is kept in this thread's context
+    DBDataSchema::RowContext rowContext(myDBSchema);
+    rowContext.setIngestStats(threadStats);
+    chunkReader->setRowContext(&rowContext);
+    int64_t counter = 0;
+    
+    //chunks are handed out round robin. this way the thread working on the oldest unfinished chunk never
+    //waits for a later chunk, which the ordered mode of the pipeline relies on
+    for(int chunkId = workerId; chunkId < numChunks; chunkId += numWorkers) {
+        chunkReader->setChunk(chunkId, numChunks);
+        
+        //the buffer is watched, so that the flush thread can hand it over while this thread waits for the next row
+        DBIngestBuffer * ingestBuff = ingestPipeline->getFreeBuffer(chunkId);
+        
+        ingestPipeline->lockProducer(workerId);
+        ingestPipeline->watchBuffer(ingestBuff, workerId, chunkId);
+        ingestPipeline->unlockProducer(workerId);
+        
+        while(readNextRow(chunkReader)) {
+            rowContext.nextRow();
+            
+            ingestPipeline->lockProducer(workerId);
+            
+            //the flush thread may have replaced the buffer in the meantime
+            ingestBuff = ingestPipeline->getWatchedBuffer(workerId);
+            
+            if(ingestBuff->isFull()) {
+                ingestBuff = ingestPipeline->replaceBuffer(workerId);
+            }
+            
+            ingestBuff->newRow();
+            
+            readRow(chunkReader, ingestBuff, counter);
+            
+            ingestPipeline->unlockProducer(workerId);
+            
+            counter++;
+        }
+        
+        ingestPipeline->lockProducer(workerId);
+        ingestBuff = ingestPipeline->getWatchedBuffer(workerId);
+        ingestPipeline->watchBuffer(NULL, workerId);
+        ingestPipeline->unlockProducer(workerId);
+        
+        ingestPipeline->submitBuffer(ingestBuff, chunkId, true);
+    }
+    
+    chunkReader->setRowContext(NULL);
+    *numRows = counter;
+}
+
 string DBIngestor::getUsrName() {
 	return usrName;
 }
@@ -364,6 +810,152 @@ void DBIngestor::setResumeMode(bool newResumeMode) {
     resumeMode = newResumeMode;
 }
 
+int64_t DBIngestor::getCommitIntervalRows() {
+    return commitIntervalRows;
+}
+
+void DBIngestor::setCommitIntervalRows(int64_t newCommitIntervalRows) {
+    assert(newCommitIntervalRows >= 0);
+    
+    commitIntervalRows = newCommitIntervalRows;
+}
+
+int64_t DBIngestor::getCommitIntervalBytes() {
+    return commitIntervalBytes;
+}
+
+void DBIngestor::setCommitIntervalBytes(int64_t newCommitIntervalBytes) {
+    assert(newCommitIntervalBytes >= 0);
+    
+    commitIntervalBytes = newCommitIntervalBytes;
+}
+
+int64_t DBIngestor::getCommitIntervalSeconds() {
+    return commitIntervalSeconds;
+}
+
+void DBIngestor::setCommitIntervalSeconds(int64_t newCommitIntervalSeconds) {
+    assert(newCommitIntervalSeconds >= 0);
+    
+    commitIntervalSeconds = newCommitIntervalSeconds;
+}
+
+int DBIngestor::getPipelineDepth() {
+    return pipelineDepth;
+}
+
+void DBIngestor::setPipelineDepth(int newPipelineDepth) {
+    assert(newPipelineDepth >= 0);
+    
+    pipelineDepth = newPipelineDepth;
+}
+
+int DBIngestor::getNumConnections() {
+    return numConnections;
+}
+
+void DBIngestor::setNumConnections(int newNumConnections) {
+    assert(newNumConnections >= 1);
+    
+    numConnections = newNumConnections;
+}
+
+string DBIngestor::getDBAdaptorName() {
+    return dbAdaptorName;
+}
+
+void DBIngestor::setDBAdaptorName(string newDBAdaptorName) {
+    dbAdaptorName = newDBAdaptorName;
+}
+
+int DBIngestor::getNumParseThreads() {
+    return numParseThreads;
+}
+
+void DBIngestor::setNumParseThreads(int newNumParseThreads) {
+    assert(newNumParseThreads >= 1);
+    
+    numParseThreads = newNumParseThreads;
+}
+
+bool DBIngestor::getOrderedCommit() {
+    return orderedCommit;
+}
+
+void DBIngestor::setOrderedCommit(bool newOrderedCommit) {
+    orderedCommit = newOrderedCommit;
+}
+
+bool DBIngestor::getStageTiming() {
+    return stageTiming;
+}
+
+void DBIngestor::setStageTiming(bool newStageTiming) {
+    stageTiming = newStageTiming;
+}
+
+int64_t DBIngestor::getMaxBufferBytes() {
+    return maxBufferBytes;
+}
+
+void DBIngestor::setMaxBufferBytes(int64_t newMaxBufferBytes) {
+    assert(newMaxBufferBytes >= 0);
+    
+    maxBufferBytes = newMaxBufferBytes;
+}
+
+int64_t DBIngestor::getMaxBufferBytesUsed() {
+    return maxBufferBytesUsed;
+}
+
+int64_t DBIngestor::getMaxFlushLatency() {
+    return maxFlushLatency;
+}
+
+void DBIngestor::setMaxFlushLatency(int64_t newMaxFlushLatency) {
+    assert(newMaxFlushLatency >= 0);
+    
+    maxFlushLatency = newMaxFlushLatency;
+}
+
+int64_t DBIngestor::getMeanRowLatency() {
+    return meanRowLatency;
+}
+
+int64_t DBIngestor::getMaxRowLatency() {
+    return maxRowLatency;
+}
+
+bool DBIngestor::getAdaptiveStmtSize() {
+    return adaptiveStmtSize;
+}
+
+void DBIngestor::setAdaptiveStmtSize(bool newAdaptiveStmtSize) {
+    adaptiveStmtSize = newAdaptiveStmtSize;
+}
+
+int64_t DBIngestor::getMaxStmtLatency() {
+    return maxStmtLatency;
+}
+
+void DBIngestor::setMaxStmtLatency(int64_t newMaxStmtLatency) {
+    assert(newMaxStmtLatency >= 0);
+    
+    maxStmtLatency = newMaxStmtLatency;
+}
+
+bool DBIngestor::getStrictRangeCheck() {
+    return strictRangeCheck;
+}
+
+void DBIngestor::setStrictRangeCheck(bool newStrictRangeCheck) {
+    strictRangeCheck = newStrictRangeCheck;
+}
+
+IngestStats * DBIngestor::getIngestStats() {
+    return &ingestStats;
+}
+
 DBDataSchema::Schema * DBIngestor::getSchema() {
 	return myDBSchema;
 }
@@ -26,10 +26,12 @@
  */
 
 #include <string>
+#include <vector>
 #include "Schema.h"
 #include "Reader.h"
 #include "DBAbstractor.h"
 #include "AsserterFactory.h"
+#include "IngestStats.h"
 #ifndef _WIN32
 #include <stdint.h>
 #else
@@ -40,6 +42,8 @@
 #define DBIngestor_DBIngestor_h
 
 namespace DBIngest {
+    class DBIngestBuffer;
+    class DBIngestPipeline;
 
     /*! \class DBIngestor
      \brief DBIngestor class
@@ -83,7 +87,8 @@ namespace DBIngest {
 
         /*! \var uint32_t disableKeys
          if this variable is set, all keys/indexes will be disabled before ingest. Do remember to enable them, either manually or by
-         setting enableKeys. If you use this, you should know what you are doing!
+         setting enableKeys. If you use this, you should know what you are doing! Adaptors that restore the keys when committing
+         (see DBAbstractor::getKeepsKeysDisabledOnCommit) keep them, if a commit interval is set.
          */
 		uint32_t disableKeys;
 
@@ -107,6 +112,129 @@ namespace DBIngest {
          */
         bool resumeMode;
 
+        /*! \var int64_t commitIntervalRows
+         if larger than 0, the transaction opened with the savepoint is committed and a new one opened, once this many
+         rows have been written to it. This keeps the transactions (and with them the undo logs or journals of the server)
+         small, but a failure only rolls back the rows since the last commit. Transactions end with a buffer, so they may
+         hold up to one buffer more. With several connections every connection counts its own rows. With one connection
+         and the rows committed in the order of the input, the number of input rows committed so far is printed after
+         every transaction. Defaults to 0, i.e.
+         the whole ingest is done in one transaction (unless commitIntervalBytes or commitIntervalSeconds is set). Not
+         used in resume mode, which runs without transactions.
+         */
+        int64_t commitIntervalRows;
+
+        /*! \var int64_t commitIntervalBytes
+         if larger than 0, the transaction is committed once this many bytes have been written to it (see commitIntervalRows)
+         */
+        int64_t commitIntervalBytes;
+
+        /*! \var int64_t commitIntervalSeconds
+         if larger than 0, the transaction is committed once it has been open for this many seconds (see commitIntervalRows)
+         */
+        int64_t commitIntervalSeconds;
+
+        /*! \var int pipelineDepth
+         if this is larger than 0, parsing and committing to the database are overlapped. A dedicated commit thread
+         drains the filled buffers, while the reader continues to fill the next one. pipelineDepth gives the number of
+         full buffers that can wait for the commit thread, before the reader is stalled. If set to 0 (the default), the
+         ingest is carried out serially.
+         */
+        int pipelineDepth;
+
+        /*! \var int numConnections
+         number of database connections used to commit the data. If this is larger than 1, the ingest is pipelined
+         and each connection gets its own commit thread, which takes the next full buffer from a shared queue. The
+         additional connections are copies of the main DBAbstractor (see DBServer::DBAbstractor::createLike), with
+         all its settings, and use the same credentials. Every connection runs its own transaction (savepoint), so there is
+         no atomicity across the connections: if one of them fails, rows committed by the others are kept. Keys are
+         disabled before any of the transactions is opened and are only enabled again after all of them are
+         released. Adaptors writing into a single file (SQLite3, CSV) only allow one writer, for them this is
+         ignored and only one connection is used. Defaults to 1.
+         */
+        int numConnections;
+
+        /*! \var std::string dbAdaptorName
+         name of the DB adaptor (as understood by DBAdaptorsFactory) used to create additional connections, if
+         the main DBAbstractor cannot be copied. These connections only get the factory defaults of the adaptor.
+         */
+        std::string dbAdaptorName;
+
+        /*! \var int numParseThreads
+         number of threads parsing the data. If this is larger than 1 and the reader is splittable (see
+         DBReader::Reader::getIsSplittable), the input is split into chunks, which are parsed concurrently.
+         The filled buffers are committed through the pipeline. Defaults to 1.
+         */
+        int numParseThreads;
+
+        /*! \var bool orderedCommit
+         if parsing in parallel and this is set to true (the default), rows are sent to the database in the
+         order of the input. If set to false, every buffer is committed as soon as it is full, which needs less
+         memory and keeps all parsing threads busy, but the order of the rows is lost.
+         */
+        bool orderedCommit;
+
+        /*! \var bool stageTiming
+         if set to true, the time spent in each stage of the ingest is measured and printed once ingestData is
+         done. Defaults to false, since taking the timestamps slows down the parsing of small values noticeably.
+         */
+        bool stageTiming;
+
+        /*! \var int64_t maxBufferBytes
+         if larger than 0, a buffer is committed as soon as the rows in it hold this many bytes (strings included),
+         even if it has not reached the number of rows given to ingestData. This bounds the memory used by the
+         buffers and the amount of data sent with each commit. Defaults to 0, i.e. only the number of rows counts.
+         */
+        int64_t maxBufferBytes;
+
+        /*! \var int64_t maxBufferBytesUsed
+         the largest number of bytes a buffer held during the last call to ingestData
+         */
+        int64_t maxBufferBytesUsed;
+
+        /*! \var int64_t maxFlushLatency
+         if larger than 0, a buffer is committed once its first row has waited this many milliseconds, even if the buffer
+         is not full. This bounds the time until a row shows up in the database when the data trickles in. The ingest is
+         then always pipelined and a flush thread commits the buffers of the parsing threads even while the readers wait
+         for data. With ordered parallel parsing, rows still wait until all the earlier chunks are committed. Defaults to 0.
+         */
+        int64_t maxFlushLatency;
+
+        /*! \var int64_t meanRowLatency
+         the average nanoseconds a row waited between being read and being written to the database during the last call
+         to ingestData. only measured with a maximum flush latency or stage timing.
+         */
+        int64_t meanRowLatency;
+
+        /*! \var int64_t maxRowLatency
+         the longest a row waited between being read and being written to the database during the last call to ingestData
+         */
+        int64_t maxRowLatency;
+
+        /*! \var bool adaptiveStmtSize
+         if set to true, the number of rows bound to each statement is tuned during the ingest from the measured
+         throughput (see StmtSizeTuner), instead of always using as many rows as the buffer and the DB adaptor allow.
+         Not used with adaptors that execute asynchronously (see DBAbstractor::getExecutesAsync). Defaults to false.
+         */
+        bool adaptiveStmtSize;
+
+        /*! \var int64_t maxStmtLatency
+         if tuning the statement size and larger than 0, statements are kept small enough to take no longer than this
+         many nanoseconds on average
+         */
+        int64_t maxStmtLatency;
+
+        /*! \var bool strictRangeCheck
+         if set to true, an integer in the data that does not fit into its data type stops the ingest with an error.
+         Otherwise it is stored as the closest value of the type and counted. Defaults to false.
+         */
+        bool strictRangeCheck;
+
+        /*! \var IngestStats ingestStats
+         the stage timings of the last call to ingestData (summed over all threads)
+         */
+        IngestStats ingestStats;
+
         /*! \var DBDataSchema::Schema * myDBSchema
          pointer to the Schema class, describing the data to be read
          */
@@ -122,11 +250,35 @@ namespace DBIngest {
          */
         DBServer::DBAbstractor * myDBAbstractor;
 
+        /*! \var std::vector<DBServer::DBAbstractor*> myDBAbstractors
+         all the database abstractors used for the ingest. The first one is always myDBAbstractor, the others
+         are created (and destroyed) by ingestData if numConnections is larger than 1
+         */
+        std::vector<DBServer::DBAbstractor*> myDBAbstractors;
+
         /*! \var bool askUserToValidateRead
          when this is set, the ingestor asks the user to validate the read
          */
 		bool askUserToValidateRead;
 
+        /*! \brief reads all the items of the current row into the buffer
+         */
+        void readRow(DBReader::Reader * reader, DBIngestBuffer * ingestBuff, int64_t rowNumber);
+
+        /*! \brief moves the reader to the next row, timing it if the reader's row context has IngestStats
+         
+         \return the result of Reader::getNextRow*/
+        int readNextRow(DBReader::Reader * reader);
+
+        /*! \brief parses the data with numWorkers threads, each reading its own chunks of the data
+         
+         \return number of rows read*/
+        int64_t parseParallel(DBIngestPipeline * ingestPipeline, int numWorkers);
+
+        /*! \brief main loop of a parsing thread
+         */
+        void parseChunks(DBReader::Reader * chunkReader, int workerId, int numWorkers, int numChunks, DBIngestPipeline * ingestPipeline, int64_t * numRows, IngestStats * threadStats);
+
 	public:
         DBIngestor();
         
@@ -155,7 +307,7 @@ namespace DBIngest {
 	
         /*! \brief ingests all the data in the Reader object into the database. 
          
-         \param int lenBuffer: length of the ingest buffer to be used
+         \param int lenBuffer: length of the ingest buffer to be used (in rows, see also setMaxBufferBytes)
 
          \return 1 if successfull, 0 if the Schema does not map to the database table
          
@@ -204,6 +356,82 @@ namespace DBIngest {
         
         void setResumeMode(bool newResumeMode);
 
+        int64_t getCommitIntervalRows();
+        
+        void setCommitIntervalRows(int64_t newCommitIntervalRows);
+
+        int64_t getCommitIntervalBytes();
+        
+        void setCommitIntervalBytes(int64_t newCommitIntervalBytes);
+
+        int64_t getCommitIntervalSeconds();
+        
+        void setCommitIntervalSeconds(int64_t newCommitIntervalSeconds);
+
+        int getPipelineDepth();
+        
+        void setPipelineDepth(int newPipelineDepth);
+
+        int getNumConnections();
+        
+        void setNumConnections(int newNumConnections);
+
+        std::string getDBAdaptorName();
+        
+        void setDBAdaptorName(std::string newDBAdaptorName);
+
+        int getNumParseThreads();
+        
+        void setNumParseThreads(int newNumParseThreads);
+
+        bool getOrderedCommit();
+        
+        void setOrderedCommit(bool newOrderedCommit);
+
+        bool getStageTiming();
+        
+        void setStageTiming(bool newStageTiming);
+
+        int64_t getMaxBufferBytes();
+        
+        void setMaxBufferBytes(int64_t newMaxBufferBytes);
+
+        /*! \brief returns the largest number of bytes a buffer held during the last call to ingestData (high-water mark)
+         */
+        int64_t getMaxBufferBytesUsed();
+
+        int64_t getMaxFlushLatency();
+        
+        void setMaxFlushLatency(int64_t newMaxFlushLatency);
+
+        /*! \brief returns the average time in nanoseconds a row waited between being read and being written to the database during
+         the last call to ingestData
+         
+         Only measured if a maximum flush latency is set or the stage timing is switched on.*/
+        int64_t getMeanRowLatency();
+
+        /*! \brief returns the longest time in nanoseconds a row waited between being read and being written to the database during
+         the last call to ingestData
+         */
+        int64_t getMaxRowLatency();
+
+        bool getAdaptiveStmtSize();
+        
+        void setAdaptiveStmtSize(bool newAdaptiveStmtSize);
+
+        int64_t getMaxStmtLatency();
+        
+        void setMaxStmtLatency(int64_t newMaxStmtLatency);
+
+        bool getStrictRangeCheck();
+        
+        void setStrictRangeCheck(bool newStrictRangeCheck);
+
+        /*! \brief returns the time spent in each stage during the last call to ingestData
+         
+         Only filled if the stage timing is switched on (see setStageTiming).*/
+        IngestStats * getIngestStats();
+
 		DBDataSchema::Schema * getSchema();
 	
 		void setSchema(DBDataSchema::Schema * newDBSchema);
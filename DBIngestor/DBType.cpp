@@ -20,6 +20,7 @@
 #include "DBType.h"
 #include "dbingestor_error.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdexcept>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
@@ -32,28 +33,6 @@
 using namespace DBDataSchema;
 using namespace std;
 
-///////////////////////////////////////////////
-////// PRIVATE FUNCTION FORWARD DECLARATION ///
-///////////////////////////////////////////////
-
-void convToChar(void* value, DType thisDType, void* result);
-void convToBit(void* value, DType thisDType, void* result);
-void convToBigint(void* value, DType thisDType, void* result);
-void convToInt(void* value, DType thisDType, void* result);
-void convToSmallint(void* value, DType thisDType, void* result);
-void convToTinyint(void* value, DType thisDType, void* result);
-void convToUBigint(void* value, DType thisDType, void* result);
-void convToUInt(void* value, DType thisDType, void* result);
-void convToUSmallint(void* value, DType thisDType, void* result);
-void convToUTinyint(void* value, DType thisDType, void* result);
-void convToFloat(void* value, DType thisDType, void* result);
-void convToReal(void* value, DType thisDType, void* result);
-void convToDate(void* value, DType thisDType, void* result);
-void convToTime(void* value, DType thisDType, void* result);
-void convToAny(void* value, DType thisDType, void* result);
-
-///////////////////////////////////////////////
-
 int DBDataSchema::getByteLenOfDBType(DBType thisType) {
     switch (thisType) {
         case DBT_CHAR:
@@ -140,634 +119,325 @@ DBType DBDataSchema::convDTypeToDBType(DType thisDType) {
     
 }
 
-void DBDataSchema::castDTypeToDBType(void * value, DType fromThisType, DBType toThisType, void* result) {
-    switch (toThisType) {
-        case DBT_CHAR:
-            convToChar(value, fromThisType, result);
-            break;
-        case DBT_BIT:
-            convToBit(value, fromThisType, result);
-            break;
-        case DBT_BIGINT:
-            convToBigint(value, fromThisType, result);
-            break;
-        case DBT_MEDIUMINT:
-            convToInt(value, fromThisType, result);
-            break;
-        case DBT_INTEGER:
-            convToInt(value, fromThisType, result);
-            break;
-        case DBT_SMALLINT:
-            convToSmallint(value, fromThisType, result);
-            break;
-        case DBT_TINYINT:
-            convToTinyint(value, fromThisType, result);
-            break;
-        case DBT_FLOAT:
-            convToFloat(value, fromThisType, result);
-            break;
-        case DBT_REAL:
-            convToReal(value, fromThisType, result);
-            break;
-        case DBT_DATE:
-            convToDate(value, fromThisType, result);
-            break;
-        case DBT_TIME:
-            convToTime(value, fromThisType, result);
-            break;
-        case DBT_ANY:
-            convToAny(value, fromThisType, result);
-            break;
-        case DBT_UBIGINT:
-            convToUBigint(value, fromThisType, result);
-            break;
-        case DBT_UMEDIUMINT:
-            convToUInt(value, fromThisType, result);
-            break;
-        case DBT_UINTEGER:
-            convToUInt(value, fromThisType, result);
-            break;
-        case DBT_USMALLINT:
-            convToUSmallint(value, fromThisType, result);
-            break;
-        case DBT_UTINYINT:
-            convToUTinyint(value, fromThisType, result);
-            break;
-        case DBT_UFLOAT:
-            convToFloat(value, fromThisType, result);
-            break;
-        case DBT_UREAL:
-            convToReal(value, fromThisType, result);
-            break;
-        default:
-            DBIngestor_error("castDTypeToDBType: DBType not known, I don't know what to do.", NULL);
-    }
-}
-
-void convToChar(void* value, DType thisDType, void* result) {
-    string tmpStr;
-    char * outputStr;
-    
-    switch (thisDType) {
-        case DT_STRING: 
-            outputStr = (char*)malloc((strlen(*(char**)value)+1)*sizeof(char));
-            strcpy(outputStr, *(char**)value);
-            *(char**) result = outputStr;
-            return;
-        case DT_INT1: 
-            tmpStr = boost::lexical_cast<std::string>(static_cast<int>(*(int8_t*)value));
-            break;
-        case DT_INT2: 
-            tmpStr = boost::lexical_cast<std::string>((int16_t*)value);
-            break;
-        case DT_INT4:
-            tmpStr = boost::lexical_cast<std::string>((int32_t*)value);
-            break;
-        case DT_INT8:
-            tmpStr = boost::lexical_cast<std::string>((int64_t*)value);
-            break;
-        case DT_UINT1: 
-            tmpStr = boost::lexical_cast<std::string>(static_cast<int>(*(uint8_t*)value));
-            break;
-        case DT_UINT2: 
-            tmpStr = boost::lexical_cast<std::string>((uint16_t*)value);
-            break;
-        case DT_UINT4:
-            tmpStr = boost::lexical_cast<std::string>((uint32_t*)value);
-            break;
-        case DT_UINT8:
-            tmpStr = boost::lexical_cast<std::string>((uint64_t*)value);
-            break;
-        case DT_REAL4:
-            tmpStr = boost::lexical_cast<std::string>((float*)value);
-            break;
-        case DT_REAL8:
-            tmpStr = boost::lexical_cast<std::string>((double*)value);
-            break;
-        default:
-            DBIngestor_error("castDTypeToDBType: DType not known, I don't know what to do.", NULL);
-    }
+///////////////////////////////////////////////
+////// CAST KERNELS ///////////////////////////
+///////////////////////////////////////////////
 
-    outputStr = (char*)malloc((tmpStr.size()+1)*sizeof(char));
-    strcpy(outputStr, tmpStr.c_str());
-    *(char**) result = outputStr;
-}
+//the cast kernels are generated for every combination of DType and DBType. All type decisions are taken
+//at compile time, so that a kernel only loads, converts and stores. Unaligned access through memcpy,
+//since the buffer rows are packed.
 
-void convToBit(void* value, DType thisDType, void* result) {
-    switch (thisDType) {
-        case DT_STRING: {
-            int16_t tmp;
-            sscanf((char*) value, "%hd", tmp);
-            *(int8_t*) result = (int8_t)tmp;}
-            break;
-        case DT_INT1: 
-            *(int8_t*) result = *(int8_t*)value;
-            break;
-        case DT_INT2: 
-            *(int8_t*) result = (int8_t)*(int16_t*)value;
-            break;
-        case DT_INT4:
-            *(int8_t*) result = (int8_t)*(int32_t*)value;
-            break;
-        case DT_INT8:
-            *(int8_t*) result = (int8_t)*(int64_t*)value;
-            break;
-        case DT_UINT1: 
-            *(int8_t*) result = (int8_t)*(uint8_t*)value;
-            break;
-        case DT_UINT2: 
-            *(int8_t*) result = (int8_t)*(uint16_t*)value;
-            break;
-        case DT_UINT4:
-            *(int8_t*) result = (int8_t)*(uint32_t*)value;
-            break;
-        case DT_UINT8:
-            *(int8_t*) result = (int8_t)*(uint64_t*)value;
-            break;
-        case DT_REAL4:
-            *(int8_t*) result = (int8_t)*(float*)value;
-            break;
-        case DT_REAL8:
-            *(int8_t*) result = (int8_t)*(double*)value;
-            break;
-        default:
-            DBIngestor_error("castDTypeToDBType: DType not known, I don't know what to do.", NULL);
-    }
+namespace {
+    
+    template<typename T1, typename T2> struct IsSameType { static const bool value = false; };
+    template<typename T> struct IsSameType<T, T> { static const bool value = true; };
+    
+    //C type of a DType and the DBType it is stored as in a DBT_ANY column
+    template<DType thisDType> struct DTypeTraits;
+    template<> struct DTypeTraits<DT_STRING> { typedef char* Type; static const DBType anyDBType = DBT_CHAR; };
+    template<> struct DTypeTraits<DT_INT1> { typedef int8_t Type; static const DBType anyDBType = DBT_TINYINT; };
+    template<> struct DTypeTraits<DT_INT2> { typedef int16_t Type; static const DBType anyDBType = DBT_SMALLINT; };
+    template<> struct DTypeTraits<DT_INT4> { typedef int32_t Type; static const DBType anyDBType = DBT_INTEGER; };
+    template<> struct DTypeTraits<DT_INT8> { typedef int64_t Type; static const DBType anyDBType = DBT_BIGINT; };
+    template<> struct DTypeTraits<DT_REAL4> { typedef float Type; static const DBType anyDBType = DBT_FLOAT; };
+    template<> struct DTypeTraits<DT_REAL8> { typedef double Type; static const DBType anyDBType = DBT_REAL; };
+    template<> struct DTypeTraits<DT_UINT1> { typedef uint8_t Type; static const DBType anyDBType = DBT_UTINYINT; };
+    template<> struct DTypeTraits<DT_UINT2> { typedef uint16_t Type; static const DBType anyDBType = DBT_USMALLINT; };
+    template<> struct DTypeTraits<DT_UINT4> { typedef uint32_t Type; static const DBType anyDBType = DBT_UINTEGER; };
+    template<> struct DTypeTraits<DT_UINT8> { typedef uint64_t Type; static const DBType anyDBType = DBT_UBIGINT; };
     
-    if(*(int8_t*) result != 0) {
-        *(int8_t*) result = 1;
+    //C type of a DBType and the type strings are parsed into before casting
+    template<DBType thisDBType> struct DBTypeTraits;
+    template<> struct DBTypeTraits<DBT_CHAR> { typedef char* Type; typedef char* ParseType; };
+    template<> struct DBTypeTraits<DBT_BIT> { typedef int8_t Type; typedef int64_t ParseType; };
+    template<> struct DBTypeTraits<DBT_BIGINT> { typedef int64_t Type; typedef int64_t ParseType; };
+    template<> struct DBTypeTraits<DBT_MEDIUMINT> { typedef int32_t Type; typedef int64_t ParseType; };
+    template<> struct DBTypeTraits<DBT_INTEGER> { typedef int32_t Type; typedef int64_t ParseType; };
+    template<> struct DBTypeTraits<DBT_SMALLINT> { typedef int16_t Type; typedef int64_t ParseType; };
+    template<> struct DBTypeTraits<DBT_TINYINT> { typedef int8_t Type; typedef int64_t ParseType; };
+    template<> struct DBTypeTraits<DBT_FLOAT> { typedef float Type; typedef float ParseType; };
+    template<> struct DBTypeTraits<DBT_REAL> { typedef double Type; typedef double ParseType; };
+    template<> struct DBTypeTraits<DBT_UBIGINT> { typedef uint64_t Type; typedef uint64_t ParseType; };
+    template<> struct DBTypeTraits<DBT_UMEDIUMINT> { typedef uint32_t Type; typedef uint64_t ParseType; };
+    template<> struct DBTypeTraits<DBT_UINTEGER> { typedef uint32_t Type; typedef uint64_t ParseType; };
+    template<> struct DBTypeTraits<DBT_USMALLINT> { typedef uint16_t Type; typedef uint64_t ParseType; };
+    template<> struct DBTypeTraits<DBT_UTINYINT> { typedef uint8_t Type; typedef uint64_t ParseType; };
+    template<> struct DBTypeTraits<DBT_UFLOAT> { typedef float Type; typedef float ParseType; };
+    template<> struct DBTypeTraits<DBT_UREAL> { typedef double Type; typedef double ParseType; };
+    
+    inline void parseString(const char * value, int64_t * result) {
+#ifdef _WIN32
+        *result = _strtoi64(value, NULL, 10);
+#else
+        *result = strtoll(value, NULL, 10);
+#endif
     }
-}
-
-void convToTinyint(void* value, DType thisDType, void* result) {
-    switch (thisDType) {
-        case DT_STRING: {
-            int16_t tmp;
-            sscanf((char*) value, "%hd", tmp);
-            *(int8_t*) result = (int8_t)tmp;}
-            break;
-        case DT_INT1: 
-            *(int8_t*) result = *(int8_t*)value;
-            break;
-        case DT_INT2: 
-            *(int8_t*) result = (int8_t)*(int16_t*)value;
-            break;
-        case DT_INT4:
-            *(int8_t*) result = (int8_t)*(int32_t*)value;
-            break;
-        case DT_INT8:
-            *(int8_t*) result = (int8_t)*(int64_t*)value;
-            break;
-        case DT_UINT1: 
-            *(int8_t*) result = (int8_t)*(uint8_t*)value;
-            break;
-        case DT_UINT2: 
-            *(int8_t*) result = (int8_t)*(uint16_t*)value;
-            break;
-        case DT_UINT4:
-            *(int8_t*) result = (int8_t)*(uint32_t*)value;
-            break;
-        case DT_UINT8:
-            *(int8_t*) result = (int8_t)*(uint64_t*)value;
-            break;
-        case DT_REAL4:
-            *(int8_t*) result = (int8_t)*(float*)value;
-            break;
-        case DT_REAL8:
-            *(int8_t*) result = (int8_t)*(double*)value;
-            break;
-        default:
-            DBIngestor_error("castDTypeToDBType: DType not known, I don't know what to do.", NULL);
+    
+    inline void parseString(const char * value, uint64_t * result) {
+#ifdef _WIN32
+        *result = _strtoui64(value, NULL, 10);
+#else
+        *result = strtoull(value, NULL, 10);
+#endif
     }
-}
-
-void convToBigint(void* value, DType thisDType, void* result) {
-    switch (thisDType) {
-        case DT_STRING: {
+    
+    inline void parseString(const char * value, float * result) {
 #ifdef _WIN32
-            *(int64_t*)result = _strtoi64((char*)value, NULL, 10);
+        *result = (float)strtod(value, NULL);
 #else
-            *(int64_t*)result = strtoll((char*)value, NULL, 10);
+        *result = strtof(value, NULL);
 #endif
-            break;}
-        case DT_INT1: 
-            *(int64_t*) result = (int64_t)*(int8_t*)value;
-            break;
-        case DT_INT2: 
-            *(int64_t*) result = (int64_t)*(int16_t*)value;
-            break;
-        case DT_INT4:
-            *(int64_t*) result = (int64_t)*(int32_t*)value;
-            break;
-        case DT_INT8:
-            *(int64_t*) result = *(int64_t*)value;
-            break;
-        case DT_UINT1: 
-            *(int64_t*) result = (int64_t)*(uint8_t*)value;
-            break;
-        case DT_UINT2: 
-            *(int64_t*) result = (int64_t)*(uint16_t*)value;
-            break;
-        case DT_UINT4:
-            *(int64_t*) result = (int64_t)*(uint32_t*)value;
-            break;
-        case DT_UINT8:
-            *(int64_t*) result = (int64_t)*(uint64_t*)value;
-            break;
-        case DT_REAL4:
-            *(int64_t*) result = (int64_t)*(float*)value;
-            break;
-        case DT_REAL8:
-            *(int64_t*) result = (int64_t)*(double*)value;
-            break;
-        default:
-            DBIngestor_error("castDTypeToDBType: DType not known, I don't know what to do.", NULL);
     }
-}
-
-void convToInt(void* value, DType thisDType, void* result) {
-    switch (thisDType) {
-        case DT_STRING: 
-            *(int32_t*)result = strtol((char*) value, NULL, 10);
-            break;
-        case DT_INT1: 
-            *(int32_t*) result = (int32_t)*(int8_t*)value;
-            break;
-        case DT_INT2: 
-            *(int32_t*) result = (int32_t)*(int16_t*)value;
-            break;
-        case DT_INT4:
-            *(int32_t*) result = *(int32_t*)value;
-            break;
-        case DT_INT8:
-            *(int32_t*) result = (int32_t)*(int64_t*)value;
-            break;
-        case DT_UINT1: 
-            *(int32_t*) result = (int32_t)*(uint8_t*)value;
-            break;
-        case DT_UINT2: 
-            *(int32_t*) result = (int32_t)*(uint16_t*)value;
-            break;
-        case DT_UINT4:
-            *(int32_t*) result = (int32_t)*(uint32_t*)value;
-            break;
-        case DT_UINT8:
-            *(int32_t*) result = (int32_t)*(uint64_t*)value;
-            break;
-        case DT_REAL4:
-            *(int32_t*) result = (int32_t)*(float*)value;
-            break;
-        case DT_REAL8:
-            *(int32_t*) result = (int32_t)*(double*)value;
-            break;
-        default:
-            DBIngestor_error("castDTypeToDBType: DType not known, I don't know what to do.", NULL);
+    
+    inline void parseString(const char * value, double * result) {
+        *result = strtod(value, NULL);
     }
-}
+    
+    inline char * copyString(const char * value, size_t len) {
+        char * outputStr = (char*)malloc((len+1)*sizeof(char));
+        if(outputStr == NULL) {
+            DBIngestor_error("castDTypeToDBType: Not enough memory for allocating the string.", NULL);
+        }
         
-void convToSmallint(void* value, DType thisDType, void* result) {
-    switch (thisDType) {
-        case DT_STRING: 
-            sscanf((char*)value, "%hd", result);
-            break;
-        case DT_INT1: 
-            *(int16_t*) result = (int16_t)*(int8_t*)value;
-            break;
-        case DT_INT2: 
-            *(int16_t*) result = *(int16_t*)value;
-            break;
-        case DT_INT4:
-            *(int16_t*) result = (int16_t)*(int32_t*)value;
-            break;
-        case DT_INT8:
-            *(int16_t*) result = (int16_t)*(int64_t*)value;
-            break;
-        case DT_UINT1: 
-            *(int16_t*) result = (int16_t)*(uint8_t*)value;
-            break;
-        case DT_UINT2: 
-            *(int16_t*) result = (int16_t)*(uint16_t*)value;
-            break;
-        case DT_UINT4:
-            *(int16_t*) result = (int16_t)*(uint32_t*)value;
-            break;
-        case DT_UINT8:
-            *(int16_t*) result = (int16_t)*(uint64_t*)value;
-            break;
-        case DT_REAL4:
-            *(int16_t*) result = (int16_t)*(float*)value;
-            break;
-        case DT_REAL8:
-            *(int16_t*) result = (int16_t)*(double*)value;
-            break;
-        default:
-            DBIngestor_error("castDTypeToDBType: DType not known, I don't know what to do.", NULL);
+        memcpy(outputStr, value, len+1);
+        return outputStr;
     }
-}
-
-void convToUTinyint(void* value, DType thisDType, void* result) {
-    switch (thisDType) {
-        case DT_STRING: {
-            int16_t tmp;
-            sscanf((char*) value, "%hd", tmp);
-            *(uint8_t*) result = (uint8_t)tmp;}
-            break;
-        case DT_INT1: 
-            *(uint8_t*) result = (uint8_t)*(int8_t*)value;
-            break;
-        case DT_INT2: 
-            *(uint8_t*) result = (uint8_t)*(int16_t*)value;
-            break;
-        case DT_INT4:
-            *(uint8_t*) result = (uint8_t)*(int32_t*)value;
-            break;
-        case DT_INT8:
-            *(uint8_t*) result = (uint8_t)*(int64_t*)value;
-            break;
-        case DT_UINT1: 
-            *(uint8_t*) result = *(uint8_t*)value;
-            break;
-        case DT_UINT2: 
-            *(uint8_t*) result = (uint8_t)*(uint16_t*)value;
-            break;
-        case DT_UINT4:
-            *(uint8_t*) result = (uint8_t)*(uint32_t*)value;
-            break;
-        case DT_UINT8:
-            *(uint8_t*) result = (uint8_t)*(uint64_t*)value;
-            break;
-        case DT_REAL4:
-            *(uint8_t*) result = (uint8_t)*(float*)value;
-            break;
-        case DT_REAL8:
-            *(uint8_t*) result = (uint8_t)*(double*)value;
-            break;
-        default:
-            DBIngestor_error("castDTypeToDBType: DType not known, I don't know what to do.", NULL);
-    }
-}
-
-void convToUBigint(void* value, DType thisDType, void* result) {
-    switch (thisDType) {
-        case DT_STRING:
-#ifdef _WIN32
-            *(uint64_t*)result = _strtoui64((char*)value, NULL, 10);
-#else
-            *(uint64_t*)result = strtoull((char*)value, NULL, 10);
-#endif
-            break;
-        case DT_INT1: 
-            *(uint64_t*) result = (uint64_t)*(int8_t*)value;
-            break;
-        case DT_INT2: 
-            *(uint64_t*) result = (uint64_t)*(int16_t*)value;
-            break;
-        case DT_INT4:
-            *(uint64_t*) result = (uint64_t)*(int32_t*)value;
-            break;
-        case DT_INT8:
-            *(uint64_t*) result = (uint64_t)*(int64_t*)value;
-            break;
-        case DT_UINT1: 
-            *(uint64_t*) result = (uint64_t)*(uint8_t*)value;
-            break;
-        case DT_UINT2: 
-            *(uint64_t*) result = (uint64_t)*(uint16_t*)value;
-            break;
-        case DT_UINT4:
-            *(uint64_t*) result = (uint64_t)*(uint32_t*)value;
-            break;
-        case DT_UINT8:
-            *(uint64_t*) result = *(uint64_t*)value;
-            break;
-        case DT_REAL4:
-            *(uint64_t*) result = (uint64_t)*(float*)value;
-            break;
-        case DT_REAL8:
-            *(uint64_t*) result = (uint64_t)*(double*)value;
-            break;
-        default:
-            DBIngestor_error("castDTypeToDBType: DType not known, I don't know what to do.", NULL);
+    
+    template<typename fromT> inline std::string formatValue(fromT value) {
+        return boost::lexical_cast<std::string>(value);
     }
-}
-
-void convToUInt(void* value, DType thisDType, void* result) {
-    switch (thisDType) {
-        case DT_STRING: 
-            *(uint32_t*)result = strtoul((char*) value, NULL, 10);
-            break;
-        case DT_INT1: 
-            *(uint32_t*) result = (uint32_t)*(int8_t*)value;
-            break;
-        case DT_INT2: 
-            *(uint32_t*) result = (uint32_t)*(int16_t*)value;
-            break;
-        case DT_INT4:
-            *(uint32_t*) result = (uint32_t)*(int32_t*)value;
-            break;
-        case DT_INT8:
-            *(uint32_t*) result = (uint32_t)*(int64_t*)value;
-            break;
-        case DT_UINT1: 
-            *(uint32_t*) result = (uint32_t)*(uint8_t*)value;
-            break;
-        case DT_UINT2: 
-            *(uint32_t*) result = (uint32_t)*(uint16_t*)value;
-            break;
-        case DT_UINT4:
-            *(uint32_t*) result = *(uint32_t*)value;
-            break;
-        case DT_UINT8:
-            *(uint32_t*) result = (uint32_t)*(uint64_t*)value;
-            break;
-        case DT_REAL4:
-            *(uint32_t*) result = (uint32_t)*(float*)value;
-            break;
-        case DT_REAL8:
-            *(uint32_t*) result = (uint32_t)*(double*)value;
-            break;
-        default:
-            DBIngestor_error("castDTypeToDBType: DType not known, I don't know what to do.", NULL);
+    
+    //single byte integers would otherwise be printed as characters
+    inline std::string formatValue(int8_t value) {
+        return boost::lexical_cast<std::string>(static_cast<int>(value));
     }
-}
-
-void convToUSmallint(void* value, DType thisDType, void* result) {
-    switch (thisDType) {
-        case DT_STRING: 
-            sscanf((char*)value, "%hu", result);
-            break;
-        case DT_INT1: 
-            *(uint16_t*) result = (uint16_t)*(int8_t*)value;
-            break;
-        case DT_INT2: 
-            *(uint16_t*) result = (uint16_t)*(int16_t*)value;
-            break;
-        case DT_INT4:
-            *(uint16_t*) result = (uint16_t)*(int32_t*)value;
-            break;
-        case DT_INT8:
-            *(uint16_t*) result = (uint16_t)*(int64_t*)value;
-            break;
-        case DT_UINT1: 
-            *(uint16_t*) result = (uint16_t)*(uint8_t*)value;
-            break;
-        case DT_UINT2: 
-            *(uint16_t*) result = *(uint16_t*)value;
-            break;
-        case DT_UINT4:
-            *(uint16_t*) result = (uint16_t)*(uint32_t*)value;
-            break;
-        case DT_UINT8:
-            *(uint16_t*) result = (uint16_t)*(uint64_t*)value;
-            break;
-        case DT_REAL4:
-            *(uint16_t*) result = (uint16_t)*(float*)value;
-            break;
-        case DT_REAL8:
-            *(uint16_t*) result = (uint16_t)*(double*)value;
-            break;
-        default:
-            DBIngestor_error("castDTypeToDBType: DType not known, I don't know what to do.", NULL);
+    
+    inline std::string formatValue(uint8_t value) {
+        return boost::lexical_cast<std::string>(static_cast<int>(value));
     }
-}
-
-void convToFloat(void* value, DType thisDType, void* result) {
-    switch (thisDType) {
-        case DT_STRING: {
-#ifdef _WIN32
-            double tmp = strtod((char*)value, NULL);
-            *(float*)result = (float)tmp;
-#else
-            *(float*)result = strtof((char*)value, NULL);
-#endif
+    
+    //converts one value of C type fromT into the C type of toThisType
+    template<typename fromT, DBType toThisType> struct ValueCast {
+        typedef typename DBTypeTraits<toThisType>::Type ToT;
+        static inline ToT cast(fromT value) {
+            return (ToT)value;
+        }
+    };
+    
+    //strings are parsed into the widest type of the same kind and then narrowed
+    template<DBType toThisType> struct ValueCast<char*, toThisType> {
+        typedef typename DBTypeTraits<toThisType>::Type ToT;
+        typedef typename DBTypeTraits<toThisType>::ParseType ParseT;
+        static inline ToT cast(char* value) {
+            ParseT parsed;
+            parseString(value, &parsed);
+            return ValueCast<ParseT, toThisType>::cast(parsed);
+        }
+    };
+    
+    template<typename fromT> struct ValueCast<fromT, DBT_BIT> {
+        static inline int8_t cast(fromT value) {
+            return ((int8_t)value != 0) ? 1 : 0;
+        }
+    };
+    
+    template<> struct ValueCast<char*, DBT_BIT> {
+        static inline int8_t cast(char* value) {
+            int64_t parsed;
+            parseString(value, &parsed);
+            return ValueCast<int64_t, DBT_BIT>::cast(parsed);
+        }
+    };
+    
+    //strings are allocated here and need to be freed by whoever owns the result
+    template<typename fromT> struct ValueCast<fromT, DBT_CHAR> {
+        static inline char* cast(fromT value) {
+            std::string tmpStr = formatValue(value);
+            return copyString(tmpStr.c_str(), tmpStr.size());
+        }
+    };
+    
+    template<> struct ValueCast<char*, DBT_CHAR> {
+        static inline char* cast(char* value) {
+            return copyString(value, strlen(value));
+        }
+    };
+    
+    template<DType fromThisType, DBType toThisType> struct CastKernel {
+        typedef typename DTypeTraits<fromThisType>::Type FromT;
+        typedef typename DBTypeTraits<toThisType>::Type ToT;
+        
+        //the value is stored as is, a column can be copied in one go
+        static const bool isIdentity = IsSameType<FromT, ToT>::value && toThisType != DBT_BIT && toThisType != DBT_CHAR;
+        
+        static void cast(void * value, void * result) {
+            FromT in;
+            memcpy(&in, value, sizeof(FromT));
+            ToT out = ValueCast<FromT, toThisType>::cast(in);
+            memcpy(result, &out, sizeof(ToT));
+        }
+        
+        static void castColumn(void * values, int64_t valueStride, void * results, int64_t resultStride, int64_t numValues) {
+            char * in = (char*)values;
+            char * out = (char*)results;
+            
+            if(isIdentity == true) {
+                if(valueStride == sizeof(FromT) && resultStride == sizeof(ToT)) {
+                    memcpy(out, in, numValues * sizeof(FromT));
+                } else {
+                    for(int64_t i=0; i<numValues; i++) {
+                        memcpy(out + i*resultStride, in + i*valueStride, sizeof(FromT));
+                    }
+                }
+                
+                return;
             }
-            break;
-        case DT_INT1: 
-            *(float*) result = (float)*(int8_t*)value;
-            break;
-        case DT_INT2: 
-            *(float*) result = (float)*(int16_t*)value;
-            break;
-        case DT_INT4:
-            *(float*) result = (float)*(int32_t*)value;
-            break;
-        case DT_INT8:
-            *(float*) result = (float)*(int64_t*)value;
-            break;
-        case DT_UINT1: 
-            *(float*) result = (float)*(uint8_t*)value;
-            break;
-        case DT_UINT2: 
-            *(float*) result = (float)*(uint16_t*)value;
-            break;
-        case DT_UINT4:
-            *(float*) result = (float)*(uint32_t*)value;
-            break;
-        case DT_UINT8:
-            *(float*) result = (float)*(uint64_t*)value;
-            break;
-        case DT_REAL4:
-            *(float*) result = *(float*)value;
-            break;
-        case DT_REAL8:
-            *(float*) result = (float)*(double*)value;
-            break;
-        default:
-            DBIngestor_error("castDTypeToDBType: DType not known, I don't know what to do.", NULL);
+            
+            //dense columns: constant strides let the compiler vectorize the widening/narrowing
+            if(valueStride == sizeof(FromT) && resultStride == sizeof(ToT)) {
+                for(int64_t i=0; i<numValues; i++) {
+                    cast(in + i*sizeof(FromT), out + i*sizeof(ToT));
+                }
+            } else {
+                for(int64_t i=0; i<numValues; i++) {
+                    cast(in + i*valueStride, out + i*resultStride);
+                }
+            }
+        }
+    };
+    
+    //DBT_ANY keeps the value in the type it was read in
+    template<DType fromThisType> struct CastKernel<fromThisType, DBT_ANY> : public CastKernel<fromThisType, DTypeTraits<fromThisType>::anyDBType> {
+    };
+    
+    template<DType fromThisType> struct CastKernel<fromThisType, DBT_DATE> {
+        static const bool isIdentity = false;
+        
+        static void cast(void * value, void * result) {
+            DBIngestor_error("castDTypeToDBType: Date types not yet supported.", NULL);
+        }
+        
+        static void castColumn(void * values, int64_t valueStride, void * results, int64_t resultStride, int64_t numValues) {
+            DBIngestor_error("castDTypeToDBType: Date types not yet supported.", NULL);
+        }
+    };
+    
+    template<DType fromThisType> struct CastKernel<fromThisType, DBT_TIME> {
+        static const bool isIdentity = false;
+        
+        static void cast(void * value, void * result) {
+            DBIngestor_error("castDTypeToDBType: Time types not yet supported.", NULL);
+        }
+        
+        static void castColumn(void * values, int64_t valueStride, void * results, int64_t resultStride, int64_t numValues) {
+            DBIngestor_error("castDTypeToDBType: Time types not yet supported.", NULL);
+        }
+    };
+    
+    //the DT_MAXTYPE x DBT_MAXTYPE matrix of kernels, indexed by the enum values (0 is unused)
+#define DBT_CAST_KERNEL_ROW(FROM, MEMBER) \
+    { NULL, \
+      CastKernel<FROM, DBT_CHAR>::MEMBER, \
+      CastKernel<FROM, DBT_BIT>::MEMBER, \
+      CastKernel<FROM, DBT_BIGINT>::MEMBER, \
+      CastKernel<FROM, DBT_MEDIUMINT>::MEMBER, \
+      CastKernel<FROM, DBT_INTEGER>::MEMBER, \
+      CastKernel<FROM, DBT_SMALLINT>::MEMBER, \
+      CastKernel<FROM, DBT_TINYINT>::MEMBER, \
+      CastKernel<FROM, DBT_FLOAT>::MEMBER, \
+      CastKernel<FROM, DBT_REAL>::MEMBER, \
+      CastKernel<FROM, DBT_DATE>::MEMBER, \
+      CastKernel<FROM, DBT_TIME>::MEMBER, \
+      CastKernel<FROM, DBT_ANY>::MEMBER, \
+      CastKernel<FROM, DBT_UBIGINT>::MEMBER, \
+      CastKernel<FROM, DBT_UMEDIUMINT>::MEMBER, \
+      CastKernel<FROM, DBT_UINTEGER>::MEMBER, \
+      CastKernel<FROM, DBT_USMALLINT>::MEMBER, \
+      CastKernel<FROM, DBT_UTINYINT>::MEMBER, \
+      CastKernel<FROM, DBT_UFLOAT>::MEMBER, \
+      CastKernel<FROM, DBT_UREAL>::MEMBER \
     }
-}
+    
+static const DBTypeCastFunc castFuncTable[DT_MAXTYPE+1][DBT_MAXTYPE+1] = {
+    { NULL },
+    DBT_CAST_KERNEL_ROW(DT_STRING, cast),
+    DBT_CAST_KERNEL_ROW(DT_INT1, cast),
+    DBT_CAST_KERNEL_ROW(DT_INT2, cast),
+    DBT_CAST_KERNEL_ROW(DT_INT4, cast),
+    DBT_CAST_KERNEL_ROW(DT_INT8, cast),
+    DBT_CAST_KERNEL_ROW(DT_REAL4, cast),
+    DBT_CAST_KERNEL_ROW(DT_REAL8, cast),
+    DBT_CAST_KERNEL_ROW(DT_UINT1, cast),
+    DBT_CAST_KERNEL_ROW(DT_UINT2, cast),
+    DBT_CAST_KERNEL_ROW(DT_UINT4, cast),
+    DBT_CAST_KERNEL_ROW(DT_UINT8, cast)
+};
 
-void convToReal(void* value, DType thisDType, void* result) {
-    switch (thisDType) {
-        case DT_STRING: 
-            *(double*)result = strtod((char*)value, NULL);
-            break;
-        case DT_INT1: 
-            *(double*) result = (double)*(int8_t*)value;
-            break;
-        case DT_INT2: 
-            *(double*) result = (double)*(int16_t*)value;
-            break;
-        case DT_INT4:
-            *(double*) result = (double)*(int32_t*)value;
-            break;
-        case DT_INT8:
-            *(double*) result = (double)*(int64_t*)value;
-            break;
-        case DT_UINT1: 
-            *(double*) result = (double)*(uint8_t*)value;
-            break;
-        case DT_UINT2: 
-            *(double*) result = (double)*(uint16_t*)value;
-            break;
-        case DT_UINT4:
-            *(double*) result = (double)*(uint32_t*)value;
-            break;
-        case DT_UINT8:
-            *(double*) result = (double)*(uint64_t*)value;
-            break;
-        case DT_REAL4:
-            *(double*) result = (double)*(float*)value;
-            break;
-        case DT_REAL8:
-            *(double*) result = *(double*)value;
-            break;
-        default:
+static const DBTypeColumnCastFunc castColumnFuncTable[DT_MAXTYPE+1][DBT_MAXTYPE+1] = {
+    { NULL },
+    DBT_CAST_KERNEL_ROW(DT_STRING, castColumn),
+    DBT_CAST_KERNEL_ROW(DT_INT1, castColumn),
+    DBT_CAST_KERNEL_ROW(DT_INT2, castColumn),
+    DBT_CAST_KERNEL_ROW(DT_INT4, castColumn),
+    DBT_CAST_KERNEL_ROW(DT_INT8, castColumn),
+    DBT_CAST_KERNEL_ROW(DT_REAL4, castColumn),
+    DBT_CAST_KERNEL_ROW(DT_REAL8, castColumn),
+    DBT_CAST_KERNEL_ROW(DT_UINT1, castColumn),
+    DBT_CAST_KERNEL_ROW(DT_UINT2, castColumn),
+    DBT_CAST_KERNEL_ROW(DT_UINT4, castColumn),
+    DBT_CAST_KERNEL_ROW(DT_UINT8, castColumn)
+};
+
+static const bool isIdentityTable[DT_MAXTYPE+1][DBT_MAXTYPE+1] = {
+    { NULL },
+    DBT_CAST_KERNEL_ROW(DT_STRING, isIdentity),
+    DBT_CAST_KERNEL_ROW(DT_INT1, isIdentity),
+    DBT_CAST_KERNEL_ROW(DT_INT2, isIdentity),
+    DBT_CAST_KERNEL_ROW(DT_INT4, isIdentity),
+    DBT_CAST_KERNEL_ROW(DT_INT8, isIdentity),
+    DBT_CAST_KERNEL_ROW(DT_REAL4, isIdentity),
+    DBT_CAST_KERNEL_ROW(DT_REAL8, isIdentity),
+    DBT_CAST_KERNEL_ROW(DT_UINT1, isIdentity),
+    DBT_CAST_KERNEL_ROW(DT_UINT2, isIdentity),
+    DBT_CAST_KERNEL_ROW(DT_UINT4, isIdentity),
+    DBT_CAST_KERNEL_ROW(DT_UINT8, isIdentity)
+};
+
+#undef DBT_CAST_KERNEL_ROW
+    
+    inline void checkCastTypes(DType fromThisType, DBType toThisType) {
+        if(fromThisType < 1 || fromThisType > DT_MAXTYPE) {
             DBIngestor_error("castDTypeToDBType: DType not known, I don't know what to do.", NULL);
+        }
+        
+        if(toThisType < 1 || toThisType > DBT_MAXTYPE) {
+            DBIngestor_error("castDTypeToDBType: DBType not known, I don't know what to do.", NULL);
+        }
     }
 }
 
-void convToDate(void* value, DType thisDType, void* result) {
-    DBIngestor_error("castDTypeToDBType: Date types not yet supported.", NULL);
+void DBDataSchema::castDTypeToDBType(void * value, DType fromThisType, DBType toThisType, void* result) {
+    checkCastTypes(fromThisType, toThisType);
+    
+    castFuncTable[fromThisType][toThisType](value, result);
 }
 
-void convToTime(void* value, DType thisDType, void* result) {
-    DBIngestor_error("castDTypeToDBType: Time types not yet supported.", NULL);
+DBTypeCastFunc DBDataSchema::getCastFunc(DType fromThisType, DBType toThisType) {
+    checkCastTypes(fromThisType, toThisType);
+    
+    return castFuncTable[fromThisType][toThisType];
 }
 
-void convToAny(void* value, DType thisDType, void* result) {
-    string tmpStr;
-    char * outputStr;
+DBTypeColumnCastFunc DBDataSchema::getColumnCastFunc(DType fromThisType, DBType toThisType) {
+    checkCastTypes(fromThisType, toThisType);
+    
+    return castColumnFuncTable[fromThisType][toThisType];
+}
 
-    switch (thisDType) {
-        case DT_STRING: 
-            outputStr = (char*)malloc(strlen((char*)value)*sizeof(char));
-            strcpy(outputStr, (char*)value);
-            *(char**) result = outputStr;
-            break;
-        case DT_INT1: 
-            *(int8_t*) result = *(int8_t*)value;
-            break;
-        case DT_INT2: 
-            *(int16_t*) result = *(int16_t*)value;
-            break;
-        case DT_INT4:
-            *(int32_t*) result = *(int32_t*)value;
-            break;
-        case DT_INT8:
-            *(int64_t*) result = *(int64_t*)value;
-            break;
-        case DT_UINT1: 
-            *(uint8_t*) result = *(uint8_t*)value;
-            break;
-        case DT_UINT2: 
-            *(uint16_t*) result = *(uint16_t*)value;
-            break;
-        case DT_UINT4:
-            *(uint32_t*) result = *(uint32_t*)value;
-            break;
-        case DT_UINT8:
-            *(uint64_t*) result = *(uint64_t*)value;
-            break;
-        case DT_REAL4:
-            *(float*) result = *(float*)value;
-            break;
-        case DT_REAL8:
-            *(double*) result = *(double*)value;
-            break;
-        default:
-            DBIngestor_error("castDTypeToDBType: DType not known, I don't know what to do.", NULL);
-    }
+bool DBDataSchema::isIdentityCast(DType fromThisType, DBType toThisType) {
+    checkCastTypes(fromThisType, toThisType);
+    
+    return isIdentityTable[fromThisType][toThisType];
 }
 
 std::string DBDataSchema::strDBType(DBType thisType) {
@@ -57,12 +57,42 @@ namespace DBDataSchema {
     };
     
     
+    /*! \brief function casting one value of a given DType into a given DBType, see getCastFunc
+     */
+    typedef void (*DBTypeCastFunc)(void * value, void* result);
+    
+    /*! \brief function casting numValues values of a given DType into a given DBType, see getColumnCastFunc
+     
+     The values and results are read and written every valueStride and resultStride bytes, so that a column of
+     a row buffer can be converted as well as a dense array.*/
+    typedef void (*DBTypeColumnCastFunc)(void * values, int64_t valueStride, void * results, int64_t resultStride, int64_t numValues);
+    
     int getByteLenOfDBType(DBType thisType);
     
     //string casts are allocated in the function! as is a cast from string to string. memcpy involved!
     //freeing of the input string is responsibility of programmer. I would recomend use of std::string
     void castDTypeToDBType(void * value, DType fromThisType, DBType toThisType, void* result);
 
+    /*! \brief returns the cast kernel for one pair of types
+     \param DType fromThisType: type of the values to cast
+     \param DBType toThisType: type to cast into
+     \return function casting a single value, with the same semantics as castDTypeToDBType
+     
+     Use this to resolve the cast once per column instead of once per value.*/
+    DBTypeCastFunc getCastFunc(DType fromThisType, DBType toThisType);
+
+    /*! \brief returns the batched cast kernel for one pair of types
+     \param DType fromThisType: type of the values to cast
+     \param DBType toThisType: type to cast into
+     \return function casting a whole column of values
+     
+     If the value is stored as is (see isIdentityCast), the column is copied with memcpy.*/
+    DBTypeColumnCastFunc getColumnCastFunc(DType fromThisType, DBType toThisType);
+
+    /*! \brief returns true if a value of fromThisType is stored unchanged as toThisType
+     */
+    bool isIdentityCast(DType fromThisType, DBType toThisType);
+
     DBType convDTypeToDBType(DType thisDType);
     
     std::string strDBType(DBType thisType);
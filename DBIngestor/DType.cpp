@@ -22,6 +22,16 @@
 #include <stdio.h>
 #include <stdexcept>
 #include <boost/algorithm/string.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <locale.h>
+#include <limits>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
 #ifndef _WIN32
 #include <math.h>
 #include <stdint.h>
@@ -42,16 +52,26 @@ using namespace std;
 ////// PRIVATE FUNCTION FORWARD DECLARATION ///
 ///////////////////////////////////////////////
 
-int convToInt1(std::string & thisString, void* result);
-int convToInt2(std::string & thisString, void* result);
-int convToInt4(std::string & thisString, void* result);
-int convToInt8(std::string & thisString, void* result);
-int convToUInt1(std::string & thisString, void* result);
-int convToUInt2(std::string & thisString, void* result);
-int convToUInt4(std::string & thisString, void* result);
-int convToUInt8(std::string & thisString, void* result);
-int convToReal4(std::string & thisString, void* result);
-int convToReal8(std::string & thisString, void* result);
+namespace {
+    enum ParseStatus {
+        PARSE_OK = 0,
+        PARSE_NULL = 1,
+        PARSE_OUT_OF_RANGE = 2
+    };
+    
+    template<typename T> ParseStatus parseSigned(const char * thisString, size_t len, const char * numChars, void* result);
+    template<typename T> ParseStatus parseUnsigned(const char * thisString, size_t len, bool allowHex, void* result);
+    ParseStatus parseReal4(const char * thisString, size_t len, void* result);
+    ParseStatus parseReal8(const char * thisString, size_t len, void* result);
+    
+    //integers out of range raise an error if set, otherwise they are clamped and counted
+    bool strictRangeCheck = false;
+    int64_t numOutOfRange = 0;
+    boost::mutex outOfRangeMutex;
+}
+
+//number of values out of range that are reported with a warning
+#define DT_MAX_RANGE_WARNINGS 10
 
 ///////////////////////////////////////////////
 
@@ -157,54 +177,102 @@ DType DBDataSchema::convDType(std::string thisDType) {
     return (DType)0;    
 }
 
+void DBDataSchema::setStrictRangeCheck(bool newStrictRangeCheck) {
+    strictRangeCheck = newStrictRangeCheck;
+}
+
+bool DBDataSchema::getStrictRangeCheck() {
+    return strictRangeCheck;
+}
+
+int64_t DBDataSchema::getNumOutOfRange() {
+    boost::lock_guard<boost::mutex> lock(outOfRangeMutex);
+    return numOutOfRange;
+}
+
+void DBDataSchema::resetNumOutOfRange() {
+    boost::lock_guard<boost::mutex> lock(outOfRangeMutex);
+    numOutOfRange = 0;
+}
+
 int DBDataSchema::castStringToDType(std::string & thisString, DType thisType, void* result) {
-    int isNull = 0;
+    return castStringToDType(thisString.data(), thisString.size(), thisType, result);
+}
+
+//characters a number that reads as 0 may consist of, without being taken as NULL
+#define DT_NUMCHARS "0123456789.xXeE+- "
+#define DT_NUMCHARS_NANINF "0123456789.xXeEnaNAifIF+- "
+
+int DBDataSchema::castStringToDType(const char * thisString, size_t len, DType thisType, void* result) {
+    assert(thisString != NULL || len == 0);
+    
+    ParseStatus status = PARSE_OK;
     
     switch (thisType) {
         case DT_STRING: {
             //since we are only working with pointers to strings internaly, allocate memory, copy string and hope this
             //gets freed in the IngestBuffer....
-            char * tmpStr = (char*)malloc((thisString.size() + 1) * sizeof(char));
-            strncpy(tmpStr, thisString.c_str(), thisString.size());
-            tmpStr[thisString.size()] = '\0';
+            char * tmpStr = (char*)malloc((len + 1) * sizeof(char));
+            if(tmpStr == NULL) {
+                DBIngestor_error("castStringToDType: Not enough memory for allocating the string.\n", NULL);
+            }
+            memcpy(tmpStr, thisString, len);
+            tmpStr[len] = '\0';
             *(char**)result = tmpStr;}
             break;
         case DT_INT1:
-            isNull = convToInt1(thisString, result);
+            status = parseSigned<int8_t>(thisString, len, DT_NUMCHARS_NANINF, result);
             break;
         case DT_INT2:
-            isNull = convToInt2(thisString, result);
+            status = parseSigned<int16_t>(thisString, len, DT_NUMCHARS_NANINF, result);
             break;
         case DT_INT4:
-            isNull = convToInt4(thisString, result);
+            status = parseSigned<int32_t>(thisString, len, DT_NUMCHARS, result);
             break;
         case DT_INT8:
-            isNull = convToInt8(thisString, result);
+            status = parseSigned<int64_t>(thisString, len, DT_NUMCHARS, result);
             break;
         case DT_UINT1:
-            isNull = convToUInt1(thisString, result);
+            status = parseUnsigned<uint8_t>(thisString, len, false, result);
             break;
         case DT_UINT2:
-            isNull = convToUInt2(thisString, result);
+            status = parseUnsigned<uint16_t>(thisString, len, false, result);
             break;
         case DT_UINT4:
-            isNull = convToUInt4(thisString, result);
+            status = parseUnsigned<uint32_t>(thisString, len, true, result);
             break;
         case DT_UINT8:
-            isNull = convToUInt8(thisString, result);
+            status = parseUnsigned<uint64_t>(thisString, len, true, result);
             break;
         case DT_REAL4:
-            isNull = convToReal4(thisString, result);
+            status = parseReal4(thisString, len, result);
             break;
         case DT_REAL8:
-            isNull = convToReal8(thisString, result);
+            status = parseReal8(thisString, len, result);
             break;
         default:
             DBIngestor_error("castStringToDType: DType not known, I don't know what to do.", NULL);
             break;
     }
     
-    return isNull;
+    if(status == PARSE_OUT_OF_RANGE) {
+        if(strictRangeCheck == true) {
+            string errorStr = "castStringToDType: The value '" + string(thisString, len) + "' is out of range for its data type.\n";
+            DBIngestor_error(errorStr.c_str(), NULL);
+        }
+        
+        //the value has been clamped to the range of the type. only report the first few, a bad column would flood the output
+        boost::lock_guard<boost::mutex> lock(outOfRangeMutex);
+        numOutOfRange++;
+        if(numOutOfRange <= DT_MAX_RANGE_WARNINGS) {
+            printf("castStringToDType: Warning: The value '%s' is out of range for its data type, storing the closest value instead.\n", string(thisString, len).c_str());
+            if(numOutOfRange == DT_MAX_RANGE_WARNINGS) {
+                printf("castStringToDType: Further values out of range are not reported.\n");
+            }
+        }
+    }
+    
+    return (status == PARSE_NULL) ? 1 : 0;
 }
 
 void DBDataSchema::printThisDType(void* var, DType thisType) {
@@ -705,168 +773,383 @@ char * DBDataSchema::castToString(DType thisType, void* value) {
     return buffer;
 }
 
-int convToInt1(std::string & thisString, void* result) {
-    int32_t tmp;
-    tmp = strtol(thisString.c_str(), NULL, 10);
-    
-    //check if this could be a candiate for a NULL
-    //strol returns 0 if there was a character in there 
-    if(tmp == 0) {
-        if(thisString.find_first_not_of("0123456789.xXeEnaNAifIF+- ") != string::npos) {
-            return 1; 
-        }
+///////////////////////////////////////////////
+////// NUMBER PARSING /////////////////////////
+///////////////////////////////////////////////
+
+//the parsers work on pointer and length, need no terminating \0, do not allocate and do not depend on the
+//locale. As strtol/strtod did before, leading white space is skipped and parsing stops at the first character
+//that does not belong to the number. A value that reads as 0 (or NaN/Inf for reals) is taken as NULL if the
+//string contains characters that cannot be part of a number (e.g. "NULL" or "nan").
+
+namespace {
+    inline bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
     }
     
-    *(int8_t*)result = (int8_t)tmp;
+    inline bool isDigit(char c) {
+        return (unsigned char)(c - '0') < 10;
+    }
     
-    return 0;
-}
-
-int convToInt2(std::string & thisString, void* result) {
-    int32_t tmp;
-    tmp = strtol(thisString.c_str(), NULL, 10);
+    inline int hexValue(char c) {
+        if(isDigit(c)) return c - '0';
+        if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
     
-    //check if this could be a candiate for a NULL
-    //strol returns 0 if there was a character in there 
-    if(tmp == 0) {
-        if(thisString.find_first_not_of("0123456789.xXeEnaNAifIF+- ") != string::npos) {
-            return 1; 
+    bool hasNonNumChars(const char * thisString, size_t len, const char * numChars) {
+        for(size_t i=0; i<len; i++) {
+            if(thisString[i] == '\0' || strchr(numChars, thisString[i]) == NULL) {
+                return true;
+            }
         }
+        
+        return false;
     }
     
-    *(int16_t*)result = (int16_t)tmp;
-    
-    return 0;
-}
-
-int convToInt4(std::string & thisString, void* result) {
-    *(int32_t*)result = strtol(thisString.c_str(), NULL, 10);
-
-    //check if this could be a candiate for a NULL
-    //strol returns 0 if there was a character in there 
-    if(*(int32_t*)result == 0) {
-        if(thisString.find_first_not_of("0123456789.xXeE+- ") != string::npos) {
-            return 1; 
+    //reads sign and digits into magnitude, returns false if the magnitude does not fit into 64 bits
+    bool parseIntegerDigits(const char * thisString, size_t len, bool allowHex, uint64_t * magnitude, bool * isNegative) {
+        size_t i = 0;
+        bool fits = true;
+        uint64_t value = 0;
+        const uint64_t maxValue = std::numeric_limits<uint64_t>::max();
+        
+        while(i < len && isSpace(thisString[i])) {
+            i++;
         }
+        
+        *isNegative = false;
+        if(i < len && (thisString[i] == '-' || thisString[i] == '+')) {
+            *isNegative = (thisString[i] == '-');
+            i++;
+        }
+        
+        if(allowHex == true && i + 2 < len && thisString[i] == '0' && (thisString[i+1] == 'x' || thisString[i+1] == 'X') && hexValue(thisString[i+2]) >= 0) {
+            i += 2;
+            
+            for(; i < len && hexValue(thisString[i]) >= 0; i++) {
+                if(value > (maxValue >> 4)) {
+                    fits = false;
+                }
+                value = (value << 4) | (uint64_t)hexValue(thisString[i]);
+            }
+        } else {
+            for(; i < len && isDigit(thisString[i]); i++) {
+                uint64_t digit = (uint64_t)(thisString[i] - '0');
+                
+                if(value > (maxValue - digit) / 10) {
+                    fits = false;
+                }
+                value = value * 10 + digit;
+            }
+        }
+        
+        *magnitude = value;
+        return fits;
     }
     
-    return 0;
-}
-
-int convToInt8(std::string & thisString, void* result) {
-#ifdef _WIN32
-    *(int64_t*)result = _strtoi64(thisString.c_str(), NULL, 10);
-#else
-    *(int64_t*)result = strtoll(thisString.c_str(), NULL, 10);
-#endif
-
-    //check if this could be a candiate for a NULL
-    //strol returns 0 if there was a character in there 
-    if(*(int64_t*)result == 0) {
-        if(thisString.find_first_not_of("0123456789.xXeE+- ") != string::npos) {
-            return 1; 
+    template<typename T> ParseStatus parseSigned(const char * thisString, size_t len, const char * numChars, void* result) {
+        uint64_t magnitude;
+        bool isNegative;
+        bool fits = parseIntegerDigits(thisString, len, false, &magnitude, &isNegative);
+        
+        if(fits == true && magnitude == 0) {
+            if(hasNonNumChars(thisString, len, numChars) == true) {
+                return PARSE_NULL;
+            }
+            
+            T value = 0;
+            memcpy(result, &value, sizeof(T));
+            return PARSE_OK;
+        }
+        
+        uint64_t limit = (uint64_t)std::numeric_limits<T>::max();
+        if(isNegative == true) {
+            limit += 1;
         }
+        
+        if(fits == false || magnitude > limit) {
+            T value = (isNegative == true) ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+            memcpy(result, &value, sizeof(T));
+            return PARSE_OUT_OF_RANGE;
+        }
+        
+        //negate without overflowing on the minimum value
+        T value = (isNegative == true) ? (T)(-(int64_t)(magnitude - 1) - 1) : (T)magnitude;
+        memcpy(result, &value, sizeof(T));
+        
+        return PARSE_OK;
     }
     
-    return 0;
-}
-
-int convToUInt1(std::string & thisString, void* result) {
-    int32_t tmp;
-    tmp = strtol(thisString.c_str(), NULL, 10);
-
-    //check if this could be a candiate for a NULL
-    //strol returns 0 if there was a character in there 
-    if(tmp == 0) {
-        if(thisString.find_first_not_of("0123456789.xXeE+- ") != string::npos) {
-            return 1; 
+    template<typename T> ParseStatus parseUnsigned(const char * thisString, size_t len, bool allowHex, void* result) {
+        uint64_t magnitude;
+        bool isNegative;
+        bool fits = parseIntegerDigits(thisString, len, allowHex, &magnitude, &isNegative);
+        
+        if(fits == true && magnitude == 0) {
+            if(hasNonNumChars(thisString, len, DT_NUMCHARS) == true) {
+                return PARSE_NULL;
+            }
+            
+            T value = 0;
+            memcpy(result, &value, sizeof(T));
+            return PARSE_OK;
         }
+        
+        if(fits == false || isNegative == true || magnitude > (uint64_t)std::numeric_limits<T>::max()) {
+            T value = (isNegative == true) ? 0 : std::numeric_limits<T>::max();
+            memcpy(result, &value, sizeof(T));
+            return PARSE_OUT_OF_RANGE;
+        }
+        
+        T value = (T)magnitude;
+        memcpy(result, &value, sizeof(T));
+        
+        return PARSE_OK;
     }
     
-    *(uint8_t*)result = (uint8_t)tmp;
-
-    return 0;
-}
-
-int convToUInt2(std::string & thisString, void* result) {
-    int32_t tmp;
-    tmp = strtol(thisString.c_str(), NULL, 10);
+    //powers of ten that are exactly representable in double/float
+    const double exactPow10d[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
     
-    //check if this could be a candiate for a NULL
-    //strol returns 0 if there was a character in there 
-    if(tmp == 0) {
-        if(thisString.find_first_not_of("0123456789.xXeE+- ") != string::npos) {
-            return 1; 
-        }
-    }
+    const float exactPow10f[] = {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
     
-    *(uint16_t*)result = (uint16_t)tmp;
+    //the decimal number as read from the string: mantissa * 10^exponent
+    struct DecimalNumber {
+        uint64_t mantissa;
+        int64_t exponent;
+        bool isNegative;
+        bool hasDigits;
+        bool isTruncated;
+        bool needsFallback;
+    };
     
-    return 0;
-}
-
-int convToUInt4(std::string & thisString, void* result) {
-    *(uint32_t*)result = strtoul(thisString.c_str(), NULL, 0);
-
-    //check if this could be a candiate for a NULL
-    //strol returns 0 if there was a character in there 
-    if(*(uint32_t*)result == 0) {
-        if(thisString.find_first_not_of("0123456789.xXeE+- ") != string::npos) {
-            return 1; 
+    void parseDecimal(const char * thisString, size_t len, DecimalNumber * number) {
+        size_t i = 0;
+        int numSigDigits = 0;
+        
+        number->mantissa = 0;
+        number->exponent = 0;
+        number->isNegative = false;
+        number->hasDigits = false;
+        number->isTruncated = false;
+        number->needsFallback = false;
+        
+        while(i < len && isSpace(thisString[i])) {
+            i++;
+        }
+        
+        if(i < len && (thisString[i] == '-' || thisString[i] == '+')) {
+            number->isNegative = (thisString[i] == '-');
+            i++;
+        }
+        
+        size_t startDigits = i;
+        
+        //integer part, then fraction. only the first 19 significant digits fit into the mantissa
+        for(int part=0; part<2; part++) {
+            for(; i < len && isDigit(thisString[i]); i++) {
+                number->hasDigits = true;
+                
+                if(number->mantissa == 0 && thisString[i] == '0') {
+                    if(part == 1) {
+                        number->exponent--;
+                    }
+                    continue;
+                }
+                
+                if(numSigDigits < 19) {
+                    number->mantissa = number->mantissa * 10 + (uint64_t)(thisString[i] - '0');
+                    numSigDigits++;
+                    if(part == 1) {
+                        number->exponent--;
+                    }
+                } else {
+                    if(thisString[i] != '0') {
+                        number->isTruncated = true;
+                    }
+                    if(part == 0) {
+                        number->exponent++;
+                    }
+                }
+            }
+            
+            if(part == 0) {
+                if(i < len && thisString[i] == '.') {
+                    i++;
+                } else {
+                    break;
+                }
+            }
+        }
+        
+        if(number->hasDigits == false) {
+            return;
+        }
+        
+        //hexadecimal floats are left to the C library
+        if(i < len && (thisString[i] == 'x' || thisString[i] == 'X') && i == startDigits + 1) {
+            number->needsFallback = true;
+            return;
+        }
+        
+        if(i < len && (thisString[i] == 'e' || thisString[i] == 'E')) {
+            size_t j = i + 1;
+            bool isExpNegative = false;
+            int64_t expValue = 0;
+            
+            if(j < len && (thisString[j] == '-' || thisString[j] == '+')) {
+                isExpNegative = (thisString[j] == '-');
+                j++;
+            }
+            
+            if(j < len && isDigit(thisString[j])) {
+                for(; j < len && isDigit(thisString[j]); j++) {
+                    //anything beyond this is inf or 0 anyway
+                    if(expValue < 100000) {
+                        expValue = expValue * 10 + (thisString[j] - '0');
+                    }
+                }
+                
+                number->exponent += (isExpNegative == true) ? -expValue : expValue;
+            }
         }
     }
     
-    return 0;
-}
-
-int convToUInt8(std::string & thisString, void* result) {
-#ifdef _WIN32
-    *(uint64_t*)result = _strtoui64(thisString.c_str(), NULL, 0);
-#else
-    *(uint64_t*)result = strtoull(thisString.c_str(), NULL, 0);
-#endif
-
-    //check if this could be a candiate for a NULL
-    //strol returns 0 if there was a character in there 
-    if(*(uint64_t*)result == 0) {
-        if(thisString.find_first_not_of("0123456789.xXeE+- ") != string::npos) {
-            return 1; 
+    //number of white space characters in front of the number
+    size_t skipSpaces(const char * thisString, size_t len) {
+        size_t i = 0;
+        
+        while(i < len && isSpace(thisString[i])) {
+            i++;
         }
+        
+        return i;
     }
     
-    return 0;
-}
-
-int convToReal4(std::string & thisString, void* result) {
+    //correctly rounded, but slower fallback for the numbers the fast path cannot handle
+    double fallbackStrtod(const char * thisString, size_t len, bool isFloat) {
+        char stackBuffer[64];
+        std::string heapBuffer;
+        const char * terminated;
+        
+        if(len < sizeof(stackBuffer)) {
+            memcpy(stackBuffer, thisString, len);
+            stackBuffer[len] = '\0';
+            terminated = stackBuffer;
+        } else {
+            heapBuffer.assign(thisString, len);
+            terminated = heapBuffer.c_str();
+        }
+        
 #ifdef _WIN32
-    double tmp = strtod(thisString.c_str(), NULL);
-    *(float*)result = (float)tmp;
+        static _locale_t cLocale = _create_locale(LC_ALL, "C");
+        if(isFloat == true) {
+            return (double)(float)_strtod_l(terminated, NULL, cLocale);
+        }
+        return _strtod_l(terminated, NULL, cLocale);
 #else
-    *(float*)result = strtof(thisString.c_str(), NULL);
+        static locale_t cLocale = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+        if(isFloat == true) {
+            return (double)strtof_l(terminated, NULL, cLocale);
+        }
+        return strtod_l(terminated, NULL, cLocale);
 #endif
-
-    //check if this could be a candiate for a NULL
-    //strol returns 0 if there was a character in there 
-    if(*(float*)result == 0.0 || isnan(*(float*)result) || isinf(*(float*)result)) {
-        if(thisString.find_first_not_of("0123456789.xXeE+- ") != string::npos) {
-            return 1; 
+    }
+    
+    //NaN and Inf are spelled out and therefore NULL, as before
+    ParseStatus checkRealWithoutDigits(const char * thisString, size_t len) {
+        if(hasNonNumChars(thisString, len, DT_NUMCHARS) == true) {
+            return PARSE_NULL;
         }
+        
+        return PARSE_OK;
     }
     
-    return 0;
-}
-
-int convToReal8(std::string & thisString, void* result) {
-    *(double*)result = strtod(thisString.c_str(), NULL);
-
-    //check if this could be a candiate for a NULL
-    //strol returns 0 if there was a character in there 
-    if(*(double*)result == 0.0 || isnan(*(double*)result) || isinf(*(double*)result)) {
-        if(thisString.find_first_not_of("0123456789.xXeE+- ") != string::npos) {
-            return 1; 
+    ParseStatus parseReal8(const char * thisString, size_t len, void* result) {
+        DecimalNumber number;
+        double value;
+        
+        parseDecimal(thisString, len, &number);
+        
+        if(number.hasDigits == false) {
+            ParseStatus status = checkRealWithoutDigits(thisString, len);
+            value = 0.0;
+            memcpy(result, &value, sizeof(double));
+            return status;
         }
+        
+        if(number.needsFallback == false && number.mantissa == 0) {
+            value = (number.isNegative == true) ? -0.0 : 0.0;
+            if(hasNonNumChars(thisString, len, DT_NUMCHARS) == true) {
+                return PARSE_NULL;
+            }
+        } else if(number.needsFallback == false && number.isTruncated == false && number.mantissa <= (1ULL << 53) && 
+                  number.exponent >= -22 && number.exponent <= 22) {
+            //Clinger's fast path: both operands are exact, so the result is correctly rounded
+            value = (double)number.mantissa;
+            if(number.exponent < 0) {
+                value /= exactPow10d[-number.exponent];
+            } else {
+                value *= exactPow10d[number.exponent];
+            }
+            
+            if(number.isNegative == true) {
+                value = -value;
+            }
+        } else {
+            size_t start = skipSpaces(thisString, len);
+            //values beyond the range of the type are stored as +-inf, as strtod does
+            value = fallbackStrtod(thisString + start, len - start, false);
+        }
+        
+        memcpy(result, &value, sizeof(double));
+        return PARSE_OK;
     }
     
-    return 0;
+    ParseStatus parseReal4(const char * thisString, size_t len, void* result) {
+        DecimalNumber number;
+        float value;
+        
+        parseDecimal(thisString, len, &number);
+        
+        if(number.hasDigits == false) {
+            ParseStatus status = checkRealWithoutDigits(thisString, len);
+            value = 0.0f;
+            memcpy(result, &value, sizeof(float));
+            return status;
+        }
+        
+        if(number.needsFallback == false && number.mantissa == 0) {
+            value = (number.isNegative == true) ? -0.0f : 0.0f;
+            if(hasNonNumChars(thisString, len, DT_NUMCHARS) == true) {
+                return PARSE_NULL;
+            }
+        } else if(number.needsFallback == false && number.isTruncated == false && number.mantissa <= (1ULL << 24) && 
+                  number.exponent >= -10 && number.exponent <= 10) {
+            //Clinger's fast path in single precision
+            value = (float)number.mantissa;
+            if(number.exponent < 0) {
+                value /= exactPow10f[-number.exponent];
+            } else {
+                value *= exactPow10f[number.exponent];
+            }
+            
+            if(number.isNegative == true) {
+                value = -value;
+            }
+        } else {
+            size_t start = skipSpaces(thisString, len);
+            //values beyond the range of the type are stored as +-inf, as strtod does
+            value = (float)fallbackStrtod(thisString + start, len - start, true);
+        }
+        
+        memcpy(result, &value, sizeof(float));
+        return PARSE_OK;
+    }
 }
-
@@ -62,6 +62,35 @@ namespace DBDataSchema {
         
     int castStringToDType(std::string & thisString, DType thisType, void* result);
     
+    /*! \brief casts a string into a given DType
+     \param const char * thisString: the string, does not need to be terminated by \0
+     \param size_t len: length of thisString
+     \param DType thisType: DType to cast the string into
+     \param void* result: the casted value. strings are allocated and need to be freed
+     \return 1 if the value is NULL, 0 if not
+     
+     Numbers are parsed without allocating memory and independent of the locale. A REAL4 or REAL8 value beyond the
+     range of thisType is stored as +inf or -inf. An integer that does not fit into thisType is stored as the closest
+     value of the type (e.g. 127 for "300" in an INT1, 0 for "-1" in a UINT4), counted (see getNumOutOfRange) and the
+     first few are reported with a warning. With setStrictRangeCheck such an integer raises an error instead.*/
+    int castStringToDType(const char * thisString, size_t len, DType thisType, void* result);
+    
+    /*! \brief sets whether integers out of range stop the ingest
+     \param bool newStrictRangeCheck: true if an integer that does not fit into its DType raises an error, false
+                if it is clamped to the range of the DType (default)
+     
+     Applies to all castStringToDType calls of the process.*/
+    void setStrictRangeCheck(bool newStrictRangeCheck);
+    
+    bool getStrictRangeCheck();
+    
+    /*! \brief returns the number of integers castStringToDType clamped to the range of their DType
+     
+     Counted over all threads since the last resetNumOutOfRange.*/
+    int64_t getNumOutOfRange();
+    
+    void resetNumOutOfRange();
+    
     void printThisDType(void* var, DType thisType);
     
     int getByteLenOfDType(DType thisType);
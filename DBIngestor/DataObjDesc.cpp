@@ -30,8 +30,7 @@ DataObjDesc::DataObjDesc() {
     isConstData = 0;
     isHeaderItem = 0;
     constData = NULL;
-    conversionEvaluated = false;
-    assertionsEvaluated = false;
+    contextId = -1;
 }
 
 DataObjDesc::~DataObjDesc() {
@@ -144,25 +143,10 @@ void DataObjDesc::setDataObjDType(DType newDataObjDType) {
     dataObjDType = newDataObjDType;
 }
 
-bool DataObjDesc::getConversionEvaluated() {
-    return conversionEvaluated;
+int DataObjDesc::getContextId() {
+    return contextId;
 }
 
-bool DataObjDesc::setConversionEvaluated(bool value) {
-    conversionEvaluated = value;
+void DataObjDesc::setContextId(int newContextId) {
+    contextId = newContextId;
 }
-
-bool DataObjDesc::getAssertionEvaluated() {
-    return assertionsEvaluated;
-}
-
-bool DataObjDesc::setAssertionEvaluated(bool value) {
-    assertionsEvaluated = value;
-}
-
-bool DataObjDesc::resetForNextRow() {
-    conversionEvaluated = false;
-    assertionsEvaluated = false;
-}
-
-
@@ -103,17 +103,10 @@ namespace DBDataSchema {
          */
         std::vector<DBAsserter::Asserter*> assertions;
 
-        /* \var bool conversionsEvaluated
-         true if conversions have already been evaluated for this item in current row
-         false if not
+        /* \var int contextId
+         index of this data object in the RowContext, assigned by Schema::compile. -1 if not compiled
          */
-        bool conversionEvaluated;
-
-        /* \var bool assertionsEvaluated
-         true if assertions have already been evaluated for this item in current row
-         false if not
-         */
-        bool assertionsEvaluated;
+        int contextId;
 
 	public:
         DataObjDesc();
@@ -160,15 +153,9 @@ namespace DBDataSchema {
 	
 		void setDataObjDType(DType newDataObjDType);
 
-        bool getConversionEvaluated();
-
-        bool setConversionEvaluated(bool value);
-
-        bool getAssertionEvaluated();
-
-        bool setAssertionEvaluated(bool value);
+        int getContextId();
 
-        bool resetForNextRow();
+        void setContextId(int newContextId);
 	};
 }
 
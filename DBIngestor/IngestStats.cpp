@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>,
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "IngestStats.h"
+#include <assert.h>
+#include <stdio.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+using namespace DBIngest;
+using namespace std;
+
+IngestStats::IngestStats() {
+    reset();
+}
+
+IngestStats::~IngestStats() {
+
+}
+
+int64_t IngestStats::getTimestamp() {
+#ifdef _WIN32
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+
+    return (int64_t)((double)counter.QuadPart * 1.0e9 / (double)frequency.QuadPart);
+#else
+    struct timespec currTime;
+    clock_gettime(CLOCK_MONOTONIC, &currTime);
+
+    return (int64_t)currTime.tv_sec * 1000000000 + (int64_t)currTime.tv_nsec;
+#endif
+}
+
+string IngestStats::getStageName(IngestStage thisStage) {
+    switch (thisStage) {
+        case STAGE_READ_ROW:
+            return "read row";
+        case STAGE_PARSE:
+            return "parse";
+        case STAGE_ASSERT:
+            return "asserters";
+        case STAGE_CONVERT:
+            return "converters";
+        case STAGE_CAST:
+            return "cast";
+        case STAGE_BIND:
+            return "bind";
+        case STAGE_EXECUTE:
+            return "execute";
+        case STAGE_FREE:
+            return "free";
+        default:
+            return "unknown";
+    }
+}
+
+void IngestStats::addTime(IngestStage thisStage, int64_t nanosec, int64_t numCalls) {
+    assert(thisStage >= 0 && thisStage < STAGE_MAXSTAGE);
+
+    stageTime[thisStage] += nanosec;
+    stageCalls[thisStage] += numCalls;
+}
+
+bool IngestStats::enterNested() {
+    nestingDepth++;
+
+    return nestingDepth == 1;
+}
+
+void IngestStats::leaveNested() {
+    assert(nestingDepth > 0);
+
+    nestingDepth--;
+}
+
+void IngestStats::merge(IngestStats & otherStats) {
+    for(int i=0; i<STAGE_MAXSTAGE; i++) {
+        stageTime[i] += otherStats.stageTime[i];
+        stageCalls[i] += otherStats.stageCalls[i];
+    }
+}
+
+void IngestStats::reset() {
+    for(int i=0; i<STAGE_MAXSTAGE; i++) {
+        stageTime[i] = 0;
+        stageCalls[i] = 0;
+    }
+
+    nestingDepth = 0;
+}
+
+int64_t IngestStats::getStageTime(IngestStage thisStage) {
+    assert(thisStage >= 0 && thisStage < STAGE_MAXSTAGE);
+
+    return stageTime[thisStage];
+}
+
+int64_t IngestStats::getStageCalls(IngestStage thisStage) {
+    assert(thisStage >= 0 && thisStage < STAGE_MAXSTAGE);
+
+    return stageCalls[thisStage];
+}
+
+void IngestStats::printSummary(int64_t wallTime) {
+    printf("Time spent in each stage (summed over all threads, wall time %.3f s):\n", (double)wallTime / 1.0e9);
+    printf("%-12s %14s %12s %12s %8s\n", "stage", "calls", "total [ms]", "per call [ns]", "share");
+
+    for(int i=0; i<STAGE_MAXSTAGE; i++) {
+        double perCall = 0.0;
+        double share = 0.0;
+
+        if(stageCalls[i] > 0) {
+            perCall = (double)stageTime[i] / (double)stageCalls[i];
+        }
+
+        if(wallTime > 0) {
+            share = (double)stageTime[i] / (double)wallTime * 100.0;
+        }
+
+        printf("%-12s %14lld %12.1f %12.1f %7.1f%%\n", getStageName((IngestStage)i).c_str(), (long long)stageCalls[i],
+               (double)stageTime[i] / 1.0e6, perCall, share);
+    }
+
+    fflush(stdout);
+}
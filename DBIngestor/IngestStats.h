@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>,
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file IngestStats.h
+ \brief Per stage timing of the ingest
+
+ Counters for the time spent in each stage of the ingest (reading, parsing, asserting,
+ converting, casting, binding, executing and freeing).
+ */
+
+#include <string>
+#ifndef _WIN32
+#include <stdint.h>
+#else
+#include "stdint_win.h"
+#endif
+
+#ifndef DBIngestor_IngestStats_h
+#define DBIngestor_IngestStats_h
+
+namespace DBIngest {
+
+#define STAGE_MAXSTAGE 8
+
+    enum IngestStage {
+        STAGE_READ_ROW = 0,
+        STAGE_PARSE = 1,
+        STAGE_ASSERT = 2,
+        STAGE_CONVERT = 3,
+        STAGE_CAST = 4,
+        STAGE_BIND = 5,
+        STAGE_EXECUTE = 6,
+        STAGE_FREE = 7
+    };
+
+    /*! \class IngestStats
+     \brief IngestStats class
+
+     Accumulates the time and the number of calls of each IngestStage. An IngestStats object is not thread
+     safe, every thread (parsing or committing) keeps its own and they are merged once the threads are done.
+     The time in STAGE_PARSE is the time spent in Reader::getItemInRow without the asserters and converters.
+     STAGE_EXECUTE is the time spent in DBAbstractor::executeStmtAsync. If the adaptor executes asynchronously
+     (see DBAbstractor::getExecutesAsync), this is sending the statement and waiting for the previous one, not
+     the round trip of the statement.
+
+     Taking a timestamp costs a few tens of nanoseconds, which is noticeable when done for every value. Timing is
+     therefore only done where an IngestStats object has been handed out (see DBIngestor::setStageTiming), code
+     paths without one only pay for a NULL check.
+     */
+	class IngestStats {
+
+	private:
+        /*! \var int64_t stageTime[STAGE_MAXSTAGE]
+         nanoseconds spent in each stage
+         */
+        int64_t stageTime[STAGE_MAXSTAGE];
+
+        /*! \var int64_t stageCalls[STAGE_MAXSTAGE]
+         number of timed calls of each stage
+         */
+        int64_t stageCalls[STAGE_MAXSTAGE];
+
+        /*! \var int nestingDepth
+         depth of nested conversions (converter parameters may have converters themselves), only the outermost is timed
+         */
+        int nestingDepth;
+
+	public:
+        IngestStats();
+
+        ~IngestStats();
+
+        /*! \brief returns a monotonic timestamp in nanoseconds
+         */
+        static int64_t getTimestamp();
+
+        /*! \brief returns the name of a stage
+         */
+        static std::string getStageName(IngestStage thisStage);
+
+        /*! \brief adds time to a stage
+         \param IngestStage thisStage: the stage
+         \param int64_t nanosec: time spent in the stage
+         \param int64_t numCalls: number of calls this time covers*/
+        void addTime(IngestStage thisStage, int64_t nanosec, int64_t numCalls = 1);
+
+        /*! \brief enters a (possibly nested) timed section
+         \return true, if this is the outermost section and should be timed
+
+         Every call needs to be matched by a call to leaveNested().*/
+        bool enterNested();
+
+        void leaveNested();
+
+        /*! \brief adds the counters of another IngestStats object to this one
+         */
+        void merge(IngestStats & otherStats);
+
+        /*! \brief sets all counters to zero
+         */
+        void reset();
+
+        int64_t getStageTime(IngestStage thisStage);
+
+        int64_t getStageCalls(IngestStage thisStage);
+
+        /*! \brief prints a table with the time spent in each stage
+         \param int64_t wallTime: wall clock time of the ingest in nanoseconds, used for the share of each stage
+
+         Times of stages running in several threads are summed up, so the shares may add up to more than 100%.*/
+        void printSummary(int64_t wallTime);
+	};
+}
+
+#endif
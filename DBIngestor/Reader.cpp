@@ -19,8 +19,12 @@
 
 #include "Reader.h"
 #include "dbingestor_error.h"
+#include "IngestStats.h"
+#include "StringArena.h"
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 using namespace DBReader;
 using namespace std;
@@ -28,6 +32,7 @@ using namespace std;
 Reader::Reader() {
     header = NULL;
     schema = NULL;
+    rowContext = NULL;
     readCount = 0;
 }
 
@@ -51,6 +56,19 @@ void Reader::skipHeader() {
     
 }
 
+bool Reader::getIsSplittable() {
+    return false;
+}
+
+Reader * Reader::getChunkReader() {
+    DBIngestor_error("Reader: This reader cannot be split into chunks.\n", NULL);
+    return NULL;
+}
+
+void Reader::setChunk(int chunkId, int numChunks) {
+    DBIngestor_error("Reader: This reader cannot be split into chunks.\n", NULL);
+}
+
 HeaderReader * Reader::getHeader() {
 	return header;
 }
@@ -69,11 +87,22 @@ void Reader::setSchema(DBDataSchema::Schema * newSchema) {
 }
 
 void Reader::checkAssertions(DBDataSchema::DataObjDesc * thisItem, void* result) {
+    assert(rowContext != NULL);
+    
     //checking this assertion only once per row, is it alreads evaluated?
-    if(thisItem->getAssertionEvaluated() == true) {
+    if(rowContext->getAssertionEvaluated(thisItem) == true) {
         return;
     }
 
+    DBIngest::IngestStats * stats = NULL;
+    int64_t startTime = 0;
+    if(thisItem->getNumAssertions() > 0) {
+        stats = rowContext->getIngestStats();
+    }
+    if(stats != NULL) {
+        startTime = DBIngest::IngestStats::getTimestamp();
+    }
+
     for(int i=0; i<thisItem->getNumAssertions(); i++) {
         DBAsserter::Asserter * currAsserter = thisItem->getAssertion(i);
         if(currAsserter->execute(thisItem->getDataObjDType(), result) == 0) {
@@ -84,19 +113,48 @@ void Reader::checkAssertions(DBDataSchema::DataObjDesc * thisItem, void* result)
         }
     }
 
-    thisItem->setAssertionEvaluated(true);
+    rowContext->setAssertionEvaluated(thisItem);
+
+    if(stats != NULL) {
+        stats->addTime(DBIngest::STAGE_ASSERT, DBIngest::IngestStats::getTimestamp() - startTime);
+    }
 }
 
 bool Reader::applyConversions(DBDataSchema::DataObjDesc * thisItem, void* result)  {
-    int err;
+    assert(rowContext != NULL);
+
+    DBIngest::IngestStats * stats = rowContext->getIngestStats();
+    if(stats == NULL || thisItem->getNumConverters() == 0) {
+        return evaluateConversions(thisItem, result);
+    }
+
+    //parameters of converters are read (and converted) within the conversion, only time the outermost one
+    bool isOutermost = stats->enterNested();
+    int64_t startTime = 0;
+    if(isOutermost == true) {
+        startTime = DBIngest::IngestStats::getTimestamp();
+    }
+
+    bool isNull = evaluateConversions(thisItem, result);
 
+    if(isOutermost == true) {
+        stats->addTime(DBIngest::STAGE_CONVERT, DBIngest::IngestStats::getTimestamp() - startTime);
+    }
+    stats->leaveNested();
+
+    return isNull;
+}
+
+bool Reader::evaluateConversions(DBDataSchema::DataObjDesc * thisItem, void* result)  {
+    int err;
+    
     //checking this assertion only once per row, is it alreads evaluated?
-    if(thisItem->getConversionEvaluated() == true) {
+    if(rowContext->getConversionEvaluated(thisItem) == true) {
         //set the result to the last converter in this data object, since this would be the
         //value that gets returned
         int i = thisItem->getNumConverters();
 
-        if(i == 0 || thisItem->getConversion(i - 1)->getResult(thisItem->getDataObjDType(), result) == 1) {
+        if(i == 0 || thisItem->getConversion(i - 1)->getResult(rowContext, thisItem->getDataObjDType(), result) == 1) {
             return false;
         }
     }
@@ -105,15 +163,13 @@ bool Reader::applyConversions(DBDataSchema::DataObjDesc * thisItem, void* result
         DBConverter::Converter * currConverter = thisItem->getConversion(i);
         
         //read values for variable converters
-        if(currConverter->getNumParameters() > 0) {
-            for(int j=0; j<currConverter->getNumParameters(); j++) {
-                //we donot need to apply asserters here... they have already been checked
-                getItemInRow(currConverter->getParameterDatObj(j), 0, 1, currConverter->getParameter(j));
-                currConverter->setParameter(j, currConverter->getParameter(j));
-            }
+        void ** functionValues = rowContext->getFunctionValues(currConverter);
+        for(int j=0; j<currConverter->getNumParameters(); j++) {
+            //we donot need to apply asserters here... they have already been checked
+            getItemInRow(currConverter->getParameterDatObj(j), 0, 1, functionValues[j]);
         }
         
-        err = currConverter->execute(thisItem->getDataObjDType(), result);
+        err = currConverter->execute(thisItem->getDataObjDType(), result, functionValues);
 
         if(err == 0) {
             printf("Error in Conversion\n");
@@ -128,14 +184,45 @@ bool Reader::applyConversions(DBDataSchema::DataObjDesc * thisItem, void* result
         }
 
         //save the result for easy retrieval later
-        currConverter->setResult(thisItem->getDataObjDType(), result);
+        currConverter->setResult(rowContext, thisItem->getDataObjDType(), result);
     }
 
-    thisItem->setConversionEvaluated(true);
+    rowContext->setConversionEvaluated(thisItem);
     
     return false;
 }
 
+char * Reader::allocString(size_t len) {
+    if(rowContext != NULL) {
+        return rowContext->getStringArena()->alloc(len + 1);
+    }
+    
+    char * newString = (char*)malloc(len + 1);
+    if(newString == NULL) {
+        DBIngestor_error("Reader: Not enough memory for allocating a string.\n", this);
+    }
+    
+    return newString;
+}
+
+char * Reader::copyString(const char * thisString, size_t len) {
+    assert(thisString != NULL);
+    
+    char * newString = allocString(len);
+    memcpy(newString, thisString, len);
+    newString[len] = '\0';
+    
+    return newString;
+}
+
 unsigned long long Reader::getReadCount() {
+    return readCount;
+}
+
+DBDataSchema::RowContext * Reader::getRowContext() {
+    return rowContext;
+}
 
+void Reader::setRowContext(DBDataSchema::RowContext * newRowContext) {
+    rowContext = newRowContext;
 }
\ No newline at end of file
@@ -30,6 +30,7 @@
 #include "DataObjDesc.h"
 #include "HeaderReader.h"
 #include "Schema.h"
+#include "RowContext.h"
 
 #ifndef DBIngestor_Reader_h
 #define DBIngestor_Reader_h
@@ -53,11 +54,38 @@ namespace DBReader {
          a pointer to the data schema that is connected to this reader
          */
 		DBDataSchema::Schema * schema;
+
+        /*! \var DBDataSchema::RowContext * rowContext
+         the row context used by checkAssertions and applyConversions. it is set up by the DBIngestor for
+         each thread reading data (i.e. each reader).
+         */
+        DBDataSchema::RowContext * rowContext;
+
+        /*! \brief applies the converters of an item, see applyConversions (which adds the timing)
+         */
+        bool evaluateConversions(DBDataSchema::DataObjDesc * thisItem, void* result);
         
     protected:
         void checkAssertions(DBDataSchema::DataObjDesc * thisItem, void* result);
         bool applyConversions(DBDataSchema::DataObjDesc * thisItem, void* result);
 
+        /*! \brief allocates a string that is handed out by getItemInRow
+         \param size_t len: length of the string, one more byte is allocated for the terminating \0
+         \return the (unterminated) memory
+         
+         Same as copyString, for readers that build the string in place.*/
+        char * allocString(size_t len);
+
+        /*! \brief copies a string that is handed out by getItemInRow
+         \param const char * thisString: the string, does not need to be terminated by \0
+         \param size_t len: length of the string
+         \return the \0 terminated copy
+         
+         The copy is taken from the string arena of the row context, so that it does not need to be freed and
+         costs no malloc. Without a row context, the copy is malloc'ed. Either way the DBIngestor releases it
+         through RowContext::releaseString once the value has been added to the buffer.*/
+        char * copyString(const char * thisString, size_t len);
+
         unsigned long long readCount;
 
 	public:
@@ -129,6 +157,36 @@ namespace DBReader {
          the pointer to the data*/
         virtual void getConstItem(DBDataSchema::DataObjDesc * thisItem, void* result) = 0;
 
+        /*! \brief tells whether this reader can be split into independent chunks
+         \param NONE
+         \return true if getChunkReader and setChunk are implemented
+         
+         Readers that can be split are parsed in parallel by the DBIngestor (see DBIngestor::setNumParseThreads).
+         The default implementation returns false.*/
+        virtual bool getIsSplittable();
+
+        /*! \brief creates a new reader with its own cursor on the same data
+         \param NONE
+         \return a new Reader object, which is owned (and deleted) by the caller
+         
+         The new reader needs to be completely independent of this one (own file handle, own read buffers), since
+         it will be used by a different thread. Only the cursor, the file handle and the read buffers need to be
+         independent. The rows it reads are parsed with the schema of this reader (its row plan and DataObjDesc
+         objects), which is shared read-only by all parsing threads, since the per row state lives in the RowContext
+         of each thread. The new reader may therefore simply point to the schema of this reader.*/
+        virtual DBReader::Reader * getChunkReader();
+
+        /*! \brief restricts the cursor to one chunk of the data
+         \param int chunkId: number of the chunk (from 0 to numChunks - 1)
+         \param int numChunks: total number of chunks the data is split into
+         \return NONE
+         
+         Positions the cursor at the first row of the given chunk. getNextRow will then only return the rows
+         of that chunk. How the data is split (byte ranges, record ranges) is up to the reader, but chunks need
+         to start and end at row boundaries, the header needs to be skipped and all chunks together need to cover
+         every row exactly once, with chunk i preceeding chunk i+1 in the input.*/
+        virtual void setChunk(int chunkId, int numChunks);
+
         DBReader::HeaderReader * getHeader();
 	
         void setHeader(DBReader::HeaderReader * newHeader);
@@ -138,6 +196,10 @@ namespace DBReader {
         void setSchema(DBDataSchema::Schema * newSchema);
 
         unsigned long long getReadCount();
+
+        DBDataSchema::RowContext * getRowContext();
+
+        void setRowContext(DBDataSchema::RowContext * newRowContext);
     };
 }
 
@@ -0,0 +1,174 @@
+/*  
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>, 
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "RowContext.h"
+#include "StringArena.h"
+#include "dbingestor_error.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <algorithm>
+
+using namespace DBDataSchema;
+using namespace std;
+
+RowContext::RowContext(Schema * newSchema) {
+    assert(newSchema != NULL);
+    
+    mySchema = newSchema;
+    ingestStats = NULL;
+    stringArena = new DBIngest::StringArena();
+    
+    if(mySchema->getIsCompiled() == false) {
+        mySchema->compile();
+    }
+    
+    //generation 0 is never used, so that all the flags start invalid
+    generation = 1;
+    conversionGeneration.resize(mySchema->getNumContextObjs(), 0);
+    assertionGeneration.resize(mySchema->getNumContextObjs(), 0);
+    
+    functionValues.resize(mySchema->getContextConverters().size());
+    converterResults.resize(mySchema->getContextConverters().size(), NULL);
+    resultGeneration.resize(mySchema->getContextConverters().size(), 0);
+    
+    for(int i=0; i<mySchema->getContextConverters().size(); i++) {
+        DBConverter::Converter * currConverter = mySchema->getContextConverters().at(i);
+        
+        converterResults.at(i) = malloc(sizeof(char)*CONV_RESULT_BUFFER_SIZE);
+        if(converterResults.at(i) == NULL) {
+            DBIngestor_error("RowContext: Allocation of converter result buffer failed!\n", NULL);
+        }
+        
+        for(int j=0; j<currConverter->getNumParameters(); j++) {
+            void * currValue = malloc(sizeof(char)*CONV_RESULT_BUFFER_SIZE);
+            if(currValue == NULL) {
+                DBIngestor_error("RowContext: Allocation of converter variable buffer failed!\n", NULL);
+            }
+            
+            functionValues.at(i).push_back(currValue);
+        }
+    }
+}
+
+RowContext::~RowContext() {
+    for(int i=0; i<functionValues.size(); i++) {
+        for(int j=0; j<functionValues.at(i).size(); j++) {
+            free(functionValues.at(i).at(j));
+        }
+    }
+    
+    for(int i=0; i<converterResults.size(); i++) {
+        if(converterResults.at(i) != NULL) {
+            free(converterResults.at(i));
+        }
+    }
+    
+    delete stringArena;
+}
+
+void RowContext::nextRow() {
+    generation++;
+    stringArena->reset();
+    
+    //on overflow, the old flags would become valid again... clear them
+    if(generation == 0) {
+        std::fill(conversionGeneration.begin(), conversionGeneration.end(), 0);
+        std::fill(assertionGeneration.begin(), assertionGeneration.end(), 0);
+        std::fill(resultGeneration.begin(), resultGeneration.end(), 0);
+        generation = 1;
+    }
+}
+
+bool RowContext::getConversionEvaluated(DataObjDesc * thisItem) {
+    assert(thisItem->getContextId() >= 0 && thisItem->getContextId() < conversionGeneration.size());
+    
+    return conversionGeneration[thisItem->getContextId()] == generation;
+}
+
+void RowContext::setConversionEvaluated(DataObjDesc * thisItem) {
+    assert(thisItem->getContextId() >= 0 && thisItem->getContextId() < conversionGeneration.size());
+    
+    conversionGeneration[thisItem->getContextId()] = generation;
+}
+
+bool RowContext::getAssertionEvaluated(DataObjDesc * thisItem) {
+    assert(thisItem->getContextId() >= 0 && thisItem->getContextId() < assertionGeneration.size());
+    
+    return assertionGeneration[thisItem->getContextId()] == generation;
+}
+
+void RowContext::setAssertionEvaluated(DataObjDesc * thisItem) {
+    assert(thisItem->getContextId() >= 0 && thisItem->getContextId() < assertionGeneration.size());
+    
+    assertionGeneration[thisItem->getContextId()] = generation;
+}
+
+void ** RowContext::getFunctionValues(DBConverter::Converter * thisConverter) {
+    assert(thisConverter->getContextId() >= 0 && thisConverter->getContextId() < functionValues.size());
+    
+    vector<void*> & currValues = functionValues[thisConverter->getContextId()];
+    
+    if(currValues.size() == 0) {
+        return NULL;
+    }
+    
+    return &currValues[0];
+}
+
+void * RowContext::getConverterResultBuffer(DBConverter::Converter * thisConverter) {
+    assert(thisConverter->getContextId() >= 0 && thisConverter->getContextId() < converterResults.size());
+    
+    return converterResults[thisConverter->getContextId()];
+}
+
+bool RowContext::getConverterResultSaved(DBConverter::Converter * thisConverter) {
+    assert(thisConverter->getContextId() >= 0 && thisConverter->getContextId() < resultGeneration.size());
+    
+    return resultGeneration[thisConverter->getContextId()] == generation;
+}
+
+void RowContext::setConverterResultSaved(DBConverter::Converter * thisConverter) {
+    assert(thisConverter->getContextId() >= 0 && thisConverter->getContextId() < resultGeneration.size());
+    
+    resultGeneration[thisConverter->getContextId()] = generation;
+}
+
+Schema * RowContext::getSchema() {
+    return mySchema;
+}
+
+DBIngest::StringArena * RowContext::getStringArena() {
+    return stringArena;
+}
+
+void RowContext::releaseString(char * thisString) {
+    if(thisString == NULL || stringArena->contains(thisString) == true) {
+        return;
+    }
+    
+    free(thisString);
+}
+
+DBIngest::IngestStats * RowContext::getIngestStats() {
+    return ingestStats;
+}
+
+void RowContext::setIngestStats(DBIngest::IngestStats * newIngestStats) {
+    ingestStats = newIngestStats;
+}
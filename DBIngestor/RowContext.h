@@ -0,0 +1,168 @@
+/*  
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>, 
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file RowContext.h
+ \brief Per thread row evaluation context
+ 
+ Holds everything that changes from row to row while reading data through
+ a (compiled) Schema, so that the Schema itself can be shared between threads.
+ */
+
+#include <vector>
+#ifndef _WIN32
+#include <stdint.h>
+#else
+#include "stdint_win.h"
+#endif
+#include "Schema.h"
+
+#ifndef DBIngestor_RowContext_h
+#define DBIngestor_RowContext_h
+
+namespace DBIngest {
+    class IngestStats;
+    class StringArena;
+}
+
+namespace DBDataSchema {
+    /*! \class RowContext
+     \brief RowContext class
+     
+     Keeps track of which assertions and conversions have already been evaluated in the current row, and holds
+     the scratch space converters need for their parameters and results. Every thread reading rows needs its own
+     RowContext, all of them can share the same compiled Schema.
+     
+     Whether an item has been evaluated is stored as the generation (i.e. row) in which this happened. Moving to the
+     next row only increments the generation, which invalidates all the flags at once.
+     
+     Readers can allocate the strings they hand out for the current row from the string arena of the context (see
+     Reader::copyString), which is reset when moving to the next row.
+     */
+	class RowContext {
+        
+	private:
+        /*! \var DBDataSchema::Schema * mySchema
+         the compiled schema this context belongs to
+         */
+        DBDataSchema::Schema * mySchema;
+
+        /*! \var uint32_t generation
+         number of the current row. flags are valid if they equal this number
+         */
+        uint32_t generation;
+
+        /*! \var std::vector<uint32_t> conversionGeneration
+         generation in which the conversions of a data object have last been evaluated (indexed by the context id)
+         */
+        std::vector<uint32_t> conversionGeneration;
+
+        /*! \var std::vector<uint32_t> assertionGeneration
+         generation in which the assertions of a data object have last been evaluated (indexed by the context id)
+         */
+        std::vector<uint32_t> assertionGeneration;
+
+        /*! \var std::vector<std::vector<void*> > functionValues
+         buffers holding the parameter values of each converter (indexed by the context id of the converter)
+         */
+        std::vector<std::vector<void*> > functionValues;
+
+        /*! \var std::vector<void*> converterResults
+         buffers of CONV_RESULT_BUFFER_SIZE bytes holding the results of the converters saved for the second evaluation in
+         a row (indexed by the context id of the converter)
+         */
+        std::vector<void*> converterResults;
+
+        /*! \var std::vector<uint32_t> resultGeneration
+         generation in which the result of a converter has last been saved (indexed by the context id of the converter)
+         */
+        std::vector<uint32_t> resultGeneration;
+
+        /*! \var DBIngest::IngestStats * ingestStats
+         if not NULL, the time spent in the asserters and converters is added to these counters
+         */
+        DBIngest::IngestStats * ingestStats;
+
+        /*! \var DBIngest::StringArena * stringArena
+         strings read in the current row. reset by nextRow()
+         */
+        DBIngest::StringArena * stringArena;
+
+	public:
+        /*! \brief constructor of a RowContext
+         \param DBDataSchema::Schema * newSchema: the schema the rows are read with
+         
+         Compiles the schema if this has not been done yet and allocates the scratch space for all the data
+         objects and converters in the schema.*/
+        RowContext(DBDataSchema::Schema * newSchema);
+        
+        ~RowContext();
+
+        /*! \brief moves the context to the next row
+         
+         Invalidates all evaluation flags in O(1) and releases the strings of the previous row.*/
+        void nextRow();
+
+        bool getConversionEvaluated(DBDataSchema::DataObjDesc * thisItem);
+        
+        void setConversionEvaluated(DBDataSchema::DataObjDesc * thisItem);
+
+        bool getAssertionEvaluated(DBDataSchema::DataObjDesc * thisItem);
+        
+        void setAssertionEvaluated(DBDataSchema::DataObjDesc * thisItem);
+
+        /*! \brief returns the parameter buffers of a converter
+         \param DBConverter::Converter * thisConverter: the converter
+         \return array of pointers to buffers of CONV_RESULT_BUFFER_SIZE bytes, one for each parameter
+         
+         The parameter values are read into these buffers before the converter is executed.*/
+        void ** getFunctionValues(DBConverter::Converter * thisConverter);
+
+        /*! \brief returns the buffer of CONV_RESULT_BUFFER_SIZE bytes the result of a converter is saved in
+         \param DBConverter::Converter * thisConverter: the converter
+         
+         The buffer is allocated with the context and reused for every row. Strings are saved as char* into the
+         string arena of the context.*/
+        void * getConverterResultBuffer(DBConverter::Converter * thisConverter);
+        
+        bool getConverterResultSaved(DBConverter::Converter * thisConverter);
+        
+        void setConverterResultSaved(DBConverter::Converter * thisConverter);
+
+        DBDataSchema::Schema * getSchema();
+
+        DBIngest::StringArena * getStringArena();
+
+        /*! \brief releases a string handed out by a reader for the current row
+         \param char * thisString: the string, may be NULL
+         
+         Strings that live in the string arena of this context are left alone (they go away with the row), all
+         others have been malloc'ed (by readers not using the arena, or by converters) and are freed.*/
+        void releaseString(char * thisString);
+
+        DBIngest::IngestStats * getIngestStats();
+
+        /*! \brief sets the counters the stages evaluated through this context are timed with
+         \param DBIngest::IngestStats * newIngestStats: counters owned by the thread using this context, or NULL to not time anything
+         */
+        void setIngestStats(DBIngest::IngestStats * newIngestStats);
+	};
+}
+
+#endif
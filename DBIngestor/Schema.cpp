@@ -18,6 +18,7 @@
  */
 
 #include "Schema.h"
+#include "dbingestor_error.h"
 #include <stdio.h>
 #include <assert.h>
 #include <iostream>
@@ -28,6 +29,10 @@ using namespace std;
 
 Schema::Schema() {
     numActiveItems = -1;
+    isCompiled = false;
+    numContextObjs = 0;
+    rowSizeInBytes = 0;
+    rowLayout = ROW_LAYOUT_ALIGNED;
 }
 
 Schema::~Schema() {
@@ -62,6 +67,10 @@ vector<SchemaItem*> & Schema::getArrSchemaItems() {
 }
 
 int32_t Schema::getNumActiveItems() {
+    if(isCompiled == true) {
+        return (int32_t)rowPlan.size();
+    }
+    
     if(numActiveItems < 0) {
         numActiveItems = 0;
         
@@ -76,10 +85,18 @@ int32_t Schema::getNumActiveItems() {
 }
 
 void Schema::addItemToSchema(SchemaItem * thisItem) {
+    if(isCompiled == true) {
+        DBIngestor_error("Schema: Items cannot be added to a compiled schema.\n", NULL);
+    }
+    
     arrSchemaItems.push_back(thisItem);
 }
 
 void Schema::sortSchema() {
+    if(isCompiled == true) {
+        DBIngestor_error("Schema: A compiled schema cannot be sorted.\n", NULL);
+    }
+    
     std::sort(arrSchemaItems.begin(), arrSchemaItems.end(), & compSchemaItem);
 }
 
@@ -87,8 +104,30 @@ bool DBDataSchema::compSchemaItem (SchemaItem * i, SchemaItem * j) {
     return (i->getDataDesc()->getOffsetId() < j->getDataDesc()->getOffsetId());
 }
 
+namespace {
+    //alignment of a value of byteLen bytes, i.e. the largest power of two dividing it, at most 8
+    int64_t getAlignment(int64_t byteLen) {
+        int64_t alignment = 1;
+        
+        while(alignment < 8 && byteLen % (alignment * 2) == 0) {
+            alignment *= 2;
+        }
+        
+        return alignment;
+    }
+    
+    int64_t alignUp(int64_t offset, int64_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+}
+
 int64_t Schema::getRowSizeInBytes() {
+    if(isCompiled == true) {
+        return rowSizeInBytes;
+    }
+    
     int64_t byteCount = 0;
+    int64_t maxAlignment = 1;
     
     for(int j=0; j<getArrSchemaItems().size(); j++) {
         if(getArrSchemaItems().at(j)->getColumnName().compare(EMPTY_SCHEMAITEM_NAME) == 0) {
@@ -97,16 +136,37 @@ int64_t Schema::getRowSizeInBytes() {
         
         DBDataSchema::SchemaItem * currObj = getArrSchemaItems().at(j);        
         
+        int64_t byteLen;
         if(currObj->getColumnDBType() == DBDataSchema::DBT_CHAR) {
-            byteCount += sizeof(char*);
+            byteLen = sizeof(char*);
         } else {
-            byteCount += DBDataSchema::getByteLenOfDBType(currObj->getColumnDBType());
+            byteLen = DBDataSchema::getByteLenOfDBType(currObj->getColumnDBType());
         }
+        
+        byteCount += byteLen;
+        maxAlignment = max(maxAlignment, getAlignment(byteLen));
+    }
+    
+    //ordered by size, the columns need no padding in between, only at the end of the row
+    if(rowLayout == ROW_LAYOUT_ALIGNED) {
+        byteCount = alignUp(byteCount, maxAlignment);
     }
     
     return byteCount;
 }
 
+RowLayout Schema::getRowLayout() {
+    return rowLayout;
+}
+
+void Schema::setRowLayout(RowLayout newRowLayout) {
+    if(isCompiled == true) {
+        DBIngestor_error("Schema: The row layout of a compiled schema cannot be changed.\n", NULL);
+    }
+    
+    rowLayout = newRowLayout;
+}
+
 void Schema::printSchema() {
     for(int j=0; j<getArrSchemaItems().size(); j++) {
         if(getArrSchemaItems().at(j)->getColumnName().compare(EMPTY_SCHEMAITEM_NAME) == 0) {
@@ -118,11 +178,150 @@ void Schema::printSchema() {
     }
 }
 
-void Schema::prepareSchemaForNextRow() {
+void Schema::compile() {
+    if(isCompiled == true) {
+        return;
+    }
+    
+    numContextObjs = 0;
+    contextConverters.clear();
+    
+    //data objects can be shared between items (e.g. as converter parameters), number them only once
+    set<DataObjDesc*> compiledObjs;
+    
+    for(int j=0; j<getArrSchemaItems().size(); j++) {
+        compileDataObjDesc(getArrSchemaItems().at(j)->getDataDesc(), compiledObjs);
+    }
+    
+    //build the plan of the active columns of a row, they are laid out below
+    rowPlan.clear();
+    rowSizeInBytes = 0;
+    
     for(int j=0; j<getArrSchemaItems().size(); j++) {
-        DBDataSchema::SchemaItem * currObj = getArrSchemaItems().at(j);
-        currObj->getDataDesc()->resetForNextRow();
+        SchemaItem * currItem = getArrSchemaItems().at(j);
+        
+        if(currItem->getColumnName().compare(EMPTY_SCHEMAITEM_NAME) == 0) {
+            continue;
+        }
+        
+        ColumnPlan currCol;
+        currCol.schemaItem = currItem;
+        currCol.dataDesc = currItem->getDataDesc();
+        currCol.dType = currCol.dataDesc->getDataObjDType();
+        currCol.dbType = currItem->getColumnDBType();
+        currCol.offset = 0;
+        currCol.byteLen = getByteLenOfDBType(currCol.dbType);
+        currCol.isNotNull = currItem->getIsNotNull();
+        currCol.isConstItem = currCol.dataDesc->getIsConstItem();
+        set<DataObjDesc*> visitedObjs;
+        currCol.isInvariant = isInvariantDataObj(currCol.dataDesc, visitedObjs);
+        currCol.ownsString = (currCol.dbType == DBT_CHAR) || (currCol.dbType == DBT_ANY && currCol.dType == DT_STRING);
+        currCol.castFunc = getCastFunc(currCol.dType, currCol.dbType);
+        currCol.castColumnFunc = getColumnCastFunc(currCol.dType, currCol.dbType);
+        
+        rowPlan.push_back(currCol);
     }
+    
+    if(rowLayout == ROW_LAYOUT_PACKED) {
+        //back to back, the way the buffers always did
+        for(int i=0; i<rowPlan.size(); i++) {
+            rowPlan[i].offset = rowSizeInBytes;
+            rowSizeInBytes += rowPlan[i].byteLen;
+        }
+    } else {
+        //widest alignment first, so that every value is aligned without padding in between
+        int64_t maxAlignment = 1;
+        for(int i=0; i<rowPlan.size(); i++) {
+            maxAlignment = max(maxAlignment, getAlignment(rowPlan[i].byteLen));
+        }
+        
+        for(int64_t currAlignment = maxAlignment; currAlignment >= 1; currAlignment /= 2) {
+            for(int i=0; i<rowPlan.size(); i++) {
+                if(getAlignment(rowPlan[i].byteLen) == currAlignment) {
+                    rowPlan[i].offset = alignUp(rowSizeInBytes, currAlignment);
+                    rowSizeInBytes = rowPlan[i].offset + rowPlan[i].byteLen;
+                }
+            }
+        }
+        
+        //the next row in a buffer starts aligned as well
+        rowSizeInBytes = alignUp(rowSizeInBytes, maxAlignment);
+    }
+    
+    isCompiled = true;
+}
+
+void Schema::compileDataObjDesc(DataObjDesc * thisItem, set<DataObjDesc*> & compiledObjs) {
+    assert(thisItem != NULL);
+    
+    if(compiledObjs.insert(thisItem).second == false) {
+        return;
+    }
+    
+    thisItem->setContextId(numContextObjs);
+    numContextObjs++;
+    
+    for(int i=0; i<thisItem->getNumConverters(); i++) {
+        DBConverter::Converter * currConverter = thisItem->getConversion(i);
+        
+        currConverter->setContextId(contextConverters.size());
+        contextConverters.push_back(currConverter);
+        
+        for(int j=0; j<currConverter->getNumParameters(); j++) {
+            compileDataObjDesc(currConverter->getParameterDatObj(j), compiledObjs);
+        }
+    }
+}
+
+bool Schema::isInvariantDataObj(DataObjDesc * thisItem, set<DataObjDesc*> & visitedObjs) {
+    assert(thisItem != NULL);
+    
+    //storage items are written back with every row, i.e. may change from row to row
+    if(thisItem->getIsStorageItem() == true) {
+        return false;
+    }
+    
+    if(thisItem->getIsConstItem() == false && thisItem->getIsHeaderItem() == false) {
+        return false;
+    }
+    
+    //a data object referring to itself is not constant either
+    if(visitedObjs.insert(thisItem).second == false) {
+        return false;
+    }
+    
+    for(int i=0; i<thisItem->getNumConverters(); i++) {
+        DBConverter::Converter * currConverter = thisItem->getConversion(i);
+        
+        for(int j=0; j<currConverter->getNumParameters(); j++) {
+            if(isInvariantDataObj(currConverter->getParameterDatObj(j), visitedObjs) == false) {
+                return false;
+            }
+        }
+    }
+    
+    visitedObjs.erase(thisItem);
+    
+    return true;
+}
+
+bool Schema::getIsCompiled() {
+    return isCompiled;
+}
+
+int32_t Schema::getNumContextObjs() {
+    return numContextObjs;
+}
+
+vector<DBConverter::Converter*> & Schema::getContextConverters() {
+    return contextConverters;
 }
 
 
+vector<ColumnPlan> & Schema::getRowPlan() {
+    if(isCompiled == false) {
+        compile();
+    }
+    
+    return rowPlan;
+}
@@ -25,6 +25,7 @@
 
 #include <string>
 #include <vector>
+#include <set>
 #include "SchemaItem.h"
 
 #ifndef DBIngestor_Schema_h
@@ -34,6 +35,85 @@ namespace DBDataSchema {
 
     bool compSchemaItem (SchemaItem * i, SchemaItem * j);
 
+    /*! \enum RowLayout
+     how the columns of a row are laid out in the buffers
+     */
+    enum RowLayout {
+        /*! columns back to back in schema order, values may be unaligned */
+        ROW_LAYOUT_PACKED = 0,
+        /*! columns ordered by size, so that every value is aligned to its size, and the row size padded
+         to a multiple of the largest alignment, so that this holds for all rows of a buffer */
+        ROW_LAYOUT_ALIGNED = 1
+    };
+
+    /*! \struct ColumnPlan
+     \brief everything needed to store one active column of a row, resolved once by Schema::compile()
+     */
+    typedef struct {
+        /*! \var SchemaItem * schemaItem
+         the schema item this column is read from
+         */
+        SchemaItem * schemaItem;
+
+        /*! \var DataObjDesc * dataDesc
+         the data object of the schema item
+         */
+        DataObjDesc * dataDesc;
+
+        /*! \var DType dType
+         the type the value is read in
+         */
+        DType dType;
+
+        /*! \var DBType dbType
+         the type the value is stored in on the database side
+         */
+        DBType dbType;
+
+        /*! \var int64_t offset
+         byte offset of the column in a buffer row (depends on the RowLayout of the Schema, i.e. is not necessarily
+         increasing with the column)
+         */
+        int64_t offset;
+
+        /*! \var int32_t byteLen
+         number of bytes the column takes in a buffer row
+         */
+        int32_t byteLen;
+
+        /*! \var bool isNotNull
+         true if the column cannot be NULL
+         */
+        bool isNotNull;
+
+        /*! \var bool isConstItem
+         true if the value is a constant in the schema (and is not read from the file)
+         */
+        bool isConstItem;
+
+        /*! \var bool isInvariant
+         true if the value is the same in every row of a file: the data object is a constant (but not a storage item) or
+         a header item, and so are all the parameters of its converters. such a column only needs to be read, converted
+         and cast once.
+         */
+        bool isInvariant;
+
+        /*! \var bool ownsString
+         true if the column holds a char* that has been allocated while casting and needs to be freed with the row
+         */
+        bool ownsString;
+
+        /*! \var DBTypeCastFunc castFunc
+         function casting dType into dbType
+         */
+        DBTypeCastFunc castFunc;
+
+        /*! \var DBTypeColumnCastFunc castColumnFunc
+         function casting a whole column of dType values into dbType
+         */
+        DBTypeColumnCastFunc castColumnFunc;
+    } ColumnPlan;
+
     /*! \class Schema
      \brief Schema class
      
@@ -62,6 +142,40 @@ namespace DBDataSchema {
          */
         int32_t numActiveItems;
 
+        /*! \var bool isCompiled
+         true once compile() has been called. A compiled schema cannot be changed anymore
+         */
+        bool isCompiled;
+
+        /*! \var int32_t numContextObjs
+         number of data objects (including converter parameters) that have been given a context id by compile()
+         */
+        int32_t numContextObjs;
+
+        /*! \var vector<DBConverter::Converter*> contextConverters
+         all the converters used by this schema, indexed by their context id
+         */
+        std::vector<DBConverter::Converter*> contextConverters;
+
+        /*! \var vector<ColumnPlan> rowPlan
+         the active columns in the order they are stored in a row, built by compile()
+         */
+        std::vector<ColumnPlan> rowPlan;
+
+        /*! \var int64_t rowSizeInBytes
+         size of a row as laid out in rowPlan
+         */
+        int64_t rowSizeInBytes;
+
+        /*! \var RowLayout rowLayout
+         how compile() lays out the columns of a row
+         */
+        RowLayout rowLayout;
+
+        void compileDataObjDesc(DataObjDesc * thisItem, std::set<DataObjDesc*> & compiledObjs);
+
+        bool isInvariantDataObj(DataObjDesc * thisItem, std::set<DataObjDesc*> & visitedObjs);
+
 	public:
         Schema();
         
@@ -84,10 +198,37 @@ namespace DBDataSchema {
         void sortSchema();
         
         int64_t getRowSizeInBytes();
+
+        RowLayout getRowLayout();
+
+        /*! \brief sets how the columns of a row are laid out
+         \param RowLayout newRowLayout: the layout, ROW_LAYOUT_ALIGNED by default
+         
+         Needs to be set before the schema is compiled.*/
+        void setRowLayout(RowLayout newRowLayout);
         
         void printSchema();
 
-        void prepareSchemaForNextRow();
+        /*! \brief compiles the schema for reading rows
+         
+         Numbers all the data objects and converters reachable from the schema items (including the data
+         objects converters take as parameters), so that a RowContext can hold their per row state in flat
+         arrays, and builds the row plan of the active columns. After compiling, the schema is not altered
+         while reading and can be shared between threads. Items cannot be added anymore.*/
+        void compile();
+
+        bool getIsCompiled();
+
+        int32_t getNumContextObjs();
+
+        std::vector<DBConverter::Converter*> & getContextConverters();
+
+        /*! \brief returns the row plan, i.e. one ColumnPlan for each active item in schema order
+         
+         Compiles the schema if this has not been done yet. The row plan is what the buffers and the database
+         adaptors use to walk through a row, instead of going through the schema items and their types again
+         for every row.*/
+        std::vector<ColumnPlan> & getRowPlan();
 	};
 }
 
@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>,
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "StmtSizeTuner.h"
+#include <assert.h>
+#include <algorithm>
+
+using namespace DBIngest;
+using namespace std;
+
+StmtSizeTuner::StmtSizeTuner() {
+    maxLatency = 0;
+
+    setMaxRows(1);
+}
+
+StmtSizeTuner::~StmtSizeTuner() {
+
+}
+
+void StmtSizeTuner::setMaxRows(int maxRows) {
+    assert(maxRows > 0);
+
+    sizes.clear();
+
+    int currSize = maxRows;
+    while(currSize > 1) {
+        sizes.push_back(currSize);
+
+        int nextSize = (int)((int64_t)currSize * 3 / 4);
+        if(nextSize == currSize) {
+            nextSize--;
+        }
+        currSize = nextSize;
+    }
+    sizes.push_back(1);
+
+    reverse(sizes.begin(), sizes.end());
+
+    //start with the largest statements, which is what is used without tuning
+    currLevel = (int)sizes.size() - 1;
+    direction = -1;
+    step = 4;
+
+    windowStmts = 0;
+    windowRows = 0;
+    windowTime = 0;
+    lastRate = 0.0;
+    lastLatency = 0;
+}
+
+void StmtSizeTuner::addStmt(int64_t nanosec) {
+    windowStmts++;
+    windowRows += sizes[currLevel];
+    windowTime += nanosec;
+
+    if(windowStmts < DBING_TUNER_WINDOW) {
+        return;
+    }
+
+    if(windowTime <= 0) {
+        windowTime = 1;
+    }
+
+    double rate = (double)windowRows * 1.0e9 / (double)windowTime;
+    int64_t latency = windowTime / windowStmts;
+
+    if(maxLatency > 0 && latency > maxLatency) {
+        //statements take too long, shrink them no matter what the throughput says
+        direction = -1;
+    } else if(lastRate > 0.0 && rate < lastRate) {
+        //the last move made things worse, go back with smaller steps
+        direction = -direction;
+        if(step > 1) {
+            step /= 2;
+        }
+    }
+
+    lastRate = rate;
+    lastLatency = latency;
+
+    int nextLevel = currLevel + direction * step;
+    nextLevel = max(0, min(nextLevel, (int)sizes.size() - 1));
+
+    //at either end of the ladder, probe the other direction next
+    if(nextLevel == currLevel) {
+        direction = -direction;
+    }
+
+    currLevel = nextLevel;
+
+    windowStmts = 0;
+    windowRows = 0;
+    windowTime = 0;
+}
+
+double StmtSizeTuner::getLastRate() {
+    return lastRate;
+}
+
+int64_t StmtSizeTuner::getLastLatency() {
+    return lastLatency;
+}
+
+int64_t StmtSizeTuner::getMaxLatency() {
+    return maxLatency;
+}
+
+void StmtSizeTuner::setMaxLatency(int64_t newMaxLatency) {
+    assert(newMaxLatency >= 0);
+
+    maxLatency = newMaxLatency;
+}
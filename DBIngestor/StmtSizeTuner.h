@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>,
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file StmtSizeTuner.h
+ \brief Adaptive number of rows per statement
+
+ Picks the number of rows bound to each multi row statement from the measured
+ throughput of the statements executed so far.
+ */
+
+#include <vector>
+#ifndef _WIN32
+#include <stdint.h>
+#else
+#include "stdint_win.h"
+#endif
+
+#ifndef DBIngestor_StmtSizeTuner_h
+#define DBIngestor_StmtSizeTuner_h
+
+namespace DBIngest {
+
+//number of statements measured before the size is changed
+#define DBING_TUNER_WINDOW 8
+
+    /*! \class StmtSizeTuner
+     \brief StmtSizeTuner class
+
+     Hill climbing on the number of rows per statement. The possible sizes form a ladder from the largest size
+     the adaptor allows down to a single row, each step about 3/4 of the one above, so that only a few different
+     statements ever need to be prepared. The tuner starts at the top of the ladder. After every DBING_TUNER_WINDOW
+     statements it compares the rows per second with those of the previous window: if the throughput went up it
+     keeps moving in the same direction, otherwise it turns around and halves its step. Once the step is down to one
+     rung, the tuner keeps probing the neighbouring sizes, which lets it follow changes in server load.
+
+     If a maximum latency is set, the size is reduced whenever the statements of a window took longer than that
+     on average, regardless of the throughput. A StmtSizeTuner is not thread safe, every commit buffer keeps its own.
+     */
+	class StmtSizeTuner {
+
+	private:
+        /*! \var std::vector<int> sizes
+         the ladder of sizes, in ascending order
+         */
+        std::vector<int> sizes;
+
+        /*! \var int currLevel
+         index of the current size in sizes
+         */
+        int currLevel;
+
+        /*! \var int step
+         number of rungs the next move covers
+         */
+        int step;
+
+        /*! \var int direction
+         +1 if moving to larger statements, -1 if moving to smaller ones
+         */
+        int direction;
+
+        /*! \var int windowStmts
+         number of statements measured in the current window
+         */
+        int windowStmts;
+
+        /*! \var int64_t windowRows
+         number of rows of the statements measured in the current window
+         */
+        int64_t windowRows;
+
+        /*! \var int64_t windowTime
+         nanoseconds spent binding and executing the statements of the current window
+         */
+        int64_t windowTime;
+
+        /*! \var double lastRate
+         rows per second of the previous window, 0 if there was none
+         */
+        double lastRate;
+
+        /*! \var int64_t lastLatency
+         average nanoseconds per statement of the previous window
+         */
+        int64_t lastLatency;
+
+        /*! \var int64_t maxLatency
+         if larger than 0, the maximum average nanoseconds a statement may take
+         */
+        int64_t maxLatency;
+
+	public:
+        StmtSizeTuner();
+
+        ~StmtSizeTuner();
+
+        /*! \brief sets the largest number of rows a statement may have and restarts the tuning
+         \param int maxRows: the hard limit, i.e. the buffer size or the limit of the adaptor, whichever is smaller
+         */
+        void setMaxRows(int maxRows);
+
+        /*! \brief returns the number of rows the next statement should have
+         */
+        inline int getStmtRows() {
+            return sizes[currLevel];
+        }
+
+        /*! \brief records an executed statement of getStmtRows() rows
+         \param int64_t nanosec: time spent binding and executing the statement
+
+         Statements of other sizes (i.e. the remainder of a buffer) must not be recorded.*/
+        void addStmt(int64_t nanosec);
+
+        /*! \brief returns the rows per second measured in the last window, 0 if none was completed yet
+         */
+        double getLastRate();
+
+        /*! \brief returns the average nanoseconds per statement measured in the last window
+         */
+        int64_t getLastLatency();
+
+        int64_t getMaxLatency();
+
+        /*! \brief sets the maximum average time a statement may take
+         \param int64_t newMaxLatency: nanoseconds, 0 for no limit
+         */
+        void setMaxLatency(int64_t newMaxLatency);
+	};
+}
+
+#endif
@@ -0,0 +1,119 @@
+/*
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>,
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "StringArena.h"
+#include "dbingestor_error.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace DBIngest;
+using namespace std;
+
+StringArena::StringArena(size_t newBlockSize) {
+    assert(newBlockSize > 0);
+
+    blockSize = newBlockSize;
+    currBlock = -1;
+    currPos = NULL;
+    currEnd = NULL;
+}
+
+StringArena::~StringArena() {
+    for(int i=0; i<blocks.size(); i++) {
+        free(blocks.at(i));
+    }
+}
+
+char * StringArena::allocSlow(size_t len) {
+    //use the next block that is large enough. blocks that are too small are skipped for now and reused after the next reset
+    int nextBlock = currBlock + 1;
+    while(nextBlock < blocks.size() && blockSizes.at(nextBlock) < len) {
+        nextBlock++;
+    }
+
+    if(nextBlock == blocks.size()) {
+        size_t newSize = blockSize;
+        if(len > newSize) {
+            newSize = len;
+        }
+
+        char * newBlock = (char*)malloc(newSize);
+        if(newBlock == NULL) {
+            DBIngestor_error("StringArena: Not enough memory for allocating a new block.\n", NULL);
+        }
+
+        blocks.push_back(newBlock);
+        blockSizes.push_back(newSize);
+    } else if(nextBlock != currBlock + 1) {
+        //keep the blocks in use at the front, so that contains() only needs to look at those
+        swap(blocks.at(nextBlock), blocks.at(currBlock + 1));
+        swap(blockSizes.at(nextBlock), blockSizes.at(currBlock + 1));
+    }
+
+    currBlock++;
+    currPos = blocks.at(currBlock) + len;
+    currEnd = blocks.at(currBlock) + blockSizes.at(currBlock);
+
+    return blocks.at(currBlock);
+}
+
+char * StringArena::copyString(const char * thisString, size_t len) {
+    assert(thisString != NULL);
+
+    //the length is kept in front of the string, unaligned
+    char * newString = alloc(sizeof(size_t) + len + 1) + sizeof(size_t);
+    memcpy(newString - sizeof(size_t), &len, sizeof(size_t));
+    memcpy(newString, thisString, len);
+    newString[len] = '\0';
+
+    return newString;
+}
+
+void StringArena::reset() {
+    if(blocks.size() == 0) {
+        return;
+    }
+
+    currBlock = 0;
+    currPos = blocks.at(0);
+    currEnd = blocks.at(0) + blockSizes.at(0);
+}
+
+bool StringArena::contains(const void * thisPtr) {
+    const char * ptr = (const char*)thisPtr;
+
+    for(int i=0; i<=currBlock; i++) {
+        if(ptr >= blocks[i] && ptr < blocks[i] + blockSizes[i]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t StringArena::getCapacity() {
+    size_t capacity = 0;
+
+    for(int i=0; i<blockSizes.size(); i++) {
+        capacity += blockSizes.at(i);
+    }
+
+    return capacity;
+}
@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>,
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file StringArena.h
+ \brief Bump pointer allocator for strings
+
+ Strings that live as long as a row or a buffer are allocated from an arena, which
+ is reset as a whole instead of freeing every string on its own.
+ */
+
+#include <vector>
+#include <stddef.h>
+#include <string.h>
+
+#ifndef DBIngestor_StringArena_h
+#define DBIngestor_StringArena_h
+
+namespace DBIngest {
+
+//default size of the blocks the arena allocates from
+#define DBING_STRING_ARENA_BLOCK_SIZE 65536
+
+    /*! \class StringArena
+     \brief StringArena class
+
+     Hands out memory from a list of blocks by bumping a pointer. Blocks are never moved, so the pointers
+     stay valid until reset() is called. reset() keeps the blocks for reuse, so that an arena that is reset
+     regularly (e.g. once per buffer) stops allocating after the first round. Requests larger than the block
+     size get a block of their own. A StringArena is not thread safe.
+     */
+	class StringArena {
+
+	private:
+        /*! \var std::vector<char*> blocks
+         the memory blocks of the arena
+         */
+        std::vector<char*> blocks;
+
+        /*! \var std::vector<size_t> blockSizes
+         size of each block in bytes
+         */
+        std::vector<size_t> blockSizes;
+
+        /*! \var size_t blockSize
+         size of newly allocated blocks
+         */
+        size_t blockSize;
+
+        /*! \var int currBlock
+         index of the block currently allocated from, -1 if there is none
+         */
+        int currBlock;
+
+        /*! \var char * currPos
+         the next free byte in the current block
+         */
+        char * currPos;
+
+        /*! \var char * currEnd
+         the end of the current block
+         */
+        char * currEnd;
+
+        /*! \brief moves on to the next block that can hold len bytes, allocating one if needed
+         */
+        char * allocSlow(size_t len);
+
+	public:
+        /*! \brief constructor of a StringArena
+         \param size_t newBlockSize: size of the blocks allocated by the arena
+
+         No memory is allocated until the first string is requested.*/
+        StringArena(size_t newBlockSize = DBING_STRING_ARENA_BLOCK_SIZE);
+
+        ~StringArena();
+
+        /*! \brief allocates len bytes
+         \param size_t len: number of bytes
+         \return pointer to the memory, valid until reset() is called
+
+         The memory is not aligned, it is meant for characters.*/
+        inline char * alloc(size_t len) {
+            if((size_t)(currEnd - currPos) < len) {
+                return allocSlow(len);
+            }
+
+            char * newMem = currPos;
+            currPos += len;
+
+            return newMem;
+        }
+
+        /*! \brief copies a string into the arena
+         \param const char * thisString: the string, does not need to be terminated by \0
+         \param size_t len: length of the string
+         \return the \0 terminated copy, valid until reset() is called
+
+         The length is stored in front of the copy, where getStringLength finds it.*/
+        char * copyString(const char * thisString, size_t len);
+
+        /*! \brief returns the length of a string copied into an arena
+         \param const char * arenaString: a string returned by copyString (of any arena)
+         \return the length given to copyString
+
+         Saves the strlen for strings that are known to come from copyString. Must not be used with memory
+         from alloc().*/
+        static inline size_t getStringLength(const char * arenaString) {
+            size_t len;
+            memcpy(&len, arenaString - sizeof(size_t), sizeof(size_t));
+
+            return len;
+        }
+
+        /*! \brief releases all strings at once
+
+         Keeps the blocks for the strings that follow.*/
+        void reset();
+
+        /*! \brief checks whether a pointer points into the arena
+         \param const void * thisPtr: the pointer
+         \return true, if the memory belongs to one of the blocks that are in use
+         */
+        bool contains(const void * thisPtr);
+
+        /*! \brief returns the number of bytes in all blocks of the arena
+         */
+        size_t getCapacity();
+	};
+}
+
+#endif
@@ -0,0 +1,355 @@
+/*
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>,
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "BenchReader.h"
+#include "SchemaItem.h"
+#include "DataObjDesc.h"
+#include "ConverterFactory.h"
+#include "dbingestor_error.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+#include <boost/thread.hpp>
+
+using namespace DBBench;
+using namespace std;
+
+namespace {
+    //splitmix64 finalizer, good enough to make neighbouring rows look random
+    inline uint64_t mix64(uint64_t value) {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    inline uint64_t hashCell(uint64_t seed, int64_t row, int column) {
+        return mix64(seed ^ mix64((uint64_t)row * 0x100000001B3ULL + (uint64_t)column));
+    }
+
+    DBDataSchema::DBType convDBTypeName(string thisDBType) {
+        boost::to_upper(thisDBType);
+
+        if(thisDBType.compare(0, 4, "DBT_") != 0) {
+            thisDBType = "DBT_" + thisDBType;
+        }
+
+        for(int i=1; i<=DBT_MAXTYPE; i++) {
+            if(DBDataSchema::strDBType((DBDataSchema::DBType)i) == thisDBType) {
+                return (DBDataSchema::DBType)i;
+            }
+        }
+
+        printf("Unknown DBType: %s\n", thisDBType.c_str());
+        DBIngestor_error("BenchReader: Unknown DBType in the type mix.\n", NULL);
+        return DBDataSchema::DBT_ANY;
+    }
+}
+
+void DBBench::parseTypeMix(string typeList, BenchConfig & config) {
+    vector<string> types;
+    boost::split(types, typeList, boost::is_any_of(","));
+
+    config.typeMix.clear();
+    config.dbTypeMix.clear();
+
+    for(int i=0; i<types.size(); i++) {
+        string currType = boost::trim_copy(types.at(i));
+        string currDBType = "";
+
+        size_t colon = currType.find(':');
+        if(colon != string::npos) {
+            currDBType = currType.substr(colon + 1);
+            currType = currType.substr(0, colon);
+        }
+
+        if(DBDataSchema::testDType(currType) == 0) {
+            printf("Unknown DType: %s\n", currType.c_str());
+            DBIngestor_error("BenchReader: Unknown DType in the type mix.\n", NULL);
+        }
+
+        DBDataSchema::DType thisDType = DBDataSchema::convDType(currType);
+        config.typeMix.push_back(thisDType);
+
+        if(currDBType.length() == 0) {
+            config.dbTypeMix.push_back(DBDataSchema::convDTypeToDBType(thisDType));
+        } else {
+            config.dbTypeMix.push_back(convDBTypeName(currDBType));
+        }
+    }
+
+    if(config.typeMix.size() == 0) {
+        DBIngestor_error("BenchReader: The type mix is empty.\n", NULL);
+    }
+}
+
+DBDataSchema::Schema * DBBench::buildBenchSchema(BenchConfig & config, vector<DBDataSchema::DataObjDesc*> & paramObjs) {
+    assert(config.numColumns > 0);
+    assert(config.typeMix.size() > 0);
+    assert(config.typeMix.size() == config.dbTypeMix.size());
+
+    DBDataSchema::Schema * newSchema = new DBDataSchema::Schema();
+    newSchema->setDbName("bench");
+    newSchema->setTableName("synthetic");
+
+    DBConverter::ConverterFactory convFac;
+
+    for(int i=0; i<config.numColumns; i++) {
+        DBDataSchema::DType thisDType = config.typeMix.at(i % config.typeMix.size());
+        DBDataSchema::DBType thisDBType = config.dbTypeMix.at(i % config.dbTypeMix.size());
+        string colName = boost::str(boost::format("col%i") % i);
+
+        DBDataSchema::DataObjDesc * dataDesc = new DBDataSchema::DataObjDesc();
+        dataDesc->setOffsetId(i);
+        dataDesc->setDataObjName(colName);
+        dataDesc->setDataObjDType(thisDType);
+        dataDesc->setIsHeaderItem(false);
+
+        if(i >= config.numColumns - config.numConstColumns) {
+            void * constValue = malloc(DBDataSchema::getByteLenOfDType(thisDType));
+            if(thisDType == DBDataSchema::DT_STRING) {
+                //the string is never freed (the data object only frees the pointer to it)
+                const char * constString = "constant";
+                memcpy(constValue, &constString, sizeof(char*));
+            } else {
+                DBDataSchema::castStringToDType("7", 1, thisDType, constValue);
+            }
+
+            dataDesc->setIsConstItem(true, false);
+            dataDesc->setConstData(constValue);
+        } else {
+            dataDesc->setIsConstItem(false, false);
+        }
+
+        //the converters take the constant 1 of the column's type as parameter
+        if(thisDType != DBDataSchema::DT_STRING) {
+            for(int j=0; j<config.converterChainLength; j++) {
+                DBDataSchema::DataObjDesc * paramDesc = new DBDataSchema::DataObjDesc();
+                void * one = malloc(DBDataSchema::getByteLenOfDType(thisDType));
+                DBDataSchema::castStringToDType("1", 1, thisDType, one);
+
+                paramDesc->setOffsetId(0);
+                paramDesc->setDataObjName(colName + "_param");
+                paramDesc->setDataObjDType(thisDType);
+                paramDesc->setIsConstItem(true, false);
+                paramDesc->setIsHeaderItem(false);
+                paramDesc->setConstData(one);
+                paramObjs.push_back(paramDesc);
+
+                DBConverter::Converter * conv = convFac.getConverter(j % 2 == 0 ? "CONV_MULTIPLY" : "CONV_ADD");
+                conv->registerParameter(0, paramDesc);
+                dataDesc->addConverter(conv);
+            }
+        }
+
+        DBDataSchema::SchemaItem * newItem = new DBDataSchema::SchemaItem();
+        newItem->setColumnName(colName);
+        newItem->setColumnDBType(thisDBType);
+        newItem->setDataDesc(dataDesc);
+        newItem->setIsNotNull(false);
+
+        newSchema->addItemToSchema(newItem);
+    }
+
+    return newSchema;
+}
+
+BenchReader::BenchReader(BenchConfig & newConfig) {
+    assert(newConfig.numRows >= 0);
+    assert(newConfig.minStringLength >= 0);
+    assert(newConfig.maxStringLength >= newConfig.minStringLength);
+    assert(newConfig.nullRatio >= 0.0 && newConfig.nullRatio <= 1.0);
+
+    config = newConfig;
+    nullThreshold = (uint64_t)(config.nullRatio * 4294967296.0);
+
+    currRow = 0;
+    endRow = config.numRows;
+}
+
+BenchReader::~BenchReader() {
+
+}
+
+void BenchReader::rewind() {
+    currRow = 0;
+    endRow = config.numRows;
+}
+
+int BenchReader::getNextRow() {
+    if(currRow >= endRow) {
+        return 0;
+    }
+
+    currRow++;
+    readCount++;
+
+    if(config.burstRows > 0 && config.burstPause > 0 && readCount % config.burstRows == 0) {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(config.burstPause));
+    }
+
+    return 1;
+}
+
+bool BenchReader::getItemInRow(DBDataSchema::DataObjDesc * thisItem, bool applyAsserters, bool applyConverters, void* result) {
+    assert(thisItem != NULL);
+    assert(result != NULL);
+
+    if(thisItem->getIsConstItem() == true) {
+        getConstItem(thisItem, result);
+
+        if(applyAsserters == true) {
+            checkAssertions(thisItem, result);
+        }
+
+        if(applyConverters == true) {
+            return applyConversions(thisItem, result);
+        }
+
+        return false;
+    }
+
+    uint64_t hash = hashCell(config.seed, currRow - 1, thisItem->getOffsetId());
+
+    if((hash >> 32) < nullThreshold) {
+        //the ingestor releases strings, even if they are NULL
+        if(thisItem->getDataObjDType() == DBDataSchema::DT_STRING) {
+            *(char**)result = NULL;
+        }
+
+        return true;
+    }
+
+    switch (thisItem->getDataObjDType()) {
+        case DBDataSchema::DT_STRING: {
+            int len = config.minStringLength + (int)(hash % (uint64_t)(config.maxStringLength - config.minStringLength + 1));
+            char * newString = allocString(len);
+            uint64_t state = hash;
+            for(int i=0; i<len; i++) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                newString[i] = 'a' + (char)((state >> 33) % 26);
+            }
+            newString[len] = '\0';
+            *(char**)result = newString;
+            break;
+        }
+        case DBDataSchema::DT_INT1:
+            *(int8_t*)result = (int8_t)((int64_t)(hash % 101) - 50);
+            break;
+        case DBDataSchema::DT_INT2:
+            *(int16_t*)result = (int16_t)((int64_t)(hash % 20001) - 10000);
+            break;
+        case DBDataSchema::DT_INT4:
+            *(int32_t*)result = (int32_t)((int64_t)(hash % 2000000001) - 1000000000);
+            break;
+        case DBDataSchema::DT_INT8:
+            *(int64_t*)result = (int64_t)(hash >> 2) - ((int64_t)1 << 61);
+            break;
+        case DBDataSchema::DT_UINT1:
+            *(uint8_t*)result = (uint8_t)(hash % 101);
+            break;
+        case DBDataSchema::DT_UINT2:
+            *(uint16_t*)result = (uint16_t)(hash % 20001);
+            break;
+        case DBDataSchema::DT_UINT4:
+            *(uint32_t*)result = (uint32_t)(hash % 2000000001);
+            break;
+        case DBDataSchema::DT_UINT8:
+            *(uint64_t*)result = hash >> 2;
+            break;
+        case DBDataSchema::DT_REAL4:
+            *(float*)result = (float)((double)(hash % 2000000) / 1000.0 - 1000.0);
+            break;
+        case DBDataSchema::DT_REAL8:
+            *(double*)result = (double)(hash % 2000000000000ULL) / 1.0e6 - 1.0e6;
+            break;
+        default:
+            DBIngestor_error("BenchReader: Unknown DType.\n", this);
+            break;
+    }
+
+    if(applyAsserters == true) {
+        checkAssertions(thisItem, result);
+    }
+
+    if(applyConverters == true) {
+        return applyConversions(thisItem, result);
+    }
+
+    return false;
+}
+
+void BenchReader::getConstItem(DBDataSchema::DataObjDesc * thisItem, void* result) {
+    assert(thisItem != NULL);
+    assert(thisItem->getConstData() != NULL);
+
+    memcpy(result, thisItem->getConstData(), DBDataSchema::getByteLenOfDType(thisItem->getDataObjDType()));
+}
+
+bool BenchReader::getIsSplittable() {
+    return true;
+}
+
+DBReader::Reader * BenchReader::getChunkReader() {
+    BenchReader * chunkReader = new BenchReader(config);
+    chunkReader->setSchema(getSchema());
+
+    return chunkReader;
+}
+
+void BenchReader::setChunk(int chunkId, int numChunks) {
+    assert(numChunks > 0);
+    assert(chunkId >= 0 && chunkId < numChunks);
+
+    currRow = config.numRows * chunkId / numChunks;
+    endRow = config.numRows * (chunkId + 1) / numChunks;
+}
+
+uint64_t DBBench::checksumValue(int column, DBDataSchema::DBType thisDBType, void* value, bool isNull, int64_t * numBytes) {
+    assert(numBytes != NULL);
+
+    uint64_t columnKey = (uint64_t)(column + 1) * 0x9E3779B97F4A7C15ULL;
+
+    if(isNull == true) {
+        return mix64(columnKey ^ 0x6E756C6CULL);
+    }
+
+    unsigned char * bytes;
+    size_t len;
+
+    if(thisDBType == DBDataSchema::DBT_CHAR) {
+        bytes = *(unsigned char**)value;
+        len = strlen(*(char**)value);
+    } else {
+        bytes = (unsigned char*)value;
+        len = DBDataSchema::getByteLenOfDBType(thisDBType);
+    }
+
+    //FNV-1a over the bytes as they are handed to the server
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for(size_t i=0; i<len; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+    }
+
+    *numBytes += len;
+
+    return mix64(columnKey ^ hash);
+}
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>,
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file BenchReader.h
+ \brief Synthetic data reader for the benchmarks
+
+ A Reader that generates its rows on the fly, so that the throughput of the ingest
+ machinery can be measured without any file I/O or text parsing.
+ */
+
+#include <vector>
+#include <string>
+#include "Reader.h"
+#include "Schema.h"
+#include "DType.h"
+#include "DBType.h"
+
+#ifndef DBIngestor_BenchReader_h
+#define DBIngestor_BenchReader_h
+
+namespace DBBench {
+
+    /*! \struct BenchConfig
+     \brief shape of the synthetic data
+
+     Columns are assigned the types in typeMix round robin. String lengths are drawn uniformly from
+     [minStringLength, maxStringLength]. Every numeric column is passed through converterChainLength
+     converters (alternating CONV_MULTIPLY by 1 and CONV_ADD of 1 with constant parameters), so that the
+     cost of the converter machinery shows up without the values running out of range. The last numConstColumns
+     columns are constants in the schema (7, or "constant" for strings), like header values repeated in every row,
+     and are passed through the converters as well. If burstRows is larger than
+     0, the reader pauses for burstPause milliseconds after every burstRows rows, like a source that delivers its
+     data in snapshots.
+     */
+    typedef struct BenchConfig {
+        int64_t numRows;
+        int numColumns;
+        std::vector<DBDataSchema::DType> typeMix;
+        std::vector<DBDataSchema::DBType> dbTypeMix;
+        int minStringLength;
+        int maxStringLength;
+        double nullRatio;
+        int converterChainLength;
+        int numConstColumns;
+        uint64_t seed;
+        int64_t burstRows;
+        int burstPause;
+    } BenchConfig;
+
+    /*! \brief builds the schema of the synthetic table
+     \param BenchConfig & config: the shape of the data
+     \param std::vector<DBDataSchema::DataObjDesc*> & paramObjs: receives the constant converter parameters, which
+     are not owned by the schema and need to be deleted by the caller after the schema
+     \return the schema, column i is read from offset i of the BenchReader
+     */
+    DBDataSchema::Schema * buildBenchSchema(BenchConfig & config, std::vector<DBDataSchema::DataObjDesc*> & paramObjs);
+
+    /*! \brief parses a type mix like "INT4,REAL8,CHAR:DBT_ANY" into config.typeMix and config.dbTypeMix
+     \param std::string typeList: comma separated DTypes, each optionally followed by ':' and the DBType to store it as
+     \param BenchConfig & config: the config to fill
+
+     Without a DBType, the column is stored as the DBType matching its DType (see convDTypeToDBType).*/
+    void parseTypeMix(std::string typeList, BenchConfig & config);
+
+    /*! \class BenchReader
+     \brief Reader generating synthetic rows
+
+     Every value is derived from the row number, the column and the seed only. The reader can therefore be
+     split into any number of chunks and the data (and thus the checksum) does not depend on how it was read.
+     */
+    class BenchReader : public DBReader::Reader {
+    private:
+        /*! \var BenchConfig config
+         the shape of the data
+         */
+        BenchConfig config;
+
+        /*! \var uint64_t nullThreshold
+         a value is NULL if the upper 32 bits of its hash fall below this threshold
+         */
+        uint64_t nullThreshold;
+
+        /*! \var int64_t currRow
+         number of the row that has been read last plus one
+         */
+        int64_t currRow;
+
+        /*! \var int64_t endRow
+         number of the row after the last one of the current chunk
+         */
+        int64_t endRow;
+
+    public:
+        BenchReader(BenchConfig & newConfig);
+
+        ~BenchReader();
+
+        virtual void rewind();
+
+        virtual int getNextRow();
+
+        virtual bool getItemInRow(DBDataSchema::DataObjDesc * thisItem, bool applyAsserters, bool applyConverters, void* result);
+
+        virtual void getConstItem(DBDataSchema::DataObjDesc * thisItem, void* result);
+
+        virtual bool getIsSplittable();
+
+        virtual DBReader::Reader * getChunkReader();
+
+        virtual void setChunk(int chunkId, int numChunks);
+    };
+
+    /*! \brief hashes one bound value into a checksum term
+     \param int column: index of the column in the row plan
+     \param DBDataSchema::DBType thisDBType: type the value is stored as (DBT_ANY needs to be resolved by the caller)
+     \param void* value: pointer to the value, for DBT_CHAR a pointer to the string pointer
+     \param bool isNull: true if the value is NULL, the value is not looked at then
+     \param int64_t * numBytes: incremented by the size of the value
+     \return the term to add to the checksum. terms are added up, so that the order of the rows does not matter
+     */
+    uint64_t checksumValue(int column, DBDataSchema::DBType thisDBType, void* value, bool isNull, int64_t * numBytes);
+}
+
+#endif
@@ -0,0 +1,272 @@
+/*
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>,
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "DBNullSink.h"
+#include "BenchReader.h"
+#include "SchemaItem.h"
+#include "dbingestor_error.h"
+#include "DBType.h"
+#include <assert.h>
+#include <limits.h>
+#include <vector>
+
+using namespace DBBench;
+using namespace std;
+
+namespace {
+    //the prepared statement of the sink: the checksum of the rows bound so far, which is only
+    //counted once the statement is executed
+    typedef struct NullSinkStmt {
+        int numElements;
+        vector<bool> isBound;
+        uint64_t checksum;
+        int64_t numBytes;
+    } NullSinkStmt;
+}
+
+DBNullSink::DBNullSink() {
+    supportsSchemaRetrieval = false;
+    maxRows = INT_MAX;
+
+    reset();
+}
+
+DBNullSink::~DBNullSink() {
+
+}
+
+int DBNullSink::connect(string usr, string pwd, string host, string port, string socket) {
+    isConnected = true;
+
+    return 1;
+}
+
+int DBNullSink::disconnect() {
+    isConnected = false;
+
+    return 1;
+}
+
+int DBNullSink::setSavepoint() {
+    return 1;
+}
+
+int DBNullSink::rollback() {
+    return 1;
+}
+
+int DBNullSink::releaseSavepoint() {
+    return 1;
+}
+
+int DBNullSink::disableKeys(DBDataSchema::Schema * thisSchema) {
+    return 1;
+}
+
+int DBNullSink::enableKeys(DBDataSchema::Schema * thisSchema) {
+    return 1;
+}
+
+DBDataSchema::Schema * DBNullSink::getSchema(string database, string table) {
+    DBDataSchema::Schema * retSchema = new DBDataSchema::Schema;
+
+    retSchema->setDbName(database);
+    retSchema->setTableName(table);
+
+    return retSchema;
+}
+
+void* DBNullSink::prepareIngestStatement(DBDataSchema::Schema * thisSchema) {
+    return prepareMultiIngestStatement(thisSchema, 1);
+}
+
+void* DBNullSink::prepareMultiIngestStatement(DBDataSchema::Schema * thisSchema, int numElements) {
+    assert(thisSchema != NULL);
+    assert(numElements > 0);
+
+    NullSinkStmt * newStmt = new NullSinkStmt;
+    newStmt->numElements = numElements;
+    newStmt->isBound.assign(numElements, false);
+    newStmt->checksum = 0;
+    newStmt->numBytes = 0;
+
+    return newStmt;
+}
+
+int DBNullSink::insertOneRow(DBDataSchema::Schema * thisSchema, void** thisData) {
+    DBIngestor_error("DBNullSink: insertOneRow is not supported, use prepared statements.\n", NULL);
+
+    return 0;
+}
+
+int DBNullSink::insertOneRow(DBDataSchema::Schema * thisSchema, void** thisData, void* preparedStatement) {
+    DBIngestor_error("DBNullSink: insertOneRow is not supported, use prepared statements.\n", NULL);
+
+    return 0;
+}
+
+int DBNullSink::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, void* preparedStatement, int nInStmt) {
+    return bindOneRowToStmt(thisSchema, thisData, NULL, preparedStatement, nInStmt);
+}
+
+int DBNullSink::bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, bool* isNullArray, void* preparedStatement, int nInStmt) {
+    assert(thisSchema != NULL);
+    assert(thisData != NULL);
+    assert(preparedStatement != NULL);
+
+    NullSinkStmt * stmt = (NullSinkStmt*)preparedStatement;
+
+    if(nInStmt < 0 || nInStmt >= stmt->numElements) {
+        DBIngestor_error("DBNullSink: Row bound outside of the prepared statement.\n", NULL);
+    }
+
+    if(stmt->isBound[nInStmt] == true) {
+        DBIngestor_error("DBNullSink: Row bound twice to the same statement.\n", NULL);
+    }
+
+    vector<DBDataSchema::ColumnPlan> & rowPlan = thisSchema->getRowPlan();
+    char * currRow = (char*)thisData;
+
+    for(int i=0; i<rowPlan.size(); i++) {
+        DBDataSchema::ColumnPlan & currCol = rowPlan[i];
+
+        //DBT_ANY holds the value as it was read
+        DBDataSchema::DBType bindType = currCol.dbType;
+        if(bindType == DBDataSchema::DBT_ANY) {
+            bindType = DBDataSchema::convDTypeToDBType(currCol.dType);
+        }
+
+        bool isNull = (isNullArray != NULL && isNullArray[i] == 1);
+        stmt->checksum += checksumValue(i, bindType, currRow + currCol.offset, isNull, &stmt->numBytes);
+    }
+
+    stmt->isBound[nInStmt] = true;
+
+    return 1;
+}
+
+int DBNullSink::bindColumnsToStmt(DBDataSchema::Schema * thisSchema, void** columnData, bool** isNullColumns, void* preparedStatement, int numRows) {
+    assert(thisSchema != NULL);
+    assert(columnData != NULL);
+    assert(isNullColumns != NULL);
+    assert(preparedStatement != NULL);
+
+    NullSinkStmt * stmt = (NullSinkStmt*)preparedStatement;
+
+    if(numRows != stmt->numElements) {
+        DBIngestor_error("DBNullSink: Number of bound rows does not match the prepared statement.\n", NULL);
+    }
+
+    for(int j=0; j<numRows; j++) {
+        if(stmt->isBound[j] == true) {
+            DBIngestor_error("DBNullSink: Row bound twice to the same statement.\n", NULL);
+        }
+    }
+
+    vector<DBDataSchema::ColumnPlan> & rowPlan = thisSchema->getRowPlan();
+
+    for(int i=0; i<rowPlan.size(); i++) {
+        DBDataSchema::ColumnPlan & currCol = rowPlan[i];
+
+        //DBT_ANY holds the value as it was read
+        DBDataSchema::DBType bindType = currCol.dbType;
+        if(bindType == DBDataSchema::DBT_ANY) {
+            bindType = DBDataSchema::convDTypeToDBType(currCol.dType);
+        }
+
+        char * currValue = (char*)columnData[i];
+        for(int j=0; j<numRows; j++) {
+            stmt->checksum += checksumValue(i, bindType, currValue, isNullColumns[i][j], &stmt->numBytes);
+            currValue += currCol.byteLen;
+        }
+    }
+
+    stmt->isBound.assign(stmt->numElements, true);
+
+    return 1;
+}
+
+int DBNullSink::executeStmt(void* preparedStatement) {
+    assert(preparedStatement != NULL);
+
+    NullSinkStmt * stmt = (NullSinkStmt*)preparedStatement;
+
+    for(int i=0; i<stmt->numElements; i++) {
+        if(stmt->isBound[i] == false) {
+            DBIngestor_error("DBNullSink: Statement executed with rows that were not bound.\n", NULL);
+        }
+    }
+
+    checksum += stmt->checksum;
+    numBytes += stmt->numBytes;
+    numRows += stmt->numElements;
+    numStmts++;
+
+    //the statement is reused for the next rows
+    stmt->isBound.assign(stmt->numElements, false);
+    stmt->checksum = 0;
+    stmt->numBytes = 0;
+
+    return 1;
+}
+
+int DBNullSink::finalizePreparedStatement(void* preparedStatement) {
+    if(preparedStatement != NULL) {
+        delete (NullSinkStmt*)preparedStatement;
+    }
+
+    return 1;
+}
+
+int DBNullSink::maxRowsPerStmt(DBDataSchema::Schema * thisSchema) {
+    return maxRows;
+}
+
+void DBNullSink::setMaxRowsPerStmt(int newMaxRows) {
+    assert(newMaxRows > 0);
+
+    maxRows = newMaxRows;
+}
+
+void DBNullSink::setSupportsColumnBinding(bool newSupportsColumnBinding) {
+    supportsColumnBinding = newSupportsColumnBinding;
+}
+
+void DBNullSink::reset() {
+    checksum = 0;
+    numRows = 0;
+    numBytes = 0;
+    numStmts = 0;
+}
+
+uint64_t DBNullSink::getChecksum() {
+    return checksum;
+}
+
+int64_t DBNullSink::getNumRows() {
+    return numRows;
+}
+
+int64_t DBNullSink::getNumBytes() {
+    return numBytes;
+}
+
+int64_t DBNullSink::getNumStmts() {
+    return numStmts;
+}
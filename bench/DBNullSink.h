@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>,
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file DBNullSink.h
+ \brief Implementation of DBAbstractor that discards all data (for the benchmarks)
+
+ This provides an implementation of DBAbstractor that does not talk to any server. Every
+ bound value is folded into a checksum, so that a benchmark can verify that the data
+ arrived intact.
+ */
+
+#include "DBAbstractor.h"
+
+#ifndef DBIngestor_DBNullSink_h
+#define DBIngestor_DBNullSink_h
+
+namespace DBBench {
+
+    /*! \class DBNullSink
+     \brief DBNullSink class
+
+     Prepared statements only remember how many rows they hold. Binding a row adds its values to the
+     checksum (see checksumValue), executing a statement checks that all of its rows were bound. The
+     totals are kept per sink and are safe to read once the ingest is done. Use one sink per connection.
+     */
+    class DBNullSink : public DBServer::DBAbstractor {
+    private:
+        /*! \var int maxRows
+         the number of rows returned by maxRowsPerStmt
+         */
+        int maxRows;
+
+        /*! \var uint64_t checksum
+         sum of the checksum terms of all bound values
+         */
+        uint64_t checksum;
+
+        /*! \var int64_t numRows
+         number of rows in executed statements
+         */
+        int64_t numRows;
+
+        /*! \var int64_t numBytes
+         number of bytes bound (strings count with their length)
+         */
+        int64_t numBytes;
+
+        /*! \var int64_t numStmts
+         number of executed statements
+         */
+        int64_t numStmts;
+
+    public:
+        DBNullSink();
+
+        ~DBNullSink();
+
+        virtual int connect(std::string usr, std::string pwd, std::string host, std::string port, std::string socket);
+
+        virtual int disconnect();
+
+        virtual int setSavepoint();
+
+        virtual int rollback();
+
+        virtual int releaseSavepoint();
+
+        virtual int disableKeys(DBDataSchema::Schema * thisSchema);
+
+        virtual int enableKeys(DBDataSchema::Schema * thisSchema);
+
+        virtual DBDataSchema::Schema * getSchema(std::string database, std::string table);
+
+        virtual void* prepareIngestStatement(DBDataSchema::Schema * thisSchema);
+
+        virtual void* prepareMultiIngestStatement(DBDataSchema::Schema * thisSchema, int numElements);
+
+        virtual int insertOneRow(DBDataSchema::Schema * thisSchema, void** thisData);
+
+        virtual int insertOneRow(DBDataSchema::Schema * thisSchema, void** thisData, void* preparedStatement);
+
+        virtual int bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, void* preparedStatement, int nInStmt);
+
+        virtual int bindOneRowToStmt(DBDataSchema::Schema * thisSchema, void* thisData, bool* isNullArray, void* preparedStatement, int nInStmt);
+
+        virtual int bindColumnsToStmt(DBDataSchema::Schema * thisSchema, void** columnData, bool** isNullColumns, void* preparedStatement, int numRows);
+
+        virtual int executeStmt(void* preparedStatement);
+
+        virtual int finalizePreparedStatement(void* preparedStatement);
+
+        virtual int maxRowsPerStmt(DBDataSchema::Schema * thisSchema);
+
+        /*! \brief sets the number of rows per statement
+         \param int newMaxRows: rows per statement, the buffer size is used if this is larger
+         */
+        void setMaxRowsPerStmt(int newMaxRows);
+
+        /*! \brief sets whether the sink binds whole columns
+         \param bool newSupportsColumnBinding: if true, the ingest uses a column oriented buffer with this sink
+         */
+        void setSupportsColumnBinding(bool newSupportsColumnBinding);
+
+        /*! \brief resets the checksum and the counters
+         */
+        void reset();
+
+        uint64_t getChecksum();
+
+        int64_t getNumRows();
+
+        int64_t getNumBytes();
+
+        int64_t getNumStmts();
+    };
+}
+
+#endif
@@ -0,0 +1,288 @@
+/*
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>,
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file dbingest_bench.cpp
+ \brief Throughput benchmark of the ingest machinery
+
+ Ingests synthetic rows (BenchReader) into a sink that discards them (DBNullSink), so that the
+ time spent in the library itself (reading, converting, buffering, casting and binding) can be
+ measured without a database server. The data that arrives at the sink is checked against a
+ checksum computed directly from the reader.
+
+ Usage: dbingest_bench --help
+ */
+
+#include "BenchReader.h"
+#include "DBNullSink.h"
+#include "DBIngestor.h"
+#include "RowContext.h"
+#include "DBType.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <boost/program_options.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+using namespace DBBench;
+using namespace std;
+namespace po = boost::program_options;
+
+typedef struct BenchResult {
+    int bufferSize;
+    double seconds;
+    int64_t numRows;
+    int64_t numBytes;
+    int64_t numStmts;
+    int64_t maxBytesUsed;
+    int64_t meanLatency;
+    int64_t maxLatency;
+    bool checksumOk;
+} BenchResult;
+
+//reads all rows directly through the reader and the generic cast, i.e. without any of the buffering
+void computeReference(BenchConfig config, DBDataSchema::Schema * schema, uint64_t * checksum, int64_t * numBytes) {
+    //no need to wait for the data here
+    config.burstRows = 0;
+    
+    BenchReader reader(config);
+    reader.setSchema(schema);
+
+    DBDataSchema::RowContext rowContext(schema);
+    reader.setRowContext(&rowContext);
+
+    vector<DBDataSchema::ColumnPlan> & rowPlan = schema->getRowPlan();
+    char result[128];
+    char castResult[128];
+
+    *checksum = 0;
+    *numBytes = 0;
+
+    reader.rewind();
+    while(reader.getNextRow()) {
+        rowContext.nextRow();
+
+        for(int i=0; i<rowPlan.size(); i++) {
+            DBDataSchema::ColumnPlan & currCol = rowPlan[i];
+
+            DBDataSchema::DBType bindType = currCol.dbType;
+            if(bindType == DBDataSchema::DBT_ANY) {
+                bindType = DBDataSchema::convDTypeToDBType(currCol.dType);
+            }
+
+            bool isNull = reader.getItemInRow(currCol.dataDesc, 1, 1, result);
+
+            if(isNull == false) {
+                DBDataSchema::castDTypeToDBType(result, currCol.dType, bindType, castResult);
+            }
+
+            *checksum += checksumValue(i, bindType, castResult, isNull, numBytes);
+
+            if(isNull == false && bindType == DBDataSchema::DBT_CHAR) {
+                free(*(char**)castResult);
+            }
+
+            if(currCol.dType == DBDataSchema::DT_STRING && currCol.isConstItem != true) {
+                rowContext.releaseString(*(char**)result);
+            }
+        }
+    }
+
+    reader.setRowContext(NULL);
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    string typeList;
+    string bufferList;
+    int stmtRows;
+    int pipelineDepth;
+    int numParseThreads;
+    int repetitions;
+    bool ordered;
+    bool stageTiming;
+    bool columnBinding;
+    bool alignedLayout;
+    int64_t maxBufferBytes;
+    bool adaptiveStmtSize;
+    int64_t maxFlushLatency;
+    int64_t maxStmtLatency;
+
+    po::options_description desc("Options for dbingest_bench");
+    desc.add_options()
+        ("help,h", "this help message")
+        ("rows", po::value<int64_t>(&config.numRows)->default_value(1000000), "number of rows to ingest")
+        ("columns", po::value<int>(&config.numColumns)->default_value(8), "number of columns")
+        ("types", po::value<string>(&typeList)->default_value("INT4,INT8,REAL4,REAL8,CHAR"), "comma separated DTypes assigned to the columns round robin, each optionally followed by :DBTYPE (e.g. INT4:BIGINT)")
+        ("min-strlen", po::value<int>(&config.minStringLength)->default_value(8), "minimum length of the strings")
+        ("max-strlen", po::value<int>(&config.maxStringLength)->default_value(32), "maximum length of the strings")
+        ("null-ratio", po::value<double>(&config.nullRatio)->default_value(0.05), "fraction of values that are NULL")
+        ("converters", po::value<int>(&config.converterChainLength)->default_value(0), "number of converters applied to each numeric column")
+        ("const-columns", po::value<int>(&config.numConstColumns)->default_value(0), "number of columns (the last ones) holding a constant")
+        ("seed", po::value<uint64_t>(&config.seed)->default_value(42), "seed of the synthetic data")
+        ("burst-rows", po::value<int64_t>(&config.burstRows)->default_value(0), "deliver the rows in bursts of this many rows (0: all at once)")
+        ("burst-pause", po::value<int>(&config.burstPause)->default_value(0), "milliseconds between two bursts of rows")
+        ("buffers", po::value<string>(&bufferList)->default_value("1,10,100,1000,10000"), "comma separated buffer sizes (rows) to run")
+        ("stmt-rows", po::value<int>(&stmtRows)->default_value(0), "maximum number of rows per statement (0: one statement per buffer)")
+        ("pipeline-depth", po::value<int>(&pipelineDepth)->default_value(0), "number of buffers queued for the commit thread (0: commit in the parsing thread)")
+        ("parse-threads", po::value<int>(&numParseThreads)->default_value(1), "number of parsing threads")
+        ("ordered", po::value<bool>(&ordered)->default_value(true), "commit the rows in input order when parsing in parallel")
+        ("repeat", po::value<int>(&repetitions)->default_value(3), "number of runs per buffer size, the fastest one is reported")
+        ("column-binding", po::value<bool>(&columnBinding)->default_value(false), "bind whole columns, i.e. ingest through the column oriented buffer")
+        ("max-bytes", po::value<int64_t>(&maxBufferBytes)->default_value(0), "byte budget of a buffer (0: only the buffer size in rows counts)")
+        ("adaptive", po::value<bool>(&adaptiveStmtSize)->default_value(false), "tune the number of rows per statement while ingesting")
+        ("max-stmt-latency", po::value<int64_t>(&maxStmtLatency)->default_value(0), "when tuning, maximum average time of a statement in microseconds (0: no limit)")
+        ("max-latency", po::value<int64_t>(&maxFlushLatency)->default_value(0), "commit buffers whose rows waited this many milliseconds (0: only when full)")
+        ("aligned", po::value<bool>(&alignedLayout)->default_value(true), "lay out the buffer rows aligned (otherwise packed)")
+        ("stage-timing", po::value<bool>(&stageTiming)->default_value(false), "print the time spent in each stage after every run")
+    ;
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    } catch (exception & e) {
+        cout << e.what() << endl << desc << endl;
+        return EXIT_FAILURE;
+    }
+
+    if(vm.count("help")) {
+        cout << desc << endl;
+        return EXIT_SUCCESS;
+    }
+
+    if(config.numRows < 0 || config.numColumns <= 0 || config.minStringLength < 0 || config.maxStringLength < config.minStringLength ||
+       config.nullRatio < 0.0 || config.nullRatio > 1.0 || config.converterChainLength < 0 ||
+       config.numConstColumns < 0 || config.numConstColumns > config.numColumns || stmtRows < 0 || maxBufferBytes < 0 || maxStmtLatency < 0 || maxFlushLatency < 0 || config.burstRows < 0 || config.burstPause < 0 || pipelineDepth < 0 ||
+       numParseThreads <= 0 || repetitions <= 0) {
+        cout << "Invalid arguments" << endl << desc << endl;
+        return EXIT_FAILURE;
+    }
+
+    parseTypeMix(typeList, config);
+
+    vector<string> bufferStrings;
+    vector<int> bufferSizes;
+    boost::split(bufferStrings, bufferList, boost::is_any_of(","));
+    for(int i=0; i<bufferStrings.size(); i++) {
+        int bufferSize = boost::lexical_cast<int>(boost::trim_copy(bufferStrings.at(i)));
+        if(bufferSize <= 0) {
+            cout << "Invalid buffer size: " << bufferSize << endl;
+            return EXIT_FAILURE;
+        }
+        bufferSizes.push_back(bufferSize);
+    }
+
+    vector<DBDataSchema::DataObjDesc*> paramObjs;
+    DBDataSchema::Schema * schema = buildBenchSchema(config, paramObjs);
+    schema->setRowLayout(alignedLayout ? DBDataSchema::ROW_LAYOUT_ALIGNED : DBDataSchema::ROW_LAYOUT_PACKED);
+    schema->compile();
+
+    uint64_t refChecksum;
+    int64_t refBytes;
+    computeReference(config, schema, &refChecksum, &refBytes);
+
+    BenchReader * reader = new BenchReader(config);
+    DBNullSink * sink = new DBNullSink();
+    if(stmtRows > 0) {
+        sink->setMaxRowsPerStmt(stmtRows);
+    }
+    sink->setSupportsColumnBinding(columnBinding);
+
+    vector<BenchResult> results;
+
+    for(int b=0; b<bufferSizes.size(); b++) {
+        BenchResult best;
+        best.seconds = -1.0;
+
+        for(int r=0; r<repetitions; r++) {
+            sink->reset();
+
+            DBIngest::DBIngestor ingestor(schema, reader, sink);
+            ingestor.setAskUserToValidateRead(0);
+            ingestor.setPerformanceMeter(-1);
+            ingestor.setPipelineDepth(pipelineDepth);
+            ingestor.setNumParseThreads(numParseThreads);
+            ingestor.setOrderedCommit(ordered);
+            ingestor.setStageTiming(stageTiming);
+            ingestor.setMaxBufferBytes(maxBufferBytes);
+            ingestor.setAdaptiveStmtSize(adaptiveStmtSize);
+            ingestor.setMaxStmtLatency(maxStmtLatency * 1000);
+            ingestor.setMaxFlushLatency(maxFlushLatency);
+
+            boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+            ingestor.ingestData(bufferSizes.at(b));
+            double seconds = (double)(boost::posix_time::microsec_clock::universal_time() - start).total_microseconds() / 1.0e6;
+
+            BenchResult currResult;
+            currResult.bufferSize = bufferSizes.at(b);
+            currResult.seconds = seconds;
+            currResult.numRows = sink->getNumRows();
+            currResult.numBytes = sink->getNumBytes();
+            currResult.numStmts = sink->getNumStmts();
+            currResult.maxBytesUsed = ingestor.getMaxBufferBytesUsed();
+            currResult.meanLatency = ingestor.getMeanRowLatency();
+            currResult.maxLatency = ingestor.getMaxRowLatency();
+            currResult.checksumOk = (sink->getChecksum() == refChecksum && sink->getNumRows() == config.numRows && sink->getNumBytes() == refBytes);
+
+            if(currResult.checksumOk == false) {
+                printf("\nChecksum mismatch with buffer size %i: %lld rows, %lld bytes, checksum %016llx (expected %lld rows, %lld bytes, checksum %016llx)\n",
+                       currResult.bufferSize, (long long)currResult.numRows, (long long)currResult.numBytes, (unsigned long long)sink->getChecksum(),
+                       (long long)config.numRows, (long long)refBytes, (unsigned long long)refChecksum);
+                return EXIT_FAILURE;
+            }
+
+            if(best.seconds < 0.0 || seconds < best.seconds) {
+                best = currResult;
+            }
+        }
+
+        results.push_back(best);
+    }
+
+    printf("\n%lld rows, %i columns (%s, %i constant), strings %i-%i chars, %.1f%% NULL, %i converters per numeric column\n",
+           (long long)config.numRows, config.numColumns, typeList.c_str(), config.numConstColumns, config.minStringLength,
+           config.maxStringLength, config.nullRatio * 100.0, config.converterChainLength);
+    printf("pipeline depth %i, %i parsing thread(s), %s binding, %s rows of %lld bytes, best of %i run(s), checksum %016llx\n\n", pipelineDepth,
+           numParseThreads, columnBinding ? "column" : "row", alignedLayout ? "aligned" : "packed", (long long)schema->getRowSizeInBytes(),
+           repetitions, (unsigned long long)refChecksum);
+    printf("%10s %10s %12s %14s %10s %12s %12s %12s  %s\n", "buffer", "stmts", "seconds", "rows/s", "MB/s", "peak bytes", "mean lat ms",
+           "max lat ms", "checksum");
+
+    for(int i=0; i<results.size(); i++) {
+        BenchResult & currResult = results.at(i);
+        printf("%10i %10lld %12.4f %14.0f %10.1f %12lld %12.3f %12.3f  %s\n", currResult.bufferSize, (long long)currResult.numStmts,
+               currResult.seconds, (double)currResult.numRows / currResult.seconds, (double)currResult.numBytes / currResult.seconds / 1.0e6,
+               (long long)currResult.maxBytesUsed, (double)currResult.meanLatency / 1.0e6, (double)currResult.maxLatency / 1.0e6,
+               currResult.checksumOk ? "ok" : "MISMATCH");
+    }
+
+    delete reader;
+    delete sink;
+    delete schema;
+
+    for(int i=0; i<paramObjs.size(); i++) {
+        delete paramObjs.at(i);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,248 @@
+/*  
+ *  Copyright (c) 2012 - 2014, Adrian M. Partl <apartl@aip.de>, 
+ *                      eScience team AIP Potsdam
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership. You may obtain a copy
+ *  of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file parse_bench.cpp
+ \brief Microbenchmark of the number parsing in castStringToDType
+ 
+ Compares the strtol/strtod based parsing that castStringToDType used before (copied here as the
+ legacy path) with the std::string and the pointer+length versions of castStringToDType.
+ 
+ Usage: dbingest_parse_bench [number of values] [repetitions]
+ */
+
+#include "DType.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+using namespace DBDataSchema;
+using namespace std;
+
+//the parsing as it was done before, including the NULL check
+int legacyConvToInt8(std::string & thisString, void* result) {
+    *(int64_t*)result = strtoll(thisString.c_str(), NULL, 10);
+
+    if(*(int64_t*)result == 0) {
+        if(thisString.find_first_not_of("0123456789.xXeE+- ") != string::npos) {
+            return 1; 
+        }
+    }
+    
+    return 0;
+}
+
+int legacyConvToReal4(std::string & thisString, void* result) {
+    *(float*)result = strtof(thisString.c_str(), NULL);
+
+    if(*(float*)result == 0.0 || isnan(*(float*)result) || isinf(*(float*)result)) {
+        if(thisString.find_first_not_of("0123456789.xXeE+- ") != string::npos) {
+            return 1; 
+        }
+    }
+    
+    return 0;
+}
+
+int legacyConvToReal8(std::string & thisString, void* result) {
+    *(double*)result = strtod(thisString.c_str(), NULL);
+
+    if(*(double*)result == 0.0 || isnan(*(double*)result) || isinf(*(double*)result)) {
+        if(thisString.find_first_not_of("0123456789.xXeE+- ") != string::npos) {
+            return 1; 
+        }
+    }
+    
+    return 0;
+}
+
+//the values are stored one after the other, as they would be in a line of an ascii file
+struct TextColumn {
+    std::string name;
+    DType type;
+    std::string text;
+    std::vector<size_t> offsets;
+    std::vector<size_t> lengths;
+};
+
+void addValue(TextColumn & column, const char * value) {
+    column.offsets.push_back(column.text.size());
+    column.lengths.push_back(strlen(value));
+    column.text.append(value);
+    column.text.append(" ");
+}
+
+void generateColumns(std::vector<TextColumn> & columns, int numValues) {
+    char value[64];
+    
+    TextColumn ints;
+    ints.name = "INT8 ids";
+    ints.type = DT_INT8;
+    
+    TextColumn fixed;
+    fixed.name = "REAL8 fixed point";
+    fixed.type = DT_REAL8;
+    
+    TextColumn scientific;
+    scientific.name = "REAL8 scientific";
+    scientific.type = DT_REAL8;
+    
+    TextColumn floats;
+    floats.name = "REAL4 fixed point";
+    floats.type = DT_REAL4;
+    
+    srand(42);
+    for(int i=0; i<numValues; i++) {
+        double random = (double)rand() / (double)RAND_MAX;
+        
+        sprintf(value, "%lld", (long long)(random * 1e15));
+        addValue(ints, value);
+        
+        sprintf(value, "%.6f", (random - 0.5) * 360.0);
+        addValue(fixed, value);
+        
+        sprintf(value, "%.10e", random * pow(10.0, (double)(rand() % 60 - 30)));
+        addValue(scientific, value);
+        
+        sprintf(value, "%.4f", random * 30.0);
+        addValue(floats, value);
+    }
+    
+    columns.push_back(ints);
+    columns.push_back(fixed);
+    columns.push_back(scientific);
+    columns.push_back(floats);
+}
+
+double secondsSince(boost::posix_time::ptime start) {
+    return (double)(boost::posix_time::microsec_clock::universal_time() - start).total_microseconds() / 1.0e6;
+}
+
+void report(const char * method, TextColumn & column, int repetitions, double seconds, double checksum) {
+    double numValues = (double)column.offsets.size() * repetitions;
+    double numBytes = (double)column.text.size() * repetitions;
+    
+    printf("%-20s %-20s %8.2f ns/value %8.1f MB/s   (checksum %g)\n", column.name.c_str(), method, 
+           seconds * 1.0e9 / numValues, numBytes / seconds / 1.0e6, checksum);
+}
+
+int main(int argc, char** argv) {
+    int numValues = 1000000;
+    int repetitions = 5;
+    
+    if(argc > 1) {
+        numValues = atoi(argv[1]);
+    }
+    
+    if(argc > 2) {
+        repetitions = atoi(argv[2]);
+    }
+    
+    if(numValues <= 0 || repetitions <= 0) {
+        printf("Usage: %s [number of values] [repetitions]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    
+    std::vector<TextColumn> columns;
+    generateColumns(columns, numValues);
+    
+    for(int c=0; c<columns.size(); c++) {
+        TextColumn & column = columns.at(c);
+        char result[16];
+        double checksum;
+        boost::posix_time::ptime start;
+        
+        //legacy: a std::string per value (as the readers create them), strtol/strtod and the NULL check
+        checksum = 0.0;
+        start = boost::posix_time::microsec_clock::universal_time();
+        for(int r=0; r<repetitions; r++) {
+            for(size_t i=0; i<column.offsets.size(); i++) {
+                std::string value(column.text, column.offsets[i], column.lengths[i]);
+                
+                switch (column.type) {
+                    case DT_INT8:
+                        legacyConvToInt8(value, result);
+                        checksum += (double)*(int64_t*)result;
+                        break;
+                    case DT_REAL4:
+                        legacyConvToReal4(value, result);
+                        checksum += *(float*)result;
+                        break;
+                    default:
+                        legacyConvToReal8(value, result);
+                        checksum += *(double*)result;
+                        break;
+                }
+            }
+        }
+        report("legacy strto*", column, repetitions, secondsSince(start), checksum);
+        
+        //castStringToDType taking a std::string, still paying for the string
+        checksum = 0.0;
+        start = boost::posix_time::microsec_clock::universal_time();
+        for(int r=0; r<repetitions; r++) {
+            for(size_t i=0; i<column.offsets.size(); i++) {
+                std::string value(column.text, column.offsets[i], column.lengths[i]);
+                castStringToDType(value, column.type, result);
+                
+                switch (column.type) {
+                    case DT_INT8:
+                        checksum += (double)*(int64_t*)result;
+                        break;
+                    case DT_REAL4:
+                        checksum += *(float*)result;
+                        break;
+                    default:
+                        checksum += *(double*)result;
+                        break;
+                }
+            }
+        }
+        report("std::string", column, repetitions, secondsSince(start), checksum);
+        
+        //castStringToDType on pointer and length, directly on the line
+        checksum = 0.0;
+        start = boost::posix_time::microsec_clock::universal_time();
+        for(int r=0; r<repetitions; r++) {
+            for(size_t i=0; i<column.offsets.size(); i++) {
+                castStringToDType(column.text.data() + column.offsets[i], column.lengths[i], column.type, result);
+                
+                switch (column.type) {
+                    case DT_INT8:
+                        checksum += (double)*(int64_t*)result;
+                        break;
+                    case DT_REAL4:
+                        checksum += *(float*)result;
+                        break;
+                    default:
+                        checksum += *(double*)result;
+                        break;
+                }
+            }
+        }
+        report("pointer+length", column, repetitions, secondsSince(start), checksum);
+        
+        printf("\n");
+    }
+    
+    return EXIT_SUCCESS;
+}